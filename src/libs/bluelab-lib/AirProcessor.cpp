@@ -18,6 +18,7 @@
 
 #include "Defines.h"
 #include "Utils.h"
+#include "BufferKernels.h"
 #include "PartialTracker.h"
 #include "WienerSoftMasking.h"
 #include "AirProcessor.h"
@@ -114,30 +115,11 @@ AirProcessor::processFFT(vector<complex<float> > *ioBuffer)
             // Do not use directly denormed data
             
             // harmo is 0, noise is 1
-            vector<complex<float> > &maskedResult0 = _tmpBuf20;
-            vector<complex<float> > &maskedResult1 = _tmpBuf21;
-
-            // Harmo
-            maskedResult0 = *ioBuffer;
-            Utils::multBuffers(&maskedResult0, mask);
-            Utils::multValue(&maskedResult0, harmoCoeff);
-            
-            // Noise
-            vector<float> &maskOpposite = _tmpBuf22;
-            maskOpposite = mask;
-            Utils::computeOpposite(&maskOpposite);
-            
-            maskedResult1 = *ioBuffer;
-            Utils::multBuffers(&maskedResult1, maskOpposite);
-            Utils::multValue(&maskedResult1, noiseCoeff);
- 
-            for (int i = 0; i < ioBuffer->size(); i++)
-            {
-                const complex<float> &h = maskedResult0.data()[i];
-                const complex<float> &n = maskedResult1.data()[i];
-
-                ioBuffer->data()[i] = h + n;
-            }
+            // Harmo: input*mask*harmoCoeff
+            // Noise: input*(1 - mask)*noiseCoeff
+            // Sum both in the same pass
+            BufferKernels::mixMasks(ioBuffer->data(), ioBuffer->data(), mask.data(),
+                                    harmoCoeff, noiseCoeff, ioBuffer->size());
 
             if (_enableComputeSum)
             {
@@ -157,12 +139,12 @@ AirProcessor::processFFT(vector<complex<float> > *ioBuffer)
                 // Apply "mix"
                 
                 // 0 is harmo mask
-                Utils::multValue(&softMaskedResult0, harmoCoeff);
-                Utils::multValue(&softMaskedResult1, noiseCoeff);
-                
                 // Sum
-                *ioBuffer = softMaskedResult0;
-                Utils::addBuffers(ioBuffer, softMaskedResult1);
+                ioBuffer->resize(softMaskedResult0.size());
+                BufferKernels::mix(ioBuffer->data(),
+                                   softMaskedResult0.data(), harmoCoeff,
+                                   softMaskedResult1.data(), noiseCoeff,
+                                   softMaskedResult0.size());
             }
 
             if (_enableComputeSum)
@@ -192,6 +174,13 @@ AirProcessor::setUseSoftMasks(bool flag)
     _useSoftMasks = flag;
 }
 
+void
+AirProcessor::setSoftMaskingLookahead(int lookahead)
+{
+    if (_softMasking != NULL)
+        _softMasking->setLookahead(lookahead);
+}
+
 int
 AirProcessor::getLatency()
 {
@@ -42,6 +42,9 @@ public:
 
     void setUseSoftMasks(bool flag);
 
+    // See WienerSoftMasking::setLookahead()
+    void setSoftMaskingLookahead(int lookahead);
+
     void setEnableSum(bool flag);
     
     int getLatency();
@@ -97,9 +100,6 @@ private:
     vector<float> _tmpBuf17;
     vector<complex<float> > _tmpBuf18;
     vector<complex<float> > _tmpBuf19;
-    vector<complex<float> > _tmpBuf20;
-    vector<complex<float> > _tmpBuf21;
-    vector<float> _tmpBuf22;
 };
 
 #endif
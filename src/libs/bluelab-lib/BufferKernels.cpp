@@ -0,0 +1,1217 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <math.h>
+#include <float.h>
+#include <string.h>
+
+#include "CpuFeatures.h"
+#include "BufferKernels.h"
+
+#if BL_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#if BL_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+// Same as in Utils
+#define AMP_DB 8.685889638065036553
+#define IAMP_DB 0.11512925464970
+
+// exp(x) = 2^n*exp(r), r in [-ln2/2, ln2/2] (cephes)
+// (the bounds keep 2^n in the normal range)
+#define EXP_MIN -87.33654f
+#define EXP_MAX 88.0f
+#define LOG2_E 1.44269504088896341f
+#define LN2_1 0.693359375f
+#define LN2_2 -2.12194440e-4f
+
+#define EXP_C0 1.9875691500e-4f
+#define EXP_C1 1.3981999507e-3f
+#define EXP_C2 8.3334519073e-3f
+#define EXP_C3 4.1665795894e-2f
+#define EXP_C4 1.6666665459e-1f
+#define EXP_C5 5.0000001201e-1f
+
+// log(x) = n*ln2 + log(m), m in [sqrt(2)/2, sqrt(2)] (cephes)
+#define SQRT_HALF 0.707106781186547524f
+
+#define LOG_C0 7.0376836292e-2f
+#define LOG_C1 -1.1514610310e-1f
+#define LOG_C2 1.1676998740e-1f
+#define LOG_C3 -1.2420140846e-1f
+#define LOG_C4 1.4249322787e-1f
+#define LOG_C5 -1.6668057665e-1f
+#define LOG_C6 2.0000714765e-1f
+#define LOG_C7 -2.4999993993e-1f
+#define LOG_C8 3.3333331174e-1f
+
+// Primitives, overloaded on the vector type of each instruction set,
+// so that the kernels below are written only once
+
+// Scalar
+typedef float VecScalar;
+
+static inline void vLoad(float *v, const float *p) { *v = *p; }
+static inline void vStore(float *p, float v) { *p = v; }
+static inline void vSet(float *v, float x) { *v = x; }
+static inline float vAdd(float a, float b) { return a + b; }
+static inline float vSub(float a, float b) { return a - b; }
+static inline float vMul(float a, float b) { return a*b; }
+// Same results as the SIMD min and max, also for NaNs in b
+static inline float vMin(float a, float b) { return (a < b) ? a : b; }
+static inline float vMax(float a, float b) { return (a > b) ? a : b; }
+static inline float vDiv(float a, float b) { return a/b; }
+// x if a > b, 0 otherwise
+static inline float vSelectGreater(float a, float b, float x) { return (a > b) ? x : 0.0f; }
+
+static inline void
+vLoadComplex(float *re, float *im, const complex<float> *p)
+{
+    *re = p->real();
+    *im = p->imag();
+}
+
+static inline void
+vStoreComplex(complex<float> *p, float re, float im)
+{
+    *p = complex<float>(re, im);
+}
+
+#if BL_SIMD_X86
+
+// SSE2, 4 floats or 4 bins
+typedef __m128 VecSSE2;
+
+static inline void vLoad(__m128 *v, const float *p) { *v = _mm_loadu_ps(p); }
+static inline void vStore(float *p, __m128 v) { _mm_storeu_ps(p, v); }
+static inline void vSet(__m128 *v, float x) { *v = _mm_set1_ps(x); }
+static inline __m128 vAdd(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+static inline __m128 vSub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+static inline __m128 vMul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+static inline __m128 vMin(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+static inline __m128 vMax(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+static inline __m128 vDiv(__m128 a, __m128 b) { return _mm_div_ps(a, b); }
+static inline __m128 vSelectGreater(__m128 a, __m128 b, __m128 x) { return _mm_and_ps(_mm_cmpgt_ps(a, b), x); }
+
+static inline void
+vLoadComplex(__m128 *re, __m128 *im, const complex<float> *p)
+{
+    __m128 c0 = _mm_loadu_ps((const float *)p);
+    __m128 c1 = _mm_loadu_ps((const float *)p + 4);
+    *re = _mm_shuffle_ps(c0, c1, _MM_SHUFFLE(2, 0, 2, 0));
+    *im = _mm_shuffle_ps(c0, c1, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+static inline void
+vStoreComplex(complex<float> *p, __m128 re, __m128 im)
+{
+    _mm_storeu_ps((float *)p, _mm_unpacklo_ps(re, im));
+    _mm_storeu_ps((float *)p + 4, _mm_unpackhi_ps(re, im));
+}
+
+// AVX2, 8 floats or 8 bins
+// Without fma, otherwise the compiler can fuse the multiplies and adds
+// (and the results would be different from the scalar code)
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2_NO_FMA __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2_NO_FMA
+#endif
+
+typedef __m256 VecAVX2;
+
+static inline TARGET_AVX2_NO_FMA void vLoad(__m256 *v, const float *p) { *v = _mm256_loadu_ps(p); }
+static inline TARGET_AVX2_NO_FMA void vStore(float *p, __m256 v) { _mm256_storeu_ps(p, v); }
+static inline TARGET_AVX2_NO_FMA void vSet(__m256 *v, float x) { *v = _mm256_set1_ps(x); }
+static inline TARGET_AVX2_NO_FMA __m256 vAdd(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+static inline TARGET_AVX2_NO_FMA __m256 vSub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+static inline TARGET_AVX2_NO_FMA __m256 vMul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+static inline TARGET_AVX2_NO_FMA __m256 vMin(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+static inline TARGET_AVX2_NO_FMA __m256 vMax(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+static inline TARGET_AVX2_NO_FMA __m256 vDiv(__m256 a, __m256 b) { return _mm256_div_ps(a, b); }
+static inline TARGET_AVX2_NO_FMA __m256 vSelectGreater(__m256 a, __m256 b, __m256 x) { return _mm256_and_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ), x); }
+
+static inline TARGET_AVX2_NO_FMA void
+vLoadComplex(__m256 *re, __m256 *im, const complex<float> *p)
+{
+    __m256 c0 = _mm256_loadu_ps((const float *)p);
+    __m256 c1 = _mm256_loadu_ps((const float *)p + 8);
+
+    // Bins 0 1 4 5 2 3 6 7, then reorder the 64 bits blocks
+    __m256 r = _mm256_shuffle_ps(c0, c1, _MM_SHUFFLE(2, 0, 2, 0));
+    __m256 i = _mm256_shuffle_ps(c0, c1, _MM_SHUFFLE(3, 1, 3, 1));
+    *re = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0)));
+    *im = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(i), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+static inline TARGET_AVX2_NO_FMA void
+vStoreComplex(complex<float> *p, __m256 re, __m256 im)
+{
+    re = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(re), _MM_SHUFFLE(3, 1, 2, 0)));
+    im = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(im), _MM_SHUFFLE(3, 1, 2, 0)));
+
+    _mm256_storeu_ps((float *)p, _mm256_unpacklo_ps(re, im));
+    _mm256_storeu_ps((float *)p + 8, _mm256_unpackhi_ps(re, im));
+}
+
+#endif
+
+#if BL_SIMD_NEON
+
+// NEON, 4 floats or 4 bins
+typedef float32x4_t VecNEON;
+
+static inline void vLoad(float32x4_t *v, const float *p) { *v = vld1q_f32(p); }
+static inline void vStore(float *p, float32x4_t v) { vst1q_f32(p, v); }
+static inline void vSet(float32x4_t *v, float x) { *v = vdupq_n_f32(x); }
+static inline float32x4_t vAdd(float32x4_t a, float32x4_t b) { return vaddq_f32(a, b); }
+static inline float32x4_t vSub(float32x4_t a, float32x4_t b) { return vsubq_f32(a, b); }
+static inline float32x4_t vMul(float32x4_t a, float32x4_t b) { return vmulq_f32(a, b); }
+static inline float32x4_t vMin(float32x4_t a, float32x4_t b) { return vminq_f32(a, b); }
+static inline float32x4_t vMax(float32x4_t a, float32x4_t b) { return vmaxq_f32(a, b); }
+static inline float32x4_t vDiv(float32x4_t a, float32x4_t b) { return vdivq_f32(a, b); }
+static inline float32x4_t vSelectGreater(float32x4_t a, float32x4_t b, float32x4_t x) { return vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(a, b), vreinterpretq_u32_f32(x))); }
+
+static inline void
+vLoadComplex(float32x4_t *re, float32x4_t *im, const complex<float> *p)
+{
+    float32x4x2_t c = vld2q_f32((const float *)p);
+    *re = c.val[0];
+    *im = c.val[1];
+}
+
+static inline void
+vStoreComplex(complex<float> *p, float32x4_t re, float32x4_t im)
+{
+    float32x4x2_t c;
+    c.val[0] = re;
+    c.val[1] = im;
+    vst2q_f32((float *)p, c);
+}
+
+#endif
+
+// Kernels, for one instruction set
+// The last elements are processed by the scalar version (same results)
+#define DEFINE_KERNELS(__ISA__, __TARGET__, __WIDTH__)                  \
+                                                                        \
+static __TARGET__ void                                                  \
+add##__ISA__(float *ioBuf, const float *buf, int size)                  \
+{                                                                       \
+    Vec##__ISA__ a, b;                                                  \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoad(&a, &ioBuf[i]);                                           \
+        vLoad(&b, &buf[i]);                                             \
+        vStore(&ioBuf[i], vAdd(a, b));                                  \
+    }                                                                   \
+    if (i < size)                                                       \
+        addScalar(&ioBuf[i], &buf[i], size - i);                        \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+add##__ISA__(float *result, const float *buf0, const float *buf1, int size) \
+{                                                                       \
+    Vec##__ISA__ a, b;                                                  \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoad(&a, &buf0[i]);                                            \
+        vLoad(&b, &buf1[i]);                                            \
+        vStore(&result[i], vAdd(a, b));                                 \
+    }                                                                   \
+    if (i < size)                                                       \
+        addScalar(&result[i], &buf0[i], &buf1[i], size - i);            \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+substract##__ISA__(float *ioBuf, const float *buf, int size)            \
+{                                                                       \
+    Vec##__ISA__ a, b;                                                  \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoad(&a, &ioBuf[i]);                                           \
+        vLoad(&b, &buf[i]);                                             \
+        vStore(&ioBuf[i], vSub(a, b));                                  \
+    }                                                                   \
+    if (i < size)                                                       \
+        substractScalar(&ioBuf[i], &buf[i], size - i);                  \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+mult##__ISA__(float *ioBuf, const float *buf, int size)                 \
+{                                                                       \
+    Vec##__ISA__ a, b;                                                  \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoad(&a, &ioBuf[i]);                                           \
+        vLoad(&b, &buf[i]);                                             \
+        vStore(&ioBuf[i], vMul(a, b));                                  \
+    }                                                                   \
+    if (i < size)                                                       \
+        multScalar(&ioBuf[i], &buf[i], size - i);                       \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+multValue##__ISA__(float *ioBuf, float value, int size)                 \
+{                                                                       \
+    Vec##__ISA__ a, v;                                                  \
+    vSet(&v, value);                                                    \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoad(&a, &ioBuf[i]);                                           \
+        vStore(&ioBuf[i], vMul(a, v));                                  \
+    }                                                                   \
+    if (i < size)                                                       \
+        multValueScalar(&ioBuf[i], value, size - i);                    \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+addMultValue##__ISA__(float *ioBuf, const float *buf, float value, int size) \
+{                                                                       \
+    Vec##__ISA__ a, b, v;                                               \
+    vSet(&v, value);                                                    \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoad(&a, &ioBuf[i]);                                           \
+        vLoad(&b, &buf[i]);                                             \
+        vStore(&ioBuf[i], vAdd(a, vMul(b, v)));                         \
+    }                                                                   \
+    if (i < size)                                                       \
+        addMultValueScalar(&ioBuf[i], &buf[i], value, size - i);        \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+mix##__ISA__(float *result,                                             \
+             const float *buf0, float value0,                           \
+             const float *buf1, float value1, int size)                 \
+{                                                                       \
+    Vec##__ISA__ a, b, v0, v1;                                          \
+    vSet(&v0, value0);                                                  \
+    vSet(&v1, value1);                                                  \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoad(&a, &buf0[i]);                                            \
+        vLoad(&b, &buf1[i]);                                            \
+        vStore(&result[i], vAdd(vMul(a, v0), vMul(b, v1)));             \
+    }                                                                   \
+    if (i < size)                                                       \
+        mixScalar(&result[i], &buf0[i], value0, &buf1[i], value1, size - i); \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+computeNormOpposite##__ISA__(float *ioBuf, int size)                    \
+{                                                                       \
+    Vec##__ISA__ a, one;                                                \
+    vSet(&one, 1.0f);                                                   \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoad(&a, &ioBuf[i]);                                           \
+        vStore(&ioBuf[i], vSub(one, a));                                \
+    }                                                                   \
+    if (i < size)                                                       \
+        computeNormOppositeScalar(&ioBuf[i], size - i);                 \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+clipMin##__ISA__(float *ioBuf, float minValue, int size)                \
+{                                                                       \
+    Vec##__ISA__ a, m;                                                  \
+    vSet(&m, minValue);                                                 \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoad(&a, &ioBuf[i]);                                           \
+        vStore(&ioBuf[i], vMax(m, a));                                  \
+    }                                                                   \
+    if (i < size)                                                       \
+        clipMinScalar(&ioBuf[i], minValue, size - i);                   \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+clipMax##__ISA__(float *ioBuf, float maxValue, int size)                \
+{                                                                       \
+    Vec##__ISA__ a, m;                                                  \
+    vSet(&m, maxValue);                                                 \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoad(&a, &ioBuf[i]);                                           \
+        vStore(&ioBuf[i], vMin(m, a));                                  \
+    }                                                                   \
+    if (i < size)                                                       \
+        clipMaxScalar(&ioBuf[i], maxValue, size - i);                   \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+mult##__ISA__(complex<float> *ioBuf, const float *buf, int size)        \
+{                                                                       \
+    Vec##__ISA__ re, im, m;                                             \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoadComplex(&re, &im, &ioBuf[i]);                              \
+        vLoad(&m, &buf[i]);                                             \
+        vStoreComplex(&ioBuf[i], vMul(re, m), vMul(im, m));             \
+    }                                                                   \
+    if (i < size)                                                       \
+        multScalar(&ioBuf[i], &buf[i], size - i);                       \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+mult##__ISA__(complex<float> *ioBuf, const complex<float> *buf, int size) \
+{                                                                       \
+    Vec##__ISA__ re0, im0, re1, im1;                                    \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoadComplex(&re0, &im0, &ioBuf[i]);                            \
+        vLoadComplex(&re1, &im1, &buf[i]);                              \
+        vStoreComplex(&ioBuf[i],                                        \
+                      vSub(vMul(re0, re1), vMul(im0, im1)),             \
+                      vAdd(vMul(re0, im1), vMul(im0, re1)));            \
+    }                                                                   \
+    if (i < size)                                                       \
+        multScalar(&ioBuf[i], &buf[i], size - i);                       \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+computeSquareConjugate##__ISA__(complex<float> *ioBuf, int size)        \
+{                                                                       \
+    Vec##__ISA__ re, im, zero;                                          \
+    vSet(&zero, 0.0f);                                                  \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoadComplex(&re, &im, &ioBuf[i]);                              \
+        vStoreComplex(&ioBuf[i], vAdd(vMul(re, re), vMul(im, im)), zero); \
+    }                                                                   \
+    if (i < size)                                                       \
+        computeSquareConjugateScalar(&ioBuf[i], size - i);              \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+multMaskValue##__ISA__(complex<float> *result, const complex<float> *buf, \
+                       const float *mask, float value, int size)        \
+{                                                                       \
+    Vec##__ISA__ re, im, m, v;                                          \
+    vSet(&v, value);                                                    \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoadComplex(&re, &im, &buf[i]);                                \
+        vLoad(&m, &mask[i]);                                            \
+        vStoreComplex(&result[i],                                       \
+                      vMul(vMul(re, m), v), vMul(vMul(im, m), v));      \
+    }                                                                   \
+    if (i < size)                                                       \
+        multMaskValueScalar(&result[i], &buf[i], &mask[i], value, size - i); \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+mixMasks##__ISA__(complex<float> *result, const complex<float> *buf,    \
+                  const float *mask, float value0, float value1, int size) \
+{                                                                       \
+    Vec##__ISA__ re, im, m0, m1, v0, v1, one;                           \
+    vSet(&v0, value0);                                                  \
+    vSet(&v1, value1);                                                  \
+    vSet(&one, 1.0f);                                                   \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoadComplex(&re, &im, &buf[i]);                                \
+        vLoad(&m0, &mask[i]);                                           \
+        m1 = vSub(one, m0);                                             \
+        vStoreComplex(&result[i],                                       \
+                      vAdd(vMul(vMul(re, m0), v0), vMul(vMul(re, m1), v1)), \
+                      vAdd(vMul(vMul(im, m0), v0), vMul(vMul(im, m1), v1))); \
+    }                                                                   \
+    if (i < size)                                                       \
+        mixMasksScalar(&result[i], &buf[i], &mask[i], value0, value1, size - i); \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+applyMask##__ISA__(complex<float> *result0, complex<float> *result1,    \
+                   const complex<float> *buf, const complex<float> *mask, \
+                   int size)                                            \
+{                                                                       \
+    Vec##__ISA__ re, im, mRe, mIm, re0, im0;                            \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoadComplex(&re, &im, &buf[i]);                                \
+        vLoadComplex(&mRe, &mIm, &mask[i]);                             \
+        re0 = vSub(vMul(re, mRe), vMul(im, mIm));                       \
+        im0 = vAdd(vMul(re, mIm), vMul(im, mRe));                       \
+        vStoreComplex(&result0[i], re0, im0);                           \
+        vStoreComplex(&result1[i], vSub(re, re0), vSub(im, im0));       \
+    }                                                                   \
+    if (i < size)                                                       \
+        applyMaskScalar(&result0[i], &result1[i], &buf[i], &mask[i], size - i); \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+computeMaskedSquares##__ISA__(complex<float> *square0, complex<float> *square1, \
+                              const complex<float> *buf, const float *mask, \
+                              int size)                                 \
+{                                                                       \
+    Vec##__ISA__ re, im, m, re0, im0, re1, im1, zero;                   \
+    vSet(&zero, 0.0f);                                                  \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoadComplex(&re, &im, &buf[i]);                                \
+        vLoad(&m, &mask[i]);                                            \
+        re0 = vMul(re, m);                                              \
+        im0 = vMul(im, m);                                              \
+        re1 = vSub(re, re0);                                            \
+        im1 = vSub(im, im0);                                            \
+        vStoreComplex(&square0[i], vAdd(vMul(re0, re0), vMul(im0, im0)), zero); \
+        vStoreComplex(&square1[i], vAdd(vMul(re1, re1), vMul(im1, im1)), zero); \
+    }                                                                   \
+    if (i < size)                                                       \
+        computeMaskedSquaresScalar(&square0[i], &square1[i],            \
+                                   &buf[i], &mask[i], size - i);        \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+applyMask##__ISA__(complex<float> *result0, complex<float> *result1,    \
+                   const complex<float> *buf, const float *mask, int size) \
+{                                                                       \
+    Vec##__ISA__ re, im, m, re0, im0;                                   \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoadComplex(&re, &im, &buf[i]);                                \
+        vLoad(&m, &mask[i]);                                            \
+        re0 = vMul(re, m);                                              \
+        im0 = vMul(im, m);                                              \
+        vStoreComplex(&result0[i], re0, im0);                           \
+        vStoreComplex(&result1[i], vSub(re, re0), vSub(im, im0));       \
+    }                                                                   \
+    if (i < size)                                                       \
+        applyMaskScalar(&result0[i], &result1[i], &buf[i], &mask[i], size - i); \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+computeMaskedPowers##__ISA__(float *power0, float *power1,              \
+                             const complex<float> *buf, const float *mask, \
+                             int size)                                  \
+{                                                                       \
+    Vec##__ISA__ re, im, m, re0, im0, re1, im1;                         \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoadComplex(&re, &im, &buf[i]);                                \
+        vLoad(&m, &mask[i]);                                            \
+        re0 = vMul(re, m);                                              \
+        im0 = vMul(im, m);                                              \
+        re1 = vSub(re, re0);                                            \
+        im1 = vSub(im, im0);                                            \
+        vStore(&power0[i], vAdd(vMul(re0, re0), vMul(im0, im0)));       \
+        vStore(&power1[i], vAdd(vMul(re1, re1), vMul(im1, im1)));       \
+    }                                                                   \
+    if (i < size)                                                       \
+        computeMaskedPowersScalar(&power0[i], &power1[i],               \
+                                  &buf[i], &mask[i], size - i);         \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+computeMaskedPower##__ISA__(float *power, const complex<float> *buf,    \
+                            const float *mask, int size)                \
+{                                                                       \
+    Vec##__ISA__ re, im, m, re0, im0;                                   \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoadComplex(&re, &im, &buf[i]);                                \
+        vLoad(&m, &mask[i]);                                            \
+        re0 = vMul(re, m);                                              \
+        im0 = vMul(im, m);                                              \
+        vStore(&power[i], vAdd(vMul(re0, re0), vMul(im0, im0)));        \
+    }                                                                   \
+    if (i < size)                                                       \
+        computeMaskedPowerScalar(&power[i], &buf[i], &mask[i], size - i);\
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+normalizeSoftMask##__ISA__(float *mask, const float *sigma,             \
+                           const float *sigmaSum, float eps, int size)  \
+{                                                                       \
+    Vec##__ISA__ s, sum, e, zero, one;                                  \
+    vSet(&e, eps);                                                      \
+    vSet(&zero, 0.0f);                                                  \
+    vSet(&one, 1.0f);                                                   \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoad(&s, &sigma[i]);                                           \
+        vLoad(&sum, &sigmaSum[i]);                                      \
+        vStore(&mask[i],                                                \
+               vMax(zero, vMin(one, vSelectGreater(sum, e, vDiv(s, sum)))));\
+    }                                                                   \
+    if (i < size)                                                       \
+        normalizeSoftMaskScalar(&mask[i], &sigma[i], &sigmaSum[i], eps, size - i);\
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+complexToSplit##__ISA__(float *real, float *imag,                       \
+                        const complex<float> *comp, int size)           \
+{                                                                       \
+    Vec##__ISA__ re, im;                                                \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoadComplex(&re, &im, &comp[i]);                               \
+        vStore(&real[i], re);                                           \
+        vStore(&imag[i], im);                                           \
+    }                                                                   \
+    if (i < size)                                                       \
+        complexToSplitScalar(&real[i], &imag[i], &comp[i], size - i);   \
+}                                                                       \
+                                                                        \
+static __TARGET__ void                                                  \
+splitToComplex##__ISA__(complex<float> *comp,                           \
+                        const float *real, const float *imag, int size) \
+{                                                                       \
+    Vec##__ISA__ re, im;                                                \
+    int i = 0;                                                          \
+    for (; i + __WIDTH__ <= size; i += __WIDTH__)                       \
+    {                                                                   \
+        vLoad(&re, &real[i]);                                           \
+        vLoad(&im, &imag[i]);                                           \
+        vStoreComplex(&comp[i], re, im);                                \
+    }                                                                   \
+    if (i < size)                                                       \
+        splitToComplexScalar(&comp[i], &real[i], &imag[i], size - i);   \
+}
+
+// The scalar versions process everything in their loop,
+// so they never call themselves for the last elements
+DEFINE_KERNELS(Scalar, , 1)
+
+#if BL_SIMD_X86
+DEFINE_KERNELS(SSE2, , 4)
+DEFINE_KERNELS(AVX2, TARGET_AVX2_NO_FMA, 8)
+#endif
+
+#if BL_SIMD_NEON
+DEFINE_KERNELS(NEON, , 4)
+#endif
+
+// dB conversions
+static void
+DBToAmpScalar(float *ioBuf, int size)
+{
+    for (int i = 0; i < size; i++)
+        ioBuf[i] = exp(((float)IAMP_DB)*ioBuf[i]);
+}
+
+static void
+ampToDBScalar(float *dBBuf, const float *ampBuf, int size,
+              float eps, float minDB)
+{
+    for (int i = 0; i < size; i++)
+    {
+        float absAmp = fabs(ampBuf[i]);
+
+        float dB = minDB;
+        if (absAmp > eps)
+            dB = AMP_DB*log(absAmp);
+
+        dBBuf[i] = dB;
+    }
+}
+
+// For the SIMD versions: the last elements are copied to padded buffers,
+// and processed like the others (so that the results do not depend
+// on the position of the elements)
+#define PROCESS_TAIL_DB_TO_AMP(__WIDTH__, __FUNC__)                     \
+    if (i < size)                                                       \
+    {                                                                   \
+        float tail[__WIDTH__] = {};                                     \
+        int numTail = size - i;                                         \
+        memcpy(tail, &ioBuf[i], numTail*sizeof(float));                \
+        __FUNC__(tail, tail);                                           \
+        memcpy(&ioBuf[i], tail, numTail*sizeof(float));                 \
+    }
+
+#define PROCESS_TAIL_AMP_TO_DB(__WIDTH__, __FUNC__)                     \
+    if (i < size)                                                       \
+    {                                                                   \
+        float ampTail[__WIDTH__] = {};                                  \
+        float dBTail[__WIDTH__];                                        \
+        int numTail = size - i;                                         \
+        memcpy(ampTail, &ampBuf[i], numTail*sizeof(float));             \
+        __FUNC__(dBTail, ampTail, eps, minDB);                          \
+        memcpy(&dBBuf[i], dBTail, numTail*sizeof(float));               \
+    }
+
+#if BL_SIMD_X86
+
+// SSE2
+static inline __m128
+expSSE2(__m128 x)
+{
+    __m128 tooSmall = _mm_cmplt_ps(x, _mm_set1_ps(EXP_MIN));
+    x = _mm_max_ps(_mm_min_ps(x, _mm_set1_ps(EXP_MAX)), _mm_set1_ps(EXP_MIN));
+
+    __m128i n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(LOG2_E)));
+    __m128 nf = _mm_cvtepi32_ps(n);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(nf, _mm_set1_ps(LN2_1)));
+    r = _mm_sub_ps(r, _mm_mul_ps(nf, _mm_set1_ps(LN2_2)));
+    __m128 r2 = _mm_mul_ps(r, r);
+
+    __m128 p = _mm_set1_ps(EXP_C0);
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_C1));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_C2));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_C3));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_C4));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_C5));
+    p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, r2), r), _mm_set1_ps(1.0f));
+
+    // 2^n
+    __m128 pow2 = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+
+    return _mm_andnot_ps(tooSmall, _mm_mul_ps(p, pow2));
+}
+
+static inline __m128
+logSSE2(__m128 x)
+{
+    x = _mm_max_ps(x, _mm_set1_ps(FLT_MIN));
+
+    // x = m*2^n, m in [0.5, 1[
+    __m128i xi = _mm_castps_si128(x);
+    __m128i n = _mm_sub_epi32(_mm_srli_epi32(xi, 23), _mm_set1_epi32(126));
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(xi, _mm_set1_epi32(0x007fffff)),
+                                             _mm_set1_epi32(0x3f000000)));
+
+    // m in [sqrt(2)/2, sqrt(2)[, minus 1
+    __m128 isSmall = _mm_cmplt_ps(m, _mm_set1_ps(SQRT_HALF));
+    __m128 nf = _mm_cvtepi32_ps(_mm_add_epi32(n, _mm_castps_si128(isSmall)));
+    m = _mm_add_ps(_mm_sub_ps(m, _mm_set1_ps(1.0f)), _mm_and_ps(isSmall, m));
+    __m128 m2 = _mm_mul_ps(m, m);
+
+    __m128 p = _mm_set1_ps(LOG_C0);
+    p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(LOG_C1));
+    p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(LOG_C2));
+    p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(LOG_C3));
+    p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(LOG_C4));
+    p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(LOG_C5));
+    p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(LOG_C6));
+    p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(LOG_C7));
+    p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(LOG_C8));
+    p = _mm_mul_ps(_mm_mul_ps(p, m), m2);
+
+    p = _mm_add_ps(p, _mm_mul_ps(nf, _mm_set1_ps(LN2_2)));
+    p = _mm_sub_ps(p, _mm_mul_ps(m2, _mm_set1_ps(0.5f)));
+
+    return _mm_add_ps(_mm_add_ps(m, p), _mm_mul_ps(nf, _mm_set1_ps(LN2_1)));
+}
+
+// 4 values
+static inline void
+toAmpSSE2(float *amp, const float *dB)
+{
+    __m128 x = _mm_mul_ps(_mm_loadu_ps(dB), _mm_set1_ps((float)IAMP_DB));
+    _mm_storeu_ps(amp, expSSE2(x));
+}
+
+static inline void
+toDBSSE2(float *dB, const float *amp, float eps, float minDB)
+{
+    __m128 absAmp = _mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_loadu_ps(amp));
+    __m128 x = _mm_mul_ps(logSSE2(absAmp), _mm_set1_ps((float)AMP_DB));
+
+    __m128 valid = _mm_cmpgt_ps(absAmp, _mm_set1_ps(eps));
+    x = _mm_or_ps(_mm_and_ps(valid, x), _mm_andnot_ps(valid, _mm_set1_ps(minDB)));
+
+    _mm_storeu_ps(dB, x);
+}
+
+static void
+DBToAmpSSE2(float *ioBuf, int size)
+{
+    int i = 0;
+    for (; i + 4 <= size; i += 4)
+        toAmpSSE2(&ioBuf[i], &ioBuf[i]);
+
+    PROCESS_TAIL_DB_TO_AMP(4, toAmpSSE2);
+}
+
+static void
+ampToDBSSE2(float *dBBuf, const float *ampBuf, int size,
+            float eps, float minDB)
+{
+    int i = 0;
+    for (; i + 4 <= size; i += 4)
+        toDBSSE2(&dBBuf[i], &ampBuf[i], eps, minDB);
+
+    PROCESS_TAIL_AMP_TO_DB(4, toDBSSE2);
+}
+
+// AVX2
+static inline BL_TARGET_AVX2 __m256
+expAVX2(__m256 x)
+{
+    __m256 tooSmall = _mm256_cmp_ps(x, _mm256_set1_ps(EXP_MIN), _CMP_LT_OQ);
+    x = _mm256_max_ps(_mm256_min_ps(x, _mm256_set1_ps(EXP_MAX)), _mm256_set1_ps(EXP_MIN));
+
+    __m256i n = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(LOG2_E)));
+    __m256 nf = _mm256_cvtepi32_ps(n);
+    __m256 r = _mm256_fnmadd_ps(nf, _mm256_set1_ps(LN2_1), x);
+    r = _mm256_fnmadd_ps(nf, _mm256_set1_ps(LN2_2), r);
+    __m256 r2 = _mm256_mul_ps(r, r);
+
+    __m256 p = _mm256_set1_ps(EXP_C0);
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_C1));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_C2));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_C3));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_C4));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_C5));
+    p = _mm256_add_ps(_mm256_fmadd_ps(p, r2, r), _mm256_set1_ps(1.0f));
+
+    // 2^n
+    __m256 pow2 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23));
+
+    return _mm256_andnot_ps(tooSmall, _mm256_mul_ps(p, pow2));
+}
+
+static inline BL_TARGET_AVX2 __m256
+logAVX2(__m256 x)
+{
+    x = _mm256_max_ps(x, _mm256_set1_ps(FLT_MIN));
+
+    // x = m*2^n, m in [0.5, 1[
+    __m256i xi = _mm256_castps_si256(x);
+    __m256i n = _mm256_sub_epi32(_mm256_srli_epi32(xi, 23), _mm256_set1_epi32(126));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(xi, _mm256_set1_epi32(0x007fffff)),
+                                                   _mm256_set1_epi32(0x3f000000)));
+
+    // m in [sqrt(2)/2, sqrt(2)[, minus 1
+    __m256 isSmall = _mm256_cmp_ps(m, _mm256_set1_ps(SQRT_HALF), _CMP_LT_OQ);
+    __m256 nf = _mm256_cvtepi32_ps(_mm256_add_epi32(n, _mm256_castps_si256(isSmall)));
+    m = _mm256_add_ps(_mm256_sub_ps(m, _mm256_set1_ps(1.0f)), _mm256_and_ps(isSmall, m));
+    __m256 m2 = _mm256_mul_ps(m, m);
+
+    __m256 p = _mm256_set1_ps(LOG_C0);
+    p = _mm256_fmadd_ps(p, m, _mm256_set1_ps(LOG_C1));
+    p = _mm256_fmadd_ps(p, m, _mm256_set1_ps(LOG_C2));
+    p = _mm256_fmadd_ps(p, m, _mm256_set1_ps(LOG_C3));
+    p = _mm256_fmadd_ps(p, m, _mm256_set1_ps(LOG_C4));
+    p = _mm256_fmadd_ps(p, m, _mm256_set1_ps(LOG_C5));
+    p = _mm256_fmadd_ps(p, m, _mm256_set1_ps(LOG_C6));
+    p = _mm256_fmadd_ps(p, m, _mm256_set1_ps(LOG_C7));
+    p = _mm256_fmadd_ps(p, m, _mm256_set1_ps(LOG_C8));
+    p = _mm256_mul_ps(_mm256_mul_ps(p, m), m2);
+
+    p = _mm256_fmadd_ps(nf, _mm256_set1_ps(LN2_2), p);
+    p = _mm256_fnmadd_ps(m2, _mm256_set1_ps(0.5f), p);
+
+    return _mm256_fmadd_ps(nf, _mm256_set1_ps(LN2_1), _mm256_add_ps(m, p));
+}
+
+// 8 values
+static inline BL_TARGET_AVX2 void
+toAmpAVX2(float *amp, const float *dB)
+{
+    __m256 x = _mm256_mul_ps(_mm256_loadu_ps(dB), _mm256_set1_ps((float)IAMP_DB));
+    _mm256_storeu_ps(amp, expAVX2(x));
+}
+
+static inline BL_TARGET_AVX2 void
+toDBAVX2(float *dB, const float *amp, float eps, float minDB)
+{
+    __m256 absAmp = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), _mm256_loadu_ps(amp));
+    __m256 x = _mm256_mul_ps(logAVX2(absAmp), _mm256_set1_ps((float)AMP_DB));
+
+    __m256 valid = _mm256_cmp_ps(absAmp, _mm256_set1_ps(eps), _CMP_GT_OQ);
+
+    _mm256_storeu_ps(dB, _mm256_blendv_ps(_mm256_set1_ps(minDB), x, valid));
+}
+
+static BL_TARGET_AVX2 void
+DBToAmpAVX2(float *ioBuf, int size)
+{
+    int i = 0;
+    for (; i + 8 <= size; i += 8)
+        toAmpAVX2(&ioBuf[i], &ioBuf[i]);
+
+    PROCESS_TAIL_DB_TO_AMP(8, toAmpAVX2);
+}
+
+static BL_TARGET_AVX2 void
+ampToDBAVX2(float *dBBuf, const float *ampBuf, int size,
+            float eps, float minDB)
+{
+    int i = 0;
+    for (; i + 8 <= size; i += 8)
+        toDBAVX2(&dBBuf[i], &ampBuf[i], eps, minDB);
+
+    PROCESS_TAIL_AMP_TO_DB(8, toDBAVX2);
+}
+
+#endif
+
+#if BL_SIMD_NEON
+
+static inline float32x4_t
+expNEON(float32x4_t x)
+{
+    uint32x4_t tooSmall = vcltq_f32(x, vdupq_n_f32(EXP_MIN));
+    x = vmaxq_f32(vminq_f32(x, vdupq_n_f32(EXP_MAX)), vdupq_n_f32(EXP_MIN));
+
+    int32x4_t n = vcvtnq_s32_f32(vmulq_f32(x, vdupq_n_f32(LOG2_E)));
+    float32x4_t nf = vcvtq_f32_s32(n);
+    float32x4_t r = vfmsq_f32(x, nf, vdupq_n_f32(LN2_1));
+    r = vfmsq_f32(r, nf, vdupq_n_f32(LN2_2));
+    float32x4_t r2 = vmulq_f32(r, r);
+
+    float32x4_t p = vdupq_n_f32(EXP_C0);
+    p = vfmaq_f32(vdupq_n_f32(EXP_C1), p, r);
+    p = vfmaq_f32(vdupq_n_f32(EXP_C2), p, r);
+    p = vfmaq_f32(vdupq_n_f32(EXP_C3), p, r);
+    p = vfmaq_f32(vdupq_n_f32(EXP_C4), p, r);
+    p = vfmaq_f32(vdupq_n_f32(EXP_C5), p, r);
+    p = vaddq_f32(vfmaq_f32(r, p, r2), vdupq_n_f32(1.0f));
+
+    // 2^n
+    float32x4_t pow2 = vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23));
+    float32x4_t result = vmulq_f32(p, pow2);
+
+    return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(result), tooSmall));
+}
+
+static inline float32x4_t
+logNEON(float32x4_t x)
+{
+    x = vmaxq_f32(x, vdupq_n_f32(FLT_MIN));
+
+    // x = m*2^n, m in [0.5, 1[
+    uint32x4_t xi = vreinterpretq_u32_f32(x);
+    int32x4_t n = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(xi, 23)), vdupq_n_s32(126));
+    float32x4_t m = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(xi, vdupq_n_u32(0x007fffff)),
+                                                    vdupq_n_u32(0x3f000000)));
+
+    // m in [sqrt(2)/2, sqrt(2)[, minus 1
+    uint32x4_t isSmall = vcltq_f32(m, vdupq_n_f32(SQRT_HALF));
+    float32x4_t nf = vcvtq_f32_s32(vaddq_s32(n, vreinterpretq_s32_u32(isSmall)));
+    float32x4_t mSmall = vreinterpretq_f32_u32(vandq_u32(isSmall, vreinterpretq_u32_f32(m)));
+    m = vaddq_f32(vsubq_f32(m, vdupq_n_f32(1.0f)), mSmall);
+    float32x4_t m2 = vmulq_f32(m, m);
+
+    float32x4_t p = vdupq_n_f32(LOG_C0);
+    p = vfmaq_f32(vdupq_n_f32(LOG_C1), p, m);
+    p = vfmaq_f32(vdupq_n_f32(LOG_C2), p, m);
+    p = vfmaq_f32(vdupq_n_f32(LOG_C3), p, m);
+    p = vfmaq_f32(vdupq_n_f32(LOG_C4), p, m);
+    p = vfmaq_f32(vdupq_n_f32(LOG_C5), p, m);
+    p = vfmaq_f32(vdupq_n_f32(LOG_C6), p, m);
+    p = vfmaq_f32(vdupq_n_f32(LOG_C7), p, m);
+    p = vfmaq_f32(vdupq_n_f32(LOG_C8), p, m);
+    p = vmulq_f32(vmulq_f32(p, m), m2);
+
+    p = vfmaq_f32(p, nf, vdupq_n_f32(LN2_2));
+    p = vfmsq_f32(p, m2, vdupq_n_f32(0.5f));
+
+    return vfmaq_f32(vaddq_f32(m, p), nf, vdupq_n_f32(LN2_1));
+}
+
+// 4 values
+static inline void
+toAmpNEON(float *amp, const float *dB)
+{
+    float32x4_t x = vmulq_f32(vld1q_f32(dB), vdupq_n_f32((float)IAMP_DB));
+    vst1q_f32(amp, expNEON(x));
+}
+
+static inline void
+toDBNEON(float *dB, const float *amp, float eps, float minDB)
+{
+    float32x4_t absAmp = vabsq_f32(vld1q_f32(amp));
+    float32x4_t x = vmulq_f32(logNEON(absAmp), vdupq_n_f32((float)AMP_DB));
+
+    uint32x4_t valid = vcgtq_f32(absAmp, vdupq_n_f32(eps));
+
+    vst1q_f32(dB, vbslq_f32(valid, x, vdupq_n_f32(minDB)));
+}
+
+static void
+DBToAmpNEON(float *ioBuf, int size)
+{
+    int i = 0;
+    for (; i + 4 <= size; i += 4)
+        toAmpNEON(&ioBuf[i], &ioBuf[i]);
+
+    PROCESS_TAIL_DB_TO_AMP(4, toAmpNEON);
+}
+
+static void
+ampToDBNEON(float *dBBuf, const float *ampBuf, int size,
+            float eps, float minDB)
+{
+    int i = 0;
+    for (; i + 4 <= size; i += 4)
+        toDBNEON(&dBBuf[i], &ampBuf[i], eps, minDB);
+
+    PROCESS_TAIL_AMP_TO_DB(4, toDBNEON);
+}
+
+#endif
+
+// Call the version for the cpu
+#if BL_SIMD_X86
+#define DISPATCH(__FUNC__, ...)                                         \
+    switch (CpuFeatures::getLevel())                                    \
+    {                                                                   \
+        case CpuFeatures::SIMD_256:                                     \
+            __FUNC__##AVX2(__VA_ARGS__);                                \
+            break;                                                      \
+        case CpuFeatures::SIMD_128:                                     \
+            __FUNC__##SSE2(__VA_ARGS__);                                \
+            break;                                                      \
+        default:                                                        \
+            __FUNC__##Scalar(__VA_ARGS__);                              \
+            break;                                                      \
+    }
+#elif BL_SIMD_NEON
+#define DISPATCH(__FUNC__, ...)                                         \
+    switch (CpuFeatures::getLevel())                                    \
+    {                                                                   \
+        case CpuFeatures::SIMD_128:                                     \
+            __FUNC__##NEON(__VA_ARGS__);                                \
+            break;                                                      \
+        default:                                                        \
+            __FUNC__##Scalar(__VA_ARGS__);                              \
+            break;                                                      \
+    }
+#else
+#define DISPATCH(__FUNC__, ...) __FUNC__##Scalar(__VA_ARGS__);
+#endif
+
+void
+BufferKernels::add(float *ioBuf, const float *buf, int size)
+{
+    DISPATCH(add, ioBuf, buf, size);
+}
+
+void
+BufferKernels::add(complex<float> *ioBuf, const complex<float> *buf, int size)
+{
+    // Same as for floats
+    DISPATCH(add, (float *)ioBuf, (const float *)buf, 2*size);
+}
+
+void
+BufferKernels::add(float *result, const float *buf0, const float *buf1, int size)
+{
+    DISPATCH(add, result, buf0, buf1, size);
+}
+
+void
+BufferKernels::substract(float *ioBuf, const float *buf, int size)
+{
+    DISPATCH(substract, ioBuf, buf, size);
+}
+
+void
+BufferKernels::substract(complex<float> *ioBuf, const complex<float> *buf, int size)
+{
+    DISPATCH(substract, (float *)ioBuf, (const float *)buf, 2*size);
+}
+
+void
+BufferKernels::mult(float *ioBuf, const float *buf, int size)
+{
+    DISPATCH(mult, ioBuf, buf, size);
+}
+
+void
+BufferKernels::mult(complex<float> *ioBuf, const float *buf, int size)
+{
+    DISPATCH(mult, ioBuf, buf, size);
+}
+
+void
+BufferKernels::mult(complex<float> *ioBuf, const complex<float> *buf, int size)
+{
+    DISPATCH(mult, ioBuf, buf, size);
+}
+
+void
+BufferKernels::multValue(float *ioBuf, float value, int size)
+{
+    DISPATCH(multValue, ioBuf, value, size);
+}
+
+void
+BufferKernels::multValue(complex<float> *ioBuf, float value, int size)
+{
+    DISPATCH(multValue, (float *)ioBuf, value, 2*size);
+}
+
+void
+BufferKernels::addMultValue(float *ioBuf, const float *buf, float value, int size)
+{
+    DISPATCH(addMultValue, ioBuf, buf, value, size);
+}
+
+void
+BufferKernels::addMultValue(complex<float> *ioBuf, const complex<float> *buf,
+                            float value, int size)
+{
+    DISPATCH(addMultValue, (float *)ioBuf, (const float *)buf, value, 2*size);
+}
+
+void
+BufferKernels::mix(float *result,
+                   const float *buf0, float value0,
+                   const float *buf1, float value1, int size)
+{
+    DISPATCH(mix, result, buf0, value0, buf1, value1, size);
+}
+
+void
+BufferKernels::mix(complex<float> *result,
+                   const complex<float> *buf0, float value0,
+                   const complex<float> *buf1, float value1, int size)
+{
+    DISPATCH(mix, (float *)result,
+             (const float *)buf0, value0, (const float *)buf1, value1, 2*size);
+}
+
+void
+BufferKernels::computeNormOpposite(float *ioBuf, int size)
+{
+    DISPATCH(computeNormOpposite, ioBuf, size);
+}
+
+void
+BufferKernels::computeSquareConjugate(complex<float> *ioBuf, int size)
+{
+    DISPATCH(computeSquareConjugate, ioBuf, size);
+}
+
+void
+BufferKernels::clipMin(float *ioBuf, float minValue, int size)
+{
+    DISPATCH(clipMin, ioBuf, minValue, size);
+}
+
+void
+BufferKernels::clipMax(float *ioBuf, float maxValue, int size)
+{
+    DISPATCH(clipMax, ioBuf, maxValue, size);
+}
+
+void
+BufferKernels::DBToAmp(float *ioBuf, int size)
+{
+    DISPATCH(DBToAmp, ioBuf, size);
+}
+
+void
+BufferKernels::ampToDB(float *dBBuf, const float *ampBuf, int size,
+                       float eps, float minDB)
+{
+    DISPATCH(ampToDB, dBBuf, ampBuf, size, eps, minDB);
+}
+
+void
+BufferKernels::multMaskValue(complex<float> *result, const complex<float> *buf,
+                             const float *mask, float value, int size)
+{
+    DISPATCH(multMaskValue, result, buf, mask, value, size);
+}
+
+void
+BufferKernels::mixMasks(complex<float> *result, const complex<float> *buf,
+                        const float *mask, float value0, float value1, int size)
+{
+    DISPATCH(mixMasks, result, buf, mask, value0, value1, size);
+}
+
+void
+BufferKernels::applyMask(complex<float> *result0, complex<float> *result1,
+                         const complex<float> *buf, const complex<float> *mask,
+                         int size)
+{
+    DISPATCH(applyMask, result0, result1, buf, mask, size);
+}
+
+void
+BufferKernels::computeMaskedSquares(complex<float> *square0, complex<float> *square1,
+                                    const complex<float> *buf, const float *mask,
+                                    int size)
+{
+    DISPATCH(computeMaskedSquares, square0, square1, buf, mask, size);
+}
+
+void
+BufferKernels::applyMask(complex<float> *result0, complex<float> *result1,
+                         const complex<float> *buf, const float *mask, int size)
+{
+    DISPATCH(applyMask, result0, result1, buf, mask, size);
+}
+
+void
+BufferKernels::computeMaskedPowers(float *power0, float *power1,
+                                   const complex<float> *buf, const float *mask,
+                                   int size)
+{
+    DISPATCH(computeMaskedPowers, power0, power1, buf, mask, size);
+}
+
+void
+BufferKernels::computeMaskedPower(float *power, const complex<float> *buf,
+                                  const float *mask, int size)
+{
+    DISPATCH(computeMaskedPower, power, buf, mask, size);
+}
+
+void
+BufferKernels::normalizeSoftMask(float *mask, const float *sigma, const float *sigmaSum,
+                                 float eps, int size)
+{
+    DISPATCH(normalizeSoftMask, mask, sigma, sigmaSum, eps, size);
+}
+
+void
+BufferKernels::complexToSplit(float *real, float *imag,
+                              const complex<float> *comp, int size)
+{
+    DISPATCH(complexToSplit, real, imag, comp, size);
+}
+
+void
+BufferKernels::splitToComplex(complex<float> *comp,
+                              const float *real, const float *imag, int size)
+{
+    DISPATCH(splitToComplex, comp, real, imag, size);
+}
@@ -0,0 +1,129 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef BUFFER_KERNELS_H
+#define BUFFER_KERNELS_H
+
+#include <complex>
+using namespace std;
+
+// Arithmetic on float and complex buffers (pointer + size)
+//
+// The implementation is chosen at runtime, with CpuFeatures::getLevel():
+// scalar, sse2, avx2 or neon.
+// All the versions do the same operations in the same order as the scalar code,
+// so the results are identical (if the compiler doesn't fuse multiplies and adds),
+// except for the dB conversions (see DBToAmp() and ampToDB()).
+// The buffers can be the same (in place), but must not partially overlap.
+class BufferKernels
+{
+public:
+    static void add(float *ioBuf, const float *buf, int size);
+    static void add(complex<float> *ioBuf, const complex<float> *buf, int size);
+    static void add(float *result, const float *buf0, const float *buf1, int size);
+
+    static void substract(float *ioBuf, const float *buf, int size);
+    static void substract(complex<float> *ioBuf, const complex<float> *buf, int size);
+
+    static void mult(float *ioBuf, const float *buf, int size);
+    static void mult(complex<float> *ioBuf, const float *buf, int size);
+    static void mult(complex<float> *ioBuf, const complex<float> *buf, int size);
+
+    static void multValue(float *ioBuf, float value, int size);
+    static void multValue(complex<float> *ioBuf, float value, int size);
+
+    // ioBuf += buf*value
+    static void addMultValue(float *ioBuf, const float *buf, float value, int size);
+    static void addMultValue(complex<float> *ioBuf, const complex<float> *buf,
+                             float value, int size);
+
+    // result = buf0*value0 + buf1*value1
+    static void mix(float *result,
+                    const float *buf0, float value0,
+                    const float *buf1, float value1, int size);
+    static void mix(complex<float> *result,
+                    const complex<float> *buf0, float value0,
+                    const complex<float> *buf1, float value1, int size);
+
+    // 1 - x
+    static void computeNormOpposite(float *ioBuf, int size);
+
+    // conj(x)*x, i.e |x|^2
+    static void computeSquareConjugate(complex<float> *ioBuf, int size);
+
+    static void clipMin(float *ioBuf, float minValue, int size);
+    static void clipMax(float *ioBuf, float maxValue, int size);
+
+    // SIMD versions: exp() polynomial, relative error 2e-7,
+    // results below FLT_MIN (under -758dB) are flushed to 0,
+    // and above 764dB are clipped to 1.6e38 instead of inf
+    static void DBToAmp(float *ioBuf, int size);
+
+    // minDB if |amp| <= eps
+    // SIMD versions: log() polynomial, error 2 ulp (2e-5dB in [-120dB, 120dB]),
+    // amplitudes below FLT_MIN (denormals) give -758dB
+    static void ampToDB(float *dBBuf, const float *ampBuf, int size,
+                        float eps, float minDB);
+
+    // Fused kernels, to avoid several passes over the buffers
+
+    // result = buf*mask*value
+    static void multMaskValue(complex<float> *result, const complex<float> *buf,
+                              const float *mask, float value, int size);
+
+    // result = buf*mask*value0 + buf*(1 - mask)*value1
+    static void mixMasks(complex<float> *result, const complex<float> *buf,
+                         const float *mask, float value0, float value1, int size);
+
+    // result0 = buf*mask, result1 = buf - result0
+    static void applyMask(complex<float> *result0, complex<float> *result1,
+                          const complex<float> *buf, const complex<float> *mask,
+                          int size);
+
+    // Same, with a real mask
+    static void applyMask(complex<float> *result0, complex<float> *result1,
+                          const complex<float> *buf, const float *mask, int size);
+    
+    // Squares of buf*mask and of buf - buf*mask
+    // (as complex, with an imaginary part of 0)
+    static void computeMaskedSquares(complex<float> *square0, complex<float> *square1,
+                                     const complex<float> *buf, const float *mask,
+                                     int size);
+
+    // Same, as floats
+    static void computeMaskedPowers(float *power0, float *power1,
+                                    const complex<float> *buf, const float *mask,
+                                    int size);
+
+    // |buf*mask|^2, for one source
+    static void computeMaskedPower(float *power, const complex<float> *buf,
+                                   const float *mask, int size);
+    
+    // mask = sigma/sigmaSum, 0 if the sum is <= eps,
+    // clipped to [0, 1]
+    static void normalizeSoftMask(float *mask, const float *sigma, const float *sigmaSum,
+                                  float eps, int size);
+
+    // Conversions between interleaved complex and split real/imag buffers
+    static void complexToSplit(float *real, float *imag,
+                               const complex<float> *comp, int size);
+    static void splitToComplex(complex<float> *comp,
+                               const float *real, const float *imag, int size);
+};
+
+#endif
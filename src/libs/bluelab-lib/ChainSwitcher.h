@@ -0,0 +1,437 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef CHAIN_SWITCHER_H
+#define CHAIN_SWITCHER_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <vector>
+using namespace std;
+
+#include <juce_core/juce_core.h>
+
+#include "RTSemaphore.h"
+
+class RTWorkerPool;
+
+// What the chains are built for, fixed between two setChain() calls
+// (the factory gets a copy, so it doesn't read the processor members
+// while prepareToPlay() modifies them)
+struct ChainContext
+{
+    int _numChannels = 0;
+    double _sampleRate = 0.0;
+    int _maxBlockSize = 0;
+    
+    // Not owned
+    RTWorkerPool *_workerPool = NULL;
+};
+
+// Switch between two processing chains (OverlapAdd and its processors)
+// without glitch, and without allocating on the audio thread
+//
+// The new chain is built on a background thread. Then it runs in parallel
+// with the current chain: silently during the warmup (until its output
+// is valid), then crossfaded. At the end, the old chain is deleted
+// on the background thread
+//
+// If the chains have different latencies, the one with the lowest latency
+// is delayed by the difference during the switch, so that the crossfade
+// mixes aligned signals. The delay is itself added or removed with a fade
+// (so there is some comb filtering during this fade, but no time jump):
+// - new chain with more latency: the current chain fades to its delayed
+// output, then the chains are crossfaded
+// - new chain with less latency: the chains are crossfaded, then the new
+// chain fades from its delayed output
+// The new latency should be reported to the host when the switch is done
+// (see advance())
+template <typename T>
+class ChainSwitcher : public juce::Thread
+{
+public:
+    // Build a chain for a given setting, on the background thread
+    typedef std::function<T *(const ChainContext &context, int setting)> Factory;
+    
+    ChainSwitcher(Factory factory, int fadeSamples)
+    : juce::Thread("ChainSwitcher"), _factory(factory)
+    {
+        _fadeSamples = fadeSamples;
+        
+        _chain = NULL;
+        _setting = 0;
+
+        _nextChain = NULL;
+        _nextSetting = 0;
+        _nextWarmupSamples = 0;
+        _fadePos = 0;
+
+        _delay = 0;
+        _delaySet = false;
+        
+        _readyChain = NULL;
+        _readySetting = 0;
+        _readyWarmupSamples = 0;
+
+        _retiredChain = NULL;
+        
+        _request = 0;
+        _generation = 0;
+        _builtSetting = 0;
+        
+        startThread();
+    }
+    
+    virtual ~ChainSwitcher()
+    {
+        signalThreadShouldExit();
+        _event.post();
+        
+        stopThread(1000);
+
+        if (_chain != NULL)
+            delete _chain;
+        if (_nextChain != NULL)
+            delete _nextChain;
+        if (_readyChain != NULL)
+            delete _readyChain;
+        if (_retiredChain != NULL)
+            delete _retiredChain;
+    }
+
+    // Not real-time safe
+    void setFadeSamples(int fadeSamples)
+    {
+        _fadeSamples = fadeSamples;
+    }
+
+    // Not real-time safe, must not be called during processing
+    // Allocate the delay lines that align the chains during a switch
+    // numChannels: number of signals passed to crossfade()
+    // maxDelay: maximum latency difference between two chains
+    void prepare(int numChannels, int maxDelay)
+    {
+        _delayLines.resize(numChannels);
+        _delayPos.resize(numChannels);
+        for (int i = 0; i < numChannels; i++)
+        {
+            _delayLines[i].resize(maxDelay);
+            _delayPos[i] = 0;
+        }
+
+        _delaySet = false;
+    }
+    
+    // Not real-time safe, must not be called during processing
+    // Set the current chain directly, and cancel the switch in progress
+    // The next chains will be built for context
+    void setChain(T *chain, int setting, const ChainContext &context)
+    {
+        std::lock_guard<std::mutex> lock(_buildMutex);
+
+        // A chain being built now will be dropped
+        _generation++;
+        _context = context;
+        
+        if (_chain != NULL)
+            delete _chain;
+        _chain = chain;
+        _setting = setting;
+
+        if (_nextChain != NULL)
+            delete _nextChain;
+        _nextChain = NULL;
+
+        _delay = 0;
+
+        T *readyChain = _readyChain.exchange(NULL);
+        if (readyChain != NULL)
+            delete readyChain;
+
+        _request = makeRequest(setting, 0);
+        _builtSetting = setting;
+    }
+
+    T *getChain()
+    {
+        return _chain;
+    }
+
+    int getSetting() const
+    {
+        return _setting;
+    }
+
+    // Real-time safe
+    // Ask for a chain with another setting
+    // warmupSamples: number of samples before the new chain output is valid
+    void requestSetting(int setting, int warmupSamples)
+    {
+        int64_t request = makeRequest(setting, warmupSamples);
+        if (_request.exchange(request) != request)
+            _event.post();
+    }
+
+    // Real-time safe, call once at the beginning of each block
+    // Return the new chain, if it must be processed in parallel, NULL otherwise
+    T *getNextChain()
+    {
+        if (_nextChain == NULL)
+        {
+            // The background thread does not modify the ready chain
+            // until it is taken
+            T *readyChain = _readyChain.load();
+            if (readyChain != NULL)
+            {
+                _nextSetting = _readySetting;
+                _nextWarmupSamples = _readyWarmupSamples;
+                _fadePos = 0;
+                
+                _nextChain = readyChain;
+                _readyChain = NULL;
+
+                _delaySet = false;
+                
+                // A request may be waiting for the ready chain to be taken
+                _event.post();
+            }
+        }
+
+        return _nextChain;
+    }
+
+    // Real-time safe, call for each block of the switch, before crossfade()
+    // The delay is set at the first call of the switch
+    void setLatencies(int latency, int nextLatency)
+    {
+        if (_delaySet)
+            return;
+        
+        // > 0: the current chain is delayed, < 0: the new chain
+        _delay = nextLatency - latency;
+        
+        int maxDelay = _delayLines.empty() ? 0 : (int)_delayLines[0].size();
+        if (_delay > maxDelay)
+            _delay = maxDelay;
+        if (_delay < -maxDelay)
+            _delay = -maxDelay;
+
+        int delay = (_delay > 0) ? _delay : -_delay;
+        for (int i = 0; i < _delayLines.size(); i++)
+        {
+            memset(_delayLines[i].data(), 0, delay*sizeof(float));
+            _delayPos[i] = 0;
+        }
+        
+        _delaySet = true;
+    }
+    
+    // Real-time safe
+    // Mix the output of the new chain into ioSamples, for the current block
+    // channel: index of the delay line, if the latencies are different
+    void crossfade(int channel, float *ioSamples, const float *nextSamples, int numSamples)
+    {
+        if ((_delay == 0) || (channel >= _delayLines.size()))
+        {
+            for (int i = 0; i < numSamples; i++)
+            {
+                float t = getFade(_fadePos + i - _nextWarmupSamples);
+                
+                ioSamples[i] += t*(nextSamples[i] - ioSamples[i]);
+            }
+            
+            return;
+        }
+        
+        float *line = _delayLines[channel].data();
+        int pos = _delayPos[channel];
+        int delay = (_delay > 0) ? _delay : -_delay;
+        
+        for (int i = 0; i < numSamples; i++)
+        {
+            int fadePos = _fadePos + i - _nextWarmupSamples;
+            
+            // The delay line runs from the beginning of the warmup
+            float sample = (_delay > 0) ? ioSamples[i] : nextSamples[i];
+            float delayed = line[pos];
+            line[pos] = sample;
+            if (++pos >= delay)
+                pos = 0;
+
+            // Both fades are consecutive, with the delayed signal in between
+            float t0 = getFade(fadePos);
+            float t1 = getFade(fadePos - _fadeSamples);
+            
+            if (_delay > 0)
+                // Current chain, to current chain delayed, to new chain
+                ioSamples[i] = sample + t0*(delayed - sample) +
+                    t1*(nextSamples[i] - delayed);
+            else
+                // Current chain, to new chain delayed, to new chain
+                ioSamples[i] += t0*(delayed - ioSamples[i]) + t1*(sample - delayed);
+        }
+
+        _delayPos[channel] = pos;
+    }
+
+    // Real-time safe, call at the end of each block
+    // Return true if the new chain has just become the current one
+    bool advance(int numSamples)
+    {
+        if (_nextChain == NULL)
+            return false;
+        
+        // Two fades if the delay must be added or removed
+        int numFades = (_delay != 0) ? 2 : 1;
+        
+        _fadePos += numSamples;
+        if (_fadePos < _nextWarmupSamples + numFades*_fadeSamples)
+            return false;
+
+        // The previous chain has not been deleted yet, retry at next block
+        // (the new chain is fully faded in)
+        if (_retiredChain.load() != NULL)
+            return false;
+
+        _retiredChain = _chain;
+        _event.post();
+        
+        _chain = _nextChain;
+        _setting = _nextSetting;
+        _nextChain = NULL;
+
+        _delay = 0;
+        
+        return true;
+    }
+    
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            T *retiredChain = _retiredChain.exchange(NULL);
+            if (retiredChain != NULL)
+                delete retiredChain;
+
+            buildRequestedChain();
+
+            // Until a new request, a chain to delete, or the ready chain is taken
+            _event.wait();
+        }
+    }
+
+protected:
+    // Weight of the fade, from 0 to 1, pos: from the beginning of the fade
+    float getFade(int pos) const
+    {
+        if (pos <= 0)
+            return 0.0;
+        if (pos >= _fadeSamples)
+            return 1.0;
+
+        return ((float)pos)/_fadeSamples;
+    }
+    
+    static int64_t makeRequest(int setting, int warmupSamples)
+    {
+        return (((int64_t)setting) << 32) | (uint32_t)warmupSamples;
+    }
+
+    void buildRequestedChain()
+    {
+        // Wait until the previous chain is taken
+        if (_readyChain.load() != NULL)
+            return;
+        
+        int64_t request = _request;
+        int setting = (int)(request >> 32);
+        int warmupSamples = (int)(request & 0xffffffff);
+
+        int generation;
+        ChainContext context;
+        {
+            std::lock_guard<std::mutex> lock(_buildMutex);
+
+            if (setting == _builtSetting)
+                return;
+
+            generation = _generation;
+            context = _context;
+        }
+        
+        T *chain = _factory(context, setting);
+        
+        std::lock_guard<std::mutex> lock(_buildMutex);
+        
+        // setChain() has been called in the meantime
+        if (generation != _generation)
+        {
+            delete chain;
+            
+            return;
+        }
+
+        _readySetting = setting;
+        _readyWarmupSamples = warmupSamples;
+        _readyChain = chain;
+
+        _builtSetting = setting;
+    }
+    
+    Factory _factory;
+
+    int _fadeSamples;
+
+    // Audio thread
+    T *_chain;
+    int _setting;
+
+    T *_nextChain;
+    int _nextSetting;
+    int _nextWarmupSamples;
+    int _fadePos;
+
+    // One for each channel
+    vector<vector<float> > _delayLines;
+    vector<int> _delayPos;
+    int _delay;
+    bool _delaySet;
+
+    // From the background thread to the audio thread
+    std::atomic<T *> _readyChain;
+    int _readySetting;
+    int _readyWarmupSamples;
+
+    // From the audio thread to the background thread
+    std::atomic<T *> _retiredChain;
+    std::atomic<int64_t> _request;
+
+    // Background thread
+    std::mutex _buildMutex;
+    int _generation;
+    int _builtSetting;
+    ChainContext _context;
+
+    RTSemaphore _event;
+};
+
+#endif
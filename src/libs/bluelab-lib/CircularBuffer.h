@@ -45,6 +45,17 @@ public:
         _writeIdx = 0;
     }
     
+    int getCapacity() const
+    {
+        return _data.size();
+    }
+
+    void clear()
+    {
+        _readIdx = 0;
+        _writeIdx = 0;
+    }
+    
     int getSize() const
     {
         int size = _writeIdx - _readIdx;
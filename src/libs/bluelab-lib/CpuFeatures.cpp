@@ -0,0 +1,142 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <atomic>
+
+#include "CpuFeatures.h"
+
+#if BL_SIMD_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static std::atomic<int> _maxLevel(CpuFeatures::SIMD_256);
+
+bool
+CpuFeatures::hasSSE2()
+{
+#if BL_SIMD_X86
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+#else
+    return false;
+#endif
+}
+
+bool
+CpuFeatures::hasAVX2()
+{
+#if BL_SIMD_X86
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+
+    // The os must save the ymm registers
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || ((_xgetbv(0) & 0x6) != 0x6))
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    // Also checks that the os supports avx
+    return __builtin_cpu_supports("avx2");
+#endif
+#else
+    return false;
+#endif
+}
+
+bool
+CpuFeatures::hasFMA()
+{
+#if BL_SIMD_X86
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 12)) != 0;
+#else
+    return __builtin_cpu_supports("fma");
+#endif
+#else
+    return false;
+#endif
+}
+
+bool
+CpuFeatures::hasNEON()
+{
+    // Mandatory on aarch64
+    return BL_SIMD_NEON;
+}
+
+CpuFeatures::Level
+CpuFeatures::getLevel()
+{
+    // Detected once
+    static const Level cpuLevel = detectLevel();
+
+    int maxLevel = _maxLevel.load(std::memory_order_relaxed);
+    
+    return (cpuLevel < maxLevel) ? cpuLevel : (Level)maxLevel;
+}
+
+const char *
+CpuFeatures::getLevelName(Level level)
+{
+    switch (level)
+    {
+        case SIMD_128:
+            return BL_SIMD_NEON ? "neon" : "sse2";
+
+        case SIMD_256:
+            return "avx2";
+
+        default:
+            return "scalar";
+    }
+}
+
+void
+CpuFeatures::setMaxLevel(Level level)
+{
+    _maxLevel.store(level, std::memory_order_relaxed);
+}
+
+CpuFeatures::Level
+CpuFeatures::getMaxLevel()
+{
+    return (Level)_maxLevel.load(std::memory_order_relaxed);
+}
+
+CpuFeatures::Level
+CpuFeatures::detectLevel()
+{
+    if (hasAVX2() && hasFMA())
+        return SIMD_256;
+
+    if (hasSSE2() || hasNEON())
+        return SIMD_128;
+
+    return SCALAR;
+}
@@ -0,0 +1,82 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// Set to 0 (e.g in the jucer defines) to build only the scalar code
+#ifndef BL_SIMD
+#define BL_SIMD 1
+#endif
+
+// x86_64 only (sse2 is always available)
+#if BL_SIMD && (defined(__x86_64__) || defined(_M_X64))
+#define BL_SIMD_X86 1
+#else
+#define BL_SIMD_X86 0
+#endif
+
+// aarch64 only (armv7 neon has no division nor sqrt)
+#if BL_SIMD && (defined(__aarch64__) || defined(_M_ARM64))
+#define BL_SIMD_NEON 1
+#else
+#define BL_SIMD_NEON 0
+#endif
+
+// Functions using avx2 and fma, in code built for the base x86 instruction set
+// (they must only be called if the cpu supports them)
+#if BL_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define BL_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define BL_TARGET_AVX2
+#endif
+
+// Instruction sets of the running cpu
+// The SIMD code is built for all the levels of the architecture,
+// and the kernels choose at runtime
+class CpuFeatures
+{
+public:
+    enum Level
+    {
+        SCALAR = 0,
+        // sse2 (always available on x86_64), or neon
+        SIMD_128,
+        // avx2 and fma
+        SIMD_256
+    };
+
+    static bool hasSSE2();
+    static bool hasAVX2();
+    static bool hasFMA();
+    static bool hasNEON();
+
+    // Best level of the cpu, limited by setMaxLevel()
+    static Level getLevel();
+
+    static const char *getLevelName(Level level);
+
+    // E.g to compare the SIMD kernels with the scalar code
+    static void setMaxLevel(Level level);
+    static Level getMaxLevel();
+
+protected:
+    static Level detectLevel();
+};
+
+#endif
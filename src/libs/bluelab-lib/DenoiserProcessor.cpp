@@ -18,7 +18,10 @@
 
 #include "WienerSoftMasking.h"
 #include "Utils.h"
+#include "BufferKernels.h"
 #include "Defines.h"
+#include "Profiler.h"
+#include "NoiseLearner.h"
 #include "DenoiserProcessor.h"
 
 
@@ -32,8 +35,6 @@
 // Process the line #2, so we are in the center of the kernel window
 #define RES_NOISE_LINE_NUM 2
 
-#define NOISE_CURVE_SMOOTH_COEFF 0.99
-
 #define DEFAULT_VALUE_SIGNAL 0.0
 
 // 4 gives less gating, but a few musical noise remaining
@@ -50,6 +51,7 @@ DenoiserProcessor::DenoiserProcessor(int bufferSize, int overlap, float threshol
 {
     _bufferSize = bufferSize;
     _overlap = overlap;
+    _sampleRate = 44100.0;
     
 #if USE_AUTO_RES_NOISE
     _softMasking = NULL;
@@ -65,13 +67,19 @@ DenoiserProcessor::DenoiserProcessor(int bufferSize, int overlap, float threshol
     
     // Noise capture
     _isBuildingNoiseStatistics = false;
+
+    _noiseLearner = new NoiseLearner();
+    _noiseLearner->resize(_bufferSize/2 + 1);
+    _noiseLearner->setFrameRate(_sampleRate*_overlap/_bufferSize);
+    
+    _nativeNoiseSampleRate = 0.0;
     
 #if USE_AUTO_RES_NOISE
     _softMasking = new WienerSoftMasking(bufferSize, overlap,
                                          SOFT_MASKING_HISTO_SIZE);
 #endif
     
-    resetResNoiseHistory();
+    resetResNoiseHistory(_bufferSize/2 + 1);
 
     _newCurvesAvailable = false;
 }
@@ -82,6 +90,8 @@ DenoiserProcessor::~DenoiserProcessor()
     if (_softMasking != NULL)
         delete _softMasking;
 #endif
+
+    delete _noiseLearner;
 }
 
 void
@@ -92,8 +102,13 @@ DenoiserProcessor::reset(int bufferSize, int overlap, float sampleRate)
     _sampleRate = sampleRate;
     
     resampleNoiseCurve();
+
+    // Keep the statistics if only the overlap changed
+    if (_noiseLearner->getNumBins() != _bufferSize/2 + 1)
+        _noiseLearner->resize(_bufferSize/2 + 1);
+    _noiseLearner->setFrameRate(_sampleRate*_overlap/_bufferSize);
     
-    resetResNoiseHistory();
+    resetResNoiseHistory(_bufferSize/2 + 1);
     
 #if USE_AUTO_RES_NOISE
     _softMasking->reset(bufferSize, overlap);
@@ -115,18 +130,22 @@ DenoiserProcessor::setThreshold(float threshold)
 }
 
 void
-DenoiserProcessor::processFFT(vector<complex<float> > *ioBuffer)
+DenoiserProcessor::processFrame(FrameContext *ioFrame)
 {
+    Profiler::ScopedTimer timer(Profiler::STAGE_DENOISER_PROCESS_FFT);
+
+    SplitSpectrum *ioSpectrum = ioFrame->getSpectrum();
+    
     // Add noise statistics
+    // (from the magnitudes, which are computed only once per hop)
     if (_isBuildingNoiseStatistics)
-        addNoiseStatistics(*ioBuffer);
+        addNoiseStatistics(ioSpectrum->getMagns());
     
     vector<float> &sigMagns = _tmpBuf0;
     vector<float> &sigPhases = _tmpBuf1;
-    Utils::complexToMagnPhase(&sigMagns, &sigPhases, *ioBuffer);
+    sigMagns = ioSpectrum->getMagns();
+    sigPhases = ioSpectrum->getPhases();
 
-    vector<float> inputMagns = sigMagns;
-    
     _signalBuf = sigMagns;
     
     vector<float> &noiseMagns = _tmpBuf2;
@@ -140,7 +159,7 @@ DenoiserProcessor::processFFT(vector<complex<float> > *ioBuffer)
         Utils::fillZero(&noiseMagns);
     }
     
-    if (!_isBuildingNoiseStatistics && (_noiseCurve.size() == ioBuffer->size()))
+    if (!_isBuildingNoiseStatistics && (_noiseCurve.size() == ioSpectrum->getNumBins()))
         threshold(&sigMagns, &noiseMagns);
     
 #if USE_RESIDUAL_DENOISE
@@ -161,7 +180,7 @@ DenoiserProcessor::processFFT(vector<complex<float> > *ioBuffer)
         autoResidualDenoise(&sigMagns, &sigPhases, noiseMagns);
 #endif
 
-    vector<float> resultMagns;
+    vector<float> &resultMagns = _tmpBuf25;
     resultMagns.resize(sigMagns.size());
 
     // Apply ratio
@@ -174,7 +193,9 @@ DenoiserProcessor::processFFT(vector<complex<float> > *ioBuffer)
 
     _noiseBuf = noiseMagns;
     
-    Utils::magnPhaseToComplex(ioBuffer, resultMagns, sigPhases);
+    // Converted to complex only if necessary
+    // (the next processors can use the magnitudes and phases)
+    ioSpectrum->setMagnsPhases(resultMagns, sigPhases);
 
     _newCurvesAvailable = true;
 }
@@ -199,30 +220,33 @@ DenoiserProcessor::setBuildingNoiseStatistics(bool flag)
         _noiseCurve.resize(_bufferSize/2 + 1);
         for (int i = 0; i < _noiseCurve.size(); i++)
             _noiseCurve[i] = DEFAULT_VALUE_SIGNAL;
+
+        _noiseLearner->clear();
     }
 
     _isBuildingNoiseStatistics = flag;
 }
 
 void
-DenoiserProcessor::addNoiseStatistics(const vector<complex<float> > &buf)
+DenoiserProcessor::addNoiseStatistics(const vector<float> &magns)
 {
-    // Add the sample to temp noise curve
-    vector<float> &noiseCurve = _tmpBuf4;
-    noiseCurve.resize(buf.size());
-    
-    for (int i = 0; i < buf.size(); i++)
-    {
-        float magn = abs(buf[i]);
-        
-        noiseCurve[i] = magn;
-    }
-
-    for (int i = 0; i < _noiseCurve.size(); i++)
-        _noiseCurve[i] =
-            NOISE_CURVE_SMOOTH_COEFF*_noiseCurve[i] + (1.0 - NOISE_CURVE_SMOOTH_COEFF)*noiseCurve[i];
+    _noiseLearner->addFrame(magns.data(), magns.size());
+    _noiseLearner->getNoiseCurve(&_noiseCurve);
     
     _nativeNoiseCurve = _noiseCurve;
+    _nativeNoiseSampleRate = _sampleRate;
+}
+
+void
+DenoiserProcessor::clearNoiseStatistics()
+{
+    _noiseLearner->clear();
+}
+
+void
+DenoiserProcessor::setNoiseLearnMethod(int method)
+{
+    _noiseLearner->setMethod((NoiseLearner::Method)method);
 }
 
 void
@@ -243,16 +267,29 @@ DenoiserProcessor::getNativeNoiseCurve(vector<float> *noiseCurve)
     *noiseCurve = _nativeNoiseCurve;
 }
 
+float
+DenoiserProcessor::getNativeNoiseSampleRate()
+{
+    return _nativeNoiseSampleRate;
+}
+
 void
-DenoiserProcessor::setNativeNoiseCurve(const vector<float> &noiseCurve)
+DenoiserProcessor::setNativeNoiseCurve(const vector<float> &noiseCurve, float sampleRate)
 {
     _nativeNoiseCurve = noiseCurve;
+    _nativeNoiseSampleRate = sampleRate;
     
     resampleNoiseCurve();
 
     _newCurvesAvailable = true;
 }
 
+void
+DenoiserProcessor::reserveNativeNoiseCurve(int maxNumBins)
+{
+    _nativeNoiseCurve.reserve(maxNumBins);
+}
+
 void
 DenoiserProcessor::setResNoiseThrs(float threshold)
 {
@@ -268,6 +305,13 @@ DenoiserProcessor::setAutoResNoise(bool flag)
     if (_softMasking != NULL)
         _softMasking->setProcessingEnabled(_autoResNoise);
 }
+
+void
+DenoiserProcessor::setSoftMaskingLookahead(int lookahead)
+{
+    if (_softMasking != NULL)
+        _softMasking->setLookahead(lookahead);
+}
 #endif
 
 void
@@ -312,27 +356,16 @@ DenoiserProcessor::getLatency()
 }
 
 void
-DenoiserProcessor::resetResNoiseHistory()
+DenoiserProcessor::resetResNoiseHistory(int numBins)
 {
-    _historyFftBufs.unfreeze();
-    _historyFftBufs.clear();
+    // Filled with zeros
+    _historyFftBufs.resize(RES_NOISE_HISTORY_SIZE, numBins);
+    _historyFftNoiseBufs.resize(RES_NOISE_HISTORY_SIZE, numBins);
+    _historyPhases.resize(RES_NOISE_HISTORY_SIZE, numBins);
 
-    _historyFftNoiseBufs.unfreeze();
-    _historyFftNoiseBufs.clear();
-
-    _historyPhases.unfreeze();
-    _historyPhases.clear();
-    
-    vector<float> &zeroBuf = _tmpBuf5;
-    zeroBuf.resize(_bufferSize/2 + 1);
-    Utils::fillZero(&zeroBuf);
-    
-    for (int i = 0; i < RES_NOISE_HISTORY_SIZE; i++)
-    {
-        _historyFftBufs.push_back(zeroBuf);
-        _historyFftNoiseBufs.push_back(zeroBuf);
-        _historyPhases.push_back(zeroBuf);
-    }
+    _resNoiseLogLines.resize(RES_NOISE_HISTORY_SIZE, numBins);
+    _resNoiseDBLines.resize(RES_NOISE_HISTORY_SIZE, numBins);
+    _resNoiseNumNewLines = RES_NOISE_HISTORY_SIZE;
 }
 
 void
@@ -340,61 +373,37 @@ DenoiserProcessor::residualDenoise(vector<float> *signalBuffer,
                                    vector<float> *noiseBuffer,
                                    vector<float> *phases)
 {
+    Profiler::ScopedTimer timer(Profiler::STAGE_RESIDUAL_DENOISE);
+    
     // Make an history which represents the spectrum of the signal
     // Then filter noise by a simple 2d filter, to suppress the residual noise
+
+    int width = signalBuffer->size();
+    if (_historyFftBufs.getWidth() != width)
+        // Should not happen, the history is reset with the buffer size
+        resetResNoiseHistory(width);
     
-    // Fill the queue with signal buffer
-    if (_historyFftBufs.size() != RES_NOISE_HISTORY_SIZE)
-    {
-        _historyFftBufs.push_back(*signalBuffer);
-        if (_historyFftBufs.size() > RES_NOISE_HISTORY_SIZE)
-            _historyFftBufs.pop_front();
-        if (_historyFftBufs.size() < RES_NOISE_HISTORY_SIZE)
-            return;
-    }
-    else
-    {
-        _historyFftBufs.freeze();
-        _historyFftBufs.push_pop(*signalBuffer);
-    }
-    
-    // Fill the queue with noise buffer
-    if (_historyFftNoiseBufs.size() != RES_NOISE_HISTORY_SIZE)
-    {
-        _historyFftNoiseBufs.push_back(*noiseBuffer);
-        if (_historyFftNoiseBufs.size() > RES_NOISE_HISTORY_SIZE)
-            _historyFftNoiseBufs.pop_front();
-        if (_historyFftNoiseBufs.size() < RES_NOISE_HISTORY_SIZE)
-            return;
-    }
-    else
-    {
-        _historyFftNoiseBufs.freeze();
-        _historyFftNoiseBufs.push_pop(*noiseBuffer);
-    }
-    
-    // Fill the queue with signal buffer
-    if (_historyPhases.size() != RES_NOISE_HISTORY_SIZE)
-    {
-        _historyPhases.push_back(*phases);
-        if (_historyPhases.size() > RES_NOISE_HISTORY_SIZE)
-            _historyPhases.pop_front();
-        if (_historyPhases.size() < RES_NOISE_HISTORY_SIZE)
-            return;
-    }
-    else
-    {
-        _historyPhases.freeze();
-        _historyPhases.push_pop(*phases);
-    }
+    // Fill the histories, the new lines replace the oldest ones
+    _historyFftBufs.pushLine(signalBuffer->data());
+    _historyFftNoiseBufs.pushLine(noiseBuffer->data());
+    _historyPhases.pushLine(phases->data());
+
+    // The lines of the image are converted later, if necessary
+    _resNoiseLogLines.pushLine();
+    _resNoiseDBLines.pushLine();
+    if (_resNoiseNumNewLines < RES_NOISE_HISTORY_SIZE)
+        _resNoiseNumNewLines++;
     
     // For latency
     if ((_resNoiseThrs < RESIDUAL_DENOISE_EPS) && !_autoResNoise)
     {
-        *signalBuffer = _historyFftBufs[RES_NOISE_LINE_NUM];
-        *phases = _historyPhases[RES_NOISE_LINE_NUM];
+        memcpy(signalBuffer->data(), _historyFftBufs.getLine(RES_NOISE_LINE_NUM),
+               width*sizeof(float));
+        memcpy(phases->data(), _historyPhases.getLine(RES_NOISE_LINE_NUM),
+               width*sizeof(float));
         
-        *noiseBuffer = _historyFftNoiseBufs[RES_NOISE_LINE_NUM];
+        memcpy(noiseBuffer->data(), _historyFftNoiseBufs.getLine(RES_NOISE_LINE_NUM),
+               width*sizeof(float));
         
         return;
     }
@@ -405,27 +414,12 @@ DenoiserProcessor::residualDenoise(vector<float> *signalBuffer,
         return;
 #endif
     
-    // Prepare for non filtering
-    int width = signalBuffer->size();
-    
     // In the history, we will take half of the values at each pass
     // This is to avoid shifts due to overlap that is 1/2
     int height = RES_NOISE_HISTORY_SIZE;
-    
-    samplesHistoryToImage(&_historyFftBufs, &_inputImageFilterChunk);
-    
 
-    
-    // Prepare the output buffer
-    if (_outputImageFilterChunk.size() != width*height)
-        _outputImageFilterChunk.resize(width*height);
-    
-    float *input = _inputImageFilterChunk.data();
-    float *output = _outputImageFilterChunk.data();
-    
-    // Just in case
-    for (int i = 0; i < width*height; i++)
-        output[i] = 0.0;
+    // Only the lines added since the last filtering are converted
+    updateResNoiseLines(width, height);
     
     // Filter the 2d image
     
@@ -433,24 +427,33 @@ DenoiserProcessor::residualDenoise(vector<float> *signalBuffer,
     
     if (_hanningKernel.size() != winSize*winSize)
         makeHanningKernel2D(winSize, &_hanningKernel);
+
+    vector<float> &outputLine = _tmpBuf26;
+    outputLine.resize(width);
     
-    noiseFilter(input, output, width, height, winSize, &_hanningKernel,
+    noiseFilter(outputLine.data(), width, height, winSize, _hanningKernel,
                 RES_NOISE_LINE_NUM, _resNoiseThrs);
-    
-    imageLineToSamples(&_outputImageFilterChunk, width, height, RES_NOISE_LINE_NUM,
-                       &_historyFftBufs, &_historyPhases,
-                       signalBuffer, phases);
+
+    // Back to magnitudes
+    for (int i = 0; i < width; i++)
+    {
+        float newMagn = exp(outputLine[i]) - 1.0;
+        if (newMagn < 0.0)
+            newMagn = 0.0;
+        
+        (*signalBuffer)[i] = newMagn;
+    }
     
     // Compute the noise part after residual denoise
-    vector<float> &histSignal = _historyFftBufs[RES_NOISE_LINE_NUM];
-    const vector<float> &histNoise =
-        _historyFftNoiseBufs[RES_NOISE_LINE_NUM];
+    const float *histSignal = _historyFftBufs.getLine(RES_NOISE_LINE_NUM);
+    const float *histNoise = _historyFftNoiseBufs.getLine(RES_NOISE_LINE_NUM);
     
-    *phases = _historyPhases[RES_NOISE_LINE_NUM];
+    memcpy(phases->data(), _historyPhases.getLine(RES_NOISE_LINE_NUM),
+           width*sizeof(float));
     
-    *noiseBuffer = histNoise;
+    memcpy(noiseBuffer->data(), histNoise, width*sizeof(float));
     
-    extractResidualNoise(&histSignal, signalBuffer, noiseBuffer);
+    extractResidualNoise(histSignal, signalBuffer, noiseBuffer);
 }
 
 void
@@ -458,6 +461,8 @@ DenoiserProcessor::autoResidualDenoise(vector<float> *ioSignalMagns,
                                        vector<float> *ioSignalPhases,
                                        const vector<float> &noiseMagns)
 {    
+    Profiler::ScopedTimer timer(Profiler::STAGE_AUTO_RESIDUAL_DENOISE);
+    
     // Recompute the complex buffer here
     // This is more safe than using the original comp buffer,
     // because some other operations may have delayed magns and phases
@@ -524,164 +529,166 @@ DenoiserProcessor::autoResidualDenoise(vector<float> *ioSignalMagns,
 }
 
 void
-DenoiserProcessor::noiseFilter(float *input, float *output, int width, int height,
-                               int winSize, vector<float> *kernel, int lineNum,
-                               float threshold)
+DenoiserProcessor::updateResNoiseLines(int width, int height)
 {
-#define MIN_THRESHOLD -200.0
-#define MAX_THRESHOLD 0.0
-
-    // Optimization: precompute db
-    vector<float> &inputDB = _tmpBuf24;
-    inputDB.resize(width*height);
-    Utils::ampToDB(inputDB.data(), input, inputDB.size(), 1e-15, (float)DENOISER_MIN_DB);
-    float *inputDBData = inputDB.data();
-    
-    // Process only one line (for optimization)
-    for (int j = lineNum; j < lineNum + 1; j++)
+    for (int j = height - _resNoiseNumNewLines; j < height; j++)
+        // Time
     {
+        const float *histBuf = _historyFftBufs.getLine(j);
+        float *logLine = _resNoiseLogLines.getLine(j);
+        
         for (int i = 0; i < width; i++)
+            // Bins
         {
-            float avg = 0.0;
-            float sum = 0.0;
-            
-            // By default, copy the input
-            int index0 = i + j*width;
-            
-            output[index0] = input[index0];
-            
-            float centerVal = input[index0];
-            
-            if (centerVal == 0.0)
-                // Nothing to test, the value is already 0
-                continue;
-            
-            int halfWinSize = winSize/2;
-            
-            for (int wi = -halfWinSize; wi <= halfWinSize; wi++)
-            {
-                for (int wj = -halfWinSize; wj <= halfWinSize; wj++)
-                {
-                    // When out of bounds, continue instead of round, to avoid taking the middle value
-                    int x = i + wi;
-                    if (x < 0)
-                        continue;
-                    if (x >= width)
-                        continue;
-                    
-                    int y = j + wj;
-                    if (y < 0)
-                        continue;
-                    if (y >= height)
-                        continue;
-
-                    // Use precomputed db values
-                    float val = inputDBData[x + y*width];
-                    
-                    float kernelVal = 1.0;
-                    if (kernel != NULL)
-                        kernelVal = (*kernel)[(wi + halfWinSize) + (wj + halfWinSize)*winSize];
-                    
-                    avg += val*kernelVal;
-                    sum += kernelVal;
-                }
-            }
-            
-            if (sum > 0.0)
-                avg /= sum;
+            float magn = histBuf[i];
             
-            float thrs = threshold*(MAX_THRESHOLD - MIN_THRESHOLD) + MIN_THRESHOLD;
+            // Take appropriate scale
+            float logMagn = log(1.0 + magn);
             
-            if (avg < thrs)
-                output[index0] = 0.0;
+            logLine[i] = logMagn;
         }
+
+        // Optimization: precompute db
+        Utils::ampToDB(_resNoiseDBLines.getLine(j), logLine, width,
+                       1e-15, (float)DENOISER_MIN_DB);
     }
+
+    _resNoiseNumNewLines = 0;
 }
 
 void
-DenoiserProcessor::samplesHistoryToImage(const bl_queue<vector<float> > *hist,
-                                         vector<float> *imageChunk)
+DenoiserProcessor::noiseFilter(float *output, int width, int height,
+                               int winSize, const vector<float> &kernel, int lineNum,
+                               float threshold)
 {
-    // Get the image dimensions
-    int height = (int)hist->size();
-    if (height < 1)
-    {
-        imageChunk->resize(0);
-        
-        return;
-    }
+#define MIN_THRESHOLD -200.0
+#define MAX_THRESHOLD 0.0
+
+    const float *logLine = _resNoiseLogLines.getLine(lineNum);
     
-    const vector<float> &hist0 = (*hist)[0];
-    int width = hist0.size();
+    float thrs = threshold*(MAX_THRESHOLD - MIN_THRESHOLD) + MIN_THRESHOLD;
     
-    imageChunk->resize(width*height);
+    int halfWinSize = winSize/2;
     
-    // Get the image buffer
-    float *imageBuf = imageChunk->data();
+    // Bins where the window is inside the image horizontally
+    int bin0 = (halfWinSize < width) ? halfWinSize : width;
+    int bin1 = width - halfWinSize;
+    if (bin1 < bin0)
+        bin1 = bin0;
+    int numBins = bin1 - bin0;
     
-    // Fill the image
-    for (int j = 0; j < height; j++)
-        // Time
+    // Weighted sums of the dB values, for all these bins at once,
+    // with one pass for each kernel value
+    // (same operations and order as computeNoiseFilterAvg(), so same results)
+    vector<float> &sums = _tmpBuf24;
+    sums.resize(numBins);
+    Utils::fillZero(&sums);
+    
+    float kernelSum = 0.0;
+    for (int wi = -halfWinSize; wi <= halfWinSize; wi++)
     {
-        const vector<float> &histBuf = (*hist)[j];
-        
-        for (int i = 0; i < width; i++)
-            // Bins
+        for (int wj = -halfWinSize; wj <= halfWinSize; wj++)
         {
-            float magn = histBuf[i];
-            
-            // Take appropriate scale
-            float logMagn = log(1.0 + magn);
+            int y = lineNum + wj;
+            if ((y < 0) || (y >= height))
+                continue;
             
-            imageBuf[i + j*width] = logMagn;
+            const float *dBLine = _resNoiseDBLines.getLine(y);
+            float kernelVal = kernel[(wi + halfWinSize) + (wj + halfWinSize)*winSize];
+
+            if (numBins > 0)
+                BufferKernels::addMultValue(sums.data(), &dBLine[bin0 + wi], kernelVal,
+                                            numBins);
+            kernelSum += kernelVal;
         }
     }
-}
 
-void
-DenoiserProcessor::imageLineToSamples(const vector<float> *image,
-                                      int width,
-                                      int height,
-                                      int lineNum,
-                                      const bl_queue<vector<float> > *hist,
-                                      const bl_queue<vector<float> > *phaseHist,
-                                      vector<float> *resultBuf,
-                                      vector<float> *resultPhases)
-{
-    if (lineNum >= height)
-        return;
-    
-    if (lineNum >= resultBuf->size())
-        return;
-    
-    const vector<float> &histLine = (*hist)[lineNum];
-    const vector<float> &phaseLine = (*phaseHist)[lineNum];
-    
-    *resultBuf = histLine;
-    *resultPhases = phaseLine;
-    
-    // Process
-    for (int i = 0; i < width; i++)
+    for (int i = bin0; i < bin1; i++)
     {
-        // Take the most recent
-        float logMagn = (*image)[i + width*lineNum];
+        // By default, copy the input
+        output[i] = logLine[i];
+
+        if (logLine[i] == 0.0)
+            // Nothing to test, the value is already 0
+            continue;
         
-        float newMagn = exp(logMagn) - 1.0;
-        if (newMagn < 0.0)
-            newMagn = 0.0;
+        float avg = sums[i - bin0];
+        if (kernelSum > 0.0)
+            avg /= kernelSum;
+        
+        if (avg < thrs)
+            output[i] = 0.0;
+    }
+
+    // Edges, where the window is partially outside the image
+    for (int i = 0; i < width; i++)
+    {
+        if ((i >= bin0) && (i < bin1))
+            continue;
+
+        output[i] = logLine[i];
+
+        if (logLine[i] == 0.0)
+            continue;
+
+        float avg = computeNoiseFilterAvg(i, width, height, winSize, kernel, lineNum);
         
-        (*resultBuf)[i] = newMagn;
+        if (avg < thrs)
+            output[i] = 0.0;
+    }
+}
+
+float
+DenoiserProcessor::computeNoiseFilterAvg(int binNum, int width, int height,
+                                         int winSize, const vector<float> &kernel,
+                                         int lineNum)
+{
+    float avg = 0.0;
+    float sum = 0.0;
+    
+    int halfWinSize = winSize/2;
+            
+    for (int wi = -halfWinSize; wi <= halfWinSize; wi++)
+    {
+        for (int wj = -halfWinSize; wj <= halfWinSize; wj++)
+        {
+            // When out of bounds, continue instead of round, to avoid taking the middle value
+            int x = binNum + wi;
+            if (x < 0)
+                continue;
+            if (x >= width)
+                continue;
+                    
+            int y = lineNum + wj;
+            if (y < 0)
+                continue;
+            if (y >= height)
+                continue;
+
+            // Use precomputed db values
+            float val = _resNoiseDBLines.getLine(y)[x];
+                    
+            float kernelVal = kernel[(wi + halfWinSize) + (wj + halfWinSize)*winSize];
+                    
+            avg += val*kernelVal;
+            sum += kernelVal;
+        }
     }
+            
+    if (sum > 0.0)
+        avg /= sum;
+
+    return avg;
 }
 
 void
-DenoiserProcessor::extractResidualNoise(const vector<float> *prevSignal,
+DenoiserProcessor::extractResidualNoise(const float *prevSignal,
                                         const vector<float> *signal,
                                         vector<float> *ioNoise)
 {
     for (int i = 0; i < ioNoise->size(); i++)
     {
-        float prevMagn = (*prevSignal)[i];
+        float prevMagn = prevSignal[i];
         float magn = (*signal)[i];
         float noiseMagn = (*ioNoise)[i];
         
@@ -747,9 +754,71 @@ DenoiserProcessor::applyThresholdValueToNoiseCurve(vector<float> *ioNoiseCurve,
 void
 DenoiserProcessor::resampleNoiseCurve()
 {
-    _noiseCurve = _nativeNoiseCurve;
+    int numBins = _bufferSize/2 + 1;
+    int numNativeBins = _nativeNoiseCurve.size();
+    
+    float nativeSampleRate = _nativeNoiseSampleRate;
+    if (nativeSampleRate <= 0.0)
+        nativeSampleRate = _sampleRate;
     
-    Utils::resizeFillZeros(&_noiseCurve, _bufferSize/2 + 1);
+    if ((numNativeBins < 2) ||
+        ((numNativeBins == numBins) && (nativeSampleRate == _sampleRate)))
+    {
+        _noiseCurve = _nativeNoiseCurve;
+        Utils::resizeFillZeros(&_noiseCurve, numBins);
+        
+        return;
+    }
+
+    int nativeBufferSize = (numNativeBins - 1)*2;
+    
+    // Native bin for each bin, at the same frequency
+    float binRatio = (((float)nativeBufferSize)/_bufferSize)*(_sampleRate/nativeSampleRate);
+
+    // The analysis window is normalized for sines, so the magnitude of
+    // a broadband noise is proportional to 1/sqrt(bufferSize)
+    float magnCoeff = sqrt(((float)nativeBufferSize)/_bufferSize);
+    
+    _noiseCurve.resize(numBins);
+    for (int i = 0; i < numBins; i++)
+    {
+        float pos = i*binRatio;
+
+        // Above the native Nyquist, we know nothing about the noise
+        if (pos > numNativeBins - 1)
+        {
+            _noiseCurve[i] = 0.0;
+            continue;
+        }
+
+        float magn;
+        if (binRatio <= 1.0)
+        {
+            // Interpolate
+            int i0 = (int)pos;
+            int i1 = (i0 + 1 < numNativeBins) ? i0 + 1 : i0;
+            float t = pos - i0;
+            
+            magn = (1.0 - t)*_nativeNoiseCurve[i0] + t*_nativeNoiseCurve[i1];
+        }
+        else
+        {
+            // Average the native bins covered by this bin
+            int i0 = (int)ceil(pos - binRatio*0.5);
+            int i1 = (int)floor(pos + binRatio*0.5);
+            if (i0 < 0)
+                i0 = 0;
+            if (i1 > numNativeBins - 1)
+                i1 = numNativeBins - 1;
+
+            magn = 0.0;
+            for (int j = i0; j <= i1; j++)
+                magn += _nativeNoiseCurve[j];
+            magn /= (i1 - i0 + 1);
+        }
+
+        _noiseCurve[i] = magn*magnCoeff;
+    }
 }
 
 void
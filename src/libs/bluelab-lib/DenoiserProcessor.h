@@ -19,12 +19,13 @@
 #ifndef DENOISER_PROCESSOR_H
 #define DENOISER_PROCESSOR_H
 
-#include "bl_queue.h"
+#include "RingBuffer2D.h"
 #include "OverlapAdd.h"
 
 #define USE_AUTO_RES_NOISE 1
 
 class WienerSoftMasking;
+class NoiseLearner;
 class DenoiserProcessor : public OverlapAddProcessor
 {
 public:
@@ -32,7 +33,7 @@ public:
     
     virtual ~DenoiserProcessor();
 
-    void processFFT(vector<complex<float> > *ioBuffer) override;
+    void processFrame(FrameContext *ioFrame) override;
     
     void reset(int bufferSize, int overlap, float sampleRate);
 
@@ -47,19 +48,36 @@ public:
     // Noise capture
     void setBuildingNoiseStatistics(bool flag);
     
-    void addNoiseStatistics(const vector<complex<float> > &buf);
+    void addNoiseStatistics(const vector<float> &magns);
+
+    // Restart the learning, e.g when another profile is selected
+    void clearNoiseStatistics();
+    
+    // NoiseLearner::Method (the learning restarts if it changed)
+    void setNoiseLearnMethod(int method);
     
     void getNoiseCurve(vector<float> *noiseCurve);
     void setNoiseCurve(const vector<float> &noiseCurve);
     
     // Used for serialization
+    // The native curve is kept at the size and sample rate where it was learned,
+    // and resampled to the current buffer size
+    // sampleRate: 0 if unknown (then the current sample rate is used)
     void getNativeNoiseCurve(vector<float> *noiseCurve);
-    void setNativeNoiseCurve(const vector<float> &noiseCurve);
+    float getNativeNoiseSampleRate();
+    void setNativeNoiseCurve(const vector<float> &noiseCurve, float sampleRate = 0.0);
+
+    // So that setting a native curve up to this size doesn't allocate
+    void reserveNativeNoiseCurve(int maxNumBins);
     
     void setResNoiseThrs(float threshold);
 
 #if USE_AUTO_RES_NOISE
     void setAutoResNoise(bool autoResNoiseFlag);
+
+    // Number of future frames used by the soft masking
+    // (WienerSoftMasking::LOOKAHEAD_CENTERED, or 0 for no added latency)
+    void setSoftMaskingLookahead(int lookahead);
 #endif
 
     void setRatio(float ratio);
@@ -77,7 +95,8 @@ protected:
     
     // Residual denoise
     
-    void resetResNoiseHistory();
+    // Filled with zeros
+    void resetResNoiseHistory(int numBins);
     
     // Must keep and manage the phases
     // (there is an history, and we must have synchronous phases)
@@ -91,26 +110,22 @@ protected:
                              const vector<float> &noiseMagns);
 #endif
     
-    // Kernel can be NULL
-    void noiseFilter(float *input, float *output, int width, int height,
-                     int winSize, vector<float> *kernel, int lineNum,
+    // Convert the new lines of the signal history to log and dB
+    // (the image of the filter)
+    void updateResNoiseLines(int width, int height);
+    
+    // Filter one line of the image, output in log scale
+    void noiseFilter(float *output, int width, int height,
+                     int winSize, const vector<float> &kernel, int lineNum,
                      float threshold);
+
+    // Weighted average of the dB values around one bin,
+    // with the window partially outside the image
+    float computeNoiseFilterAvg(int binNum, int width, int height,
+                                int winSize, const vector<float> &kernel,
+                                int lineNum);
     
-    // Take an fft buffer history and transform it to an image
-    void samplesHistoryToImage(const bl_queue<vector<float> > *hist,
-                               vector<float> *imageChunk);
-    
-    // Take an image and extract one line
-    // Fill an Fft buffer
-    // Take the phases from the history
-    void imageLineToSamples(const vector<float> *image,
-                            int width, int height, int lineNum,
-                            const bl_queue<vector<float> > *hist,
-                            const bl_queue<vector<float> > *phaseHist,
-                            vector<float> *resultBuf,
-                            vector<float> *resultPhases);
-    
-    void extractResidualNoise(const vector<float> *prevSignal,
+    void extractResidualNoise(const float *prevSignal,
                               const vector<float> *signal,
                               vector<float> *ioNoise);
     
@@ -144,20 +159,28 @@ protected:
     
     // Noise capture
     bool _isBuildingNoiseStatistics;
+    NoiseLearner *_noiseLearner;
     
     vector<float> _noiseCurve;
     
     // Used to keep original noise curve if need to rescale
     vector<float> _nativeNoiseCurve;
+    float _nativeNoiseSampleRate;
     
     // Residual denoise
     
-    bl_queue<vector<float> > _historyFftBufs;
-    bl_queue<vector<float> > _historyFftNoiseBufs;
-    bl_queue<vector<float> > _historyPhases;
+    // History x bins
+    RingBuffer2D<float> _historyFftBufs;
+    RingBuffer2D<float> _historyFftNoiseBufs;
+    RingBuffer2D<float> _historyPhases;
     
-    vector<float> _inputImageFilterChunk;
-    vector<float> _outputImageFilterChunk;
+    // Image of the residual noise filter: log(1 + magn), and its dB,
+    // for each line of the signal history
+    // Same lines as the history, so only the new line is converted at each hop
+    RingBuffer2D<float> _resNoiseLogLines;
+    RingBuffer2D<float> _resNoiseDBLines;
+    // Number of most recent lines not converted yet
+    int _resNoiseNumNewLines;
     
     vector<float> _hanningKernel;
 
@@ -169,8 +192,6 @@ private:
     vector<float> _tmpBuf1;
     vector<float> _tmpBuf2;
     vector<float> _tmpBuf3;
-    vector<float> _tmpBuf4;
-    vector<float> _tmpBuf5;
     vector<float> _tmpBuf6;
     vector<complex<float> > _tmpBuf7;
     
@@ -188,6 +209,8 @@ private:
     vector<complex<float> > _tmpBuf22;
     vector<complex<float> > _tmpBuf23;
     vector<float> _tmpBuf24;
+    vector<float> _tmpBuf25;
+    vector<float> _tmpBuf26;
 };
 
 #endif
@@ -0,0 +1,145 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <juce_core/juce_core.h>
+
+#include "FftEngineJuce.h"
+#include "FftEngineFFTW.h"
+
+#include "FftEngine.h"
+
+FftEngine::Backend FftEngine::_defaultBackend = FftEngine::AUTO;
+
+FftEngine::FftEngine(int fftSize)
+{
+    _fftSize = fftSize;
+}
+
+FftEngine::~FftEngine() {}
+
+int
+FftEngine::getFftSize() const
+{
+    return _fftSize;
+}
+
+std::unique_ptr<FftEngine>
+FftEngine::create(Backend backend, int fftSize)
+{
+    if (backend == AUTO)
+        backend = BL_FFT_USE_FFTW ? FFTW : JUCE;
+    
+#if BL_FFT_USE_FFTW
+    if (backend == FFTW)
+        return std::make_unique<FftEngineFFTW>(fftSize);
+#endif
+
+    // Fallback
+    return std::make_unique<FftEngineJuce>(fftSize);
+}
+
+bool
+FftEngine::isBackendAvailable(Backend backend)
+{
+    if (backend == FFTW)
+        return BL_FFT_USE_FFTW;
+
+    return true;
+}
+
+const char *
+FftEngine::getBackendName(Backend backend)
+{
+    switch(backend)
+    {
+        case JUCE:
+            return "JUCE";
+        case FFTW:
+            return "FFTW";
+        case AUTO:
+            return "Auto";
+        default:
+            break;
+    }
+
+    return "";
+}
+
+void
+FftEngine::setDefaultBackend(Backend backend)
+{
+    _defaultBackend = backend;
+}
+
+FftEngine::Backend
+FftEngine::getDefaultBackend()
+{
+    return _defaultBackend;
+}
+
+double
+FftEngine::benchmark(Backend backend, int fftSize, int numTransforms)
+{
+    std::unique_ptr<FftEngine> engine = create(backend, fftSize);
+
+    vector<float> samples;
+    samples.resize(fftSize);
+    juce::Random random(0);
+    for (int i = 0; i < samples.size(); i++)
+        samples[i] = random.nextFloat()*2.0 - 1.0;
+
+    vector<complex<float> > spectrum;
+    spectrum.resize(fftSize/2 + 1);
+
+    // Warm up
+    engine->forward(samples.data(), spectrum.data());
+    engine->inverse(spectrum.data(), samples.data());
+    
+    juce::int64 t0 = juce::Time::getHighResolutionTicks();
+    for (int i = 0; i < numTransforms; i++)
+    {
+        engine->forward(samples.data(), spectrum.data());
+        engine->inverse(spectrum.data(), samples.data());
+    }
+    juce::int64 t1 = juce::Time::getHighResolutionTicks();
+
+    double seconds = juce::Time::highResolutionTicksToSeconds(t1 - t0);
+    
+    return seconds*1e9/(2.0*numTransforms);
+}
+
+void
+FftEngine::benchmarkAll(FILE *file, int numTransforms)
+{
+    // From the smallest resolution of the plugins, to 192000Hz
+    static const int fftSizes[] = { 512, 1024, 2048, 4096, 8192 };
+    static const Backend backends[] = { JUCE, FFTW };
+    
+    for (int i = 0; i < sizeof(fftSizes)/sizeof(int); i++)
+    {
+        for (int j = 0; j < sizeof(backends)/sizeof(Backend); j++)
+        {
+            if (!isBackendAvailable(backends[j]))
+                continue;
+            
+            double ns = benchmark(backends[j], fftSizes[i], numTransforms);
+            fprintf(file, "%s fftSize: %d - %.0f ns/transform\n",
+                    getBackendName(backends[j]), fftSizes[i], ns);
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FFT_ENGINE_H
+#define FFT_ENGINE_H
+
+#include <stdio.h>
+
+#include <vector>
+#include <complex>
+#include <memory>
+using namespace std;
+
+// The FFTW backend is available if fftw3f is linked (see the jucer defines)
+#ifndef BL_FFT_USE_FFTW
+#if AUDIOFFT_FFTW3
+#define BL_FFT_USE_FFTW 1
+#else
+#define BL_FFT_USE_FFTW 0
+#endif
+#endif
+
+// Real fft of power of two size
+//
+// The spectrum has fftSize/2 + 1 bins, in vector<complex<float> > layout
+// Forward transform is not normalized, inverse transform is scaled by 1/fftSize
+// (same convention as juce::dsp::FFT)
+class FftEngine
+{
+public:
+    enum Backend
+    {
+        JUCE = 0,
+        FFTW,
+        // FFTW if available, JUCE otherwise
+        AUTO
+    };
+    
+    FftEngine(int fftSize);
+    virtual ~FftEngine();
+
+    int getFftSize() const;
+    
+    virtual const char *getName() const = 0;
+    
+    // output: fftSize/2 + 1 bins
+    virtual void forward(const float *input, complex<float> *output) = 0;
+
+    // input: fftSize/2 + 1 bins
+    // scale: additional gain, applied in the same pass as the 1/fftSize scaling
+    virtual void inverse(const complex<float> *input, float *output,
+                         float scale = 1.0) = 0;
+
+    // Factory
+    static std::unique_ptr<FftEngine> create(Backend backend, int fftSize);
+    
+    static bool isBackendAvailable(Backend backend);
+    static const char *getBackendName(Backend backend);
+
+    // Backend used by default when creating OverlapAdd objects
+    static void setDefaultBackend(Backend backend);
+    static Backend getDefaultBackend();
+    
+    // Return the mean time of one transform, in nanoseconds
+    // (average of forward and inverse)
+    static double benchmark(Backend backend, int fftSize, int numTransforms = 1000);
+
+    // Print the time of each available backend, for each fft size used by the plugins
+    static void benchmarkAll(FILE *file, int numTransforms = 1000);
+    
+protected:
+    int _fftSize;
+
+    static Backend _defaultBackend;
+};
+
+#endif
@@ -0,0 +1,142 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+
+#include "FftEngineFFTW.h"
+
+#if BL_FFT_USE_FFTW
+
+std::mutex FftEngineFFTW::_planMutex;
+string FftEngineFFTW::_wisdomFileName;
+bool FftEngineFFTW::_wisdomLoaded = false;
+
+FftEngineFFTW::FftEngineFFTW(int fftSize)
+: FftEngine(fftSize)
+{
+    _realBuf = fftwf_alloc_real(fftSize);
+    _compBuf = fftwf_alloc_complex(fftSize/2 + 1);
+
+    memset(_realBuf, 0, fftSize*sizeof(float));
+    memset(_compBuf, 0, (fftSize/2 + 1)*sizeof(fftwf_complex));
+    
+    _realAlignment = fftwf_alignment_of(_realBuf);
+    _compAlignment = fftwf_alignment_of((float *)_compBuf);
+    
+    std::lock_guard<std::mutex> lock(_planMutex);
+
+    unsigned int flags = FFTW_ESTIMATE;
+    if (!_wisdomFileName.empty())
+    {
+        loadWisdom();
+        
+        flags = FFTW_MEASURE;
+    }
+    
+    _forwardPlan = fftwf_plan_dft_r2c_1d(fftSize, _realBuf, _compBuf, flags);
+    _inversePlan = fftwf_plan_dft_c2r_1d(fftSize, _compBuf, _realBuf, flags);
+
+    if (!_wisdomFileName.empty())
+        saveWisdom();
+}
+
+FftEngineFFTW::~FftEngineFFTW()
+{
+    std::lock_guard<std::mutex> lock(_planMutex);
+    
+    fftwf_destroy_plan(_forwardPlan);
+    fftwf_destroy_plan(_inversePlan);
+
+    fftwf_free(_realBuf);
+    fftwf_free(_compBuf);
+}
+
+const char *
+FftEngineFFTW::getName() const
+{
+    return "FFTW";
+}
+
+void
+FftEngineFFTW::forward(const float *input, complex<float> *output)
+{
+    // Out of place r2c preserves the input
+    float *in = (float *)input;
+    fftwf_complex *out = (fftwf_complex *)output;
+
+    if ((fftwf_alignment_of(in) == _realAlignment) &&
+        (fftwf_alignment_of((float *)out) == _compAlignment))
+    {
+        fftwf_execute_dft_r2c(_forwardPlan, in, out);
+
+        return;
+    }
+
+    memcpy(_realBuf, input, _fftSize*sizeof(float));
+    fftwf_execute(_forwardPlan);
+    memcpy(output, _compBuf, (_fftSize/2 + 1)*sizeof(fftwf_complex));
+}
+
+void
+FftEngineFFTW::inverse(const complex<float> *input, float *output, float scale)
+{
+    // c2r destroys the input, so always work on a copy
+    memcpy(_compBuf, input, (_fftSize/2 + 1)*sizeof(fftwf_complex));
+
+    if (fftwf_alignment_of(output) == _realAlignment)
+        fftwf_execute_dft_c2r(_inversePlan, _compBuf, output);
+    else
+    {
+        fftwf_execute(_inversePlan);
+        memcpy(output, _realBuf, _fftSize*sizeof(float));
+    }
+
+    // fftw does not normalize
+    float coeff = scale/_fftSize;
+    for (int i = 0; i < _fftSize; i++)
+        output[i] *= coeff;
+}
+
+void
+FftEngineFFTW::setWisdomFileName(const char *fileName)
+{
+    std::lock_guard<std::mutex> lock(_planMutex);
+    
+    _wisdomFileName = fileName;
+    _wisdomLoaded = false;
+}
+
+void
+FftEngineFFTW::loadWisdom()
+{
+    if (_wisdomLoaded)
+        return;
+    
+    // The file may not exist yet
+    fftwf_import_wisdom_from_filename(_wisdomFileName.c_str());
+    
+    _wisdomLoaded = true;
+}
+
+void
+FftEngineFFTW::saveWisdom()
+{
+    fftwf_export_wisdom_to_filename(_wisdomFileName.c_str());
+}
+
+#endif
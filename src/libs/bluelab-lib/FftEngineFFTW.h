@@ -0,0 +1,76 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FFT_ENGINE_FFTW_H
+#define FFT_ENGINE_FFTW_H
+
+#include "FftEngine.h"
+
+#if BL_FFT_USE_FFTW
+
+#include <mutex>
+#include <string>
+
+#include <fftw3.h>
+
+// Planned real-to-complex / complex-to-real fftw3f transforms
+//
+// The plans are created in the constructor, so engines should not be created
+// from the audio thread
+class FftEngineFFTW : public FftEngine
+{
+public:
+    FftEngineFFTW(int fftSize);
+    virtual ~FftEngineFFTW();
+
+    const char *getName() const override;
+    
+    void forward(const float *input, complex<float> *output) override;
+    void inverse(const complex<float> *input, float *output,
+                 float scale = 1.0) override;
+
+    // If a wisdom file is set, the plans are measured (slower to create,
+    // faster to run), and the wisdom is loaded from and saved to this file
+    // Set it before creating the engines. Empty name to disable
+    static void setWisdomFileName(const char *fileName);
+    
+protected:
+    void loadWisdom();
+    void saveWisdom();
+    
+    fftwf_plan _forwardPlan;
+    fftwf_plan _inversePlan;
+
+    // Buffers the plans were made for
+    float *_realBuf;
+    fftwf_complex *_compBuf;
+
+    // If the user buffers have the same alignment, we execute directly on them
+    int _realAlignment;
+    int _compAlignment;
+    
+    // fftw planner is not thread safe
+    static std::mutex _planMutex;
+
+    static string _wisdomFileName;
+    static bool _wisdomLoaded;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,60 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "FftEngineJuce.h"
+
+FftEngineJuce::FftEngineJuce(int fftSize)
+: FftEngine(fftSize), _fft(log2(fftSize))
+{
+    _tmpBuf.resize(fftSize*2);
+}
+
+FftEngineJuce::~FftEngineJuce() {}
+
+const char *
+FftEngineJuce::getName() const
+{
+    return "JUCE";
+}
+
+void
+FftEngineJuce::forward(const float *input, complex<float> *output)
+{
+    memcpy(_tmpBuf.data(), input, _fftSize*sizeof(float));
+
+    _fft.performRealOnlyForwardTransform(_tmpBuf.data(), true);
+
+    // Interleaved real/imag is the same layout as complex<float>
+    memcpy((float *)output, _tmpBuf.data(), (_fftSize/2 + 1)*sizeof(complex<float>));
+}
+
+void
+FftEngineJuce::inverse(const complex<float> *input, float *output, float scale)
+{
+    memcpy(_tmpBuf.data(), input, (_fftSize/2 + 1)*sizeof(complex<float>));
+
+    _fft.performRealOnlyInverseTransform(_tmpBuf.data());
+
+    if (scale == 1.0)
+        memcpy(output, _tmpBuf.data(), _fftSize*sizeof(float));
+    else
+        juce::FloatVectorOperations::multiply(output, _tmpBuf.data(), scale, _fftSize);
+}
@@ -0,0 +1,46 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FFT_ENGINE_JUCE_H
+#define FFT_ENGINE_JUCE_H
+
+#include <juce_dsp/juce_dsp.h>
+
+#include "FftEngine.h"
+
+// Fallback backend, using juce::dsp::FFT
+class FftEngineJuce : public FftEngine
+{
+public:
+    FftEngineJuce(int fftSize);
+    virtual ~FftEngineJuce();
+
+    const char *getName() const override;
+    
+    void forward(const float *input, complex<float> *output) override;
+    void inverse(const complex<float> *input, float *output,
+                 float scale = 1.0) override;
+
+protected:
+    juce::dsp::FFT _fft;
+
+    // JUCE works in place, on a buffer of size 2*fftSize
+    vector<float> _tmpBuf;
+};
+
+#endif
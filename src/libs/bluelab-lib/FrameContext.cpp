@@ -0,0 +1,111 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "FrameContext.h"
+
+FrameContext::FrameContext()
+{
+    // The spectrum version starts at 0, so the features are never valid
+    // before they are computed
+    _fullMagnsPhasesVersion = (unsigned int)-1;
+}
+
+FrameContext::~FrameContext() {}
+
+void
+FrameContext::resize(int numBins)
+{
+    _spectrum.resize(numBins);
+
+    // Without the last bin
+    int fullSize = (numBins > 0) ? (numBins - 1)*2 : 0;
+    _fullMagns.resize(fullSize);
+    _fullPhases.resize(fullSize);
+}
+
+SplitSpectrum *
+FrameContext::getSpectrum()
+{
+    return &_spectrum;
+}
+
+int
+FrameContext::getNumBins() const
+{
+    return _spectrum.getNumBins();
+}
+
+const vector<float> &
+FrameContext::getMagns()
+{
+    return _spectrum.getMagns();
+}
+
+const vector<float> &
+FrameContext::getPhases()
+{
+    return _spectrum.getPhases();
+}
+
+const vector<float> &
+FrameContext::getFullMagns()
+{
+    updateFullMagnsPhases();
+
+    return _fullMagns;
+}
+
+const vector<float> &
+FrameContext::getFullPhases()
+{
+    updateFullMagnsPhases();
+
+    return _fullPhases;
+}
+
+void
+FrameContext::updateFullMagnsPhases()
+{
+    if (_fullMagnsPhasesVersion == _spectrum.getVersion())
+        return;
+    
+    const vector<float> &magns = _spectrum.getMagns();
+    const vector<float> &phases = _spectrum.getPhases();
+    int halfSize = _spectrum.getNumBins() - 1;
+
+    _fullMagnsPhasesVersion = _spectrum.getVersion();
+    
+    if (halfSize < 1)
+        return;
+    
+    for (int i = 0; i < halfSize; i++)
+    {
+        _fullMagns[i] = magns[i];
+        _fullPhases[i] = phases[i];
+    }
+
+    _fullMagns[halfSize] = 0.0;
+    _fullPhases[halfSize] = 0.0;
+    
+    for (int i = 1; i < halfSize; i++)
+    {
+        // conj()
+        _fullMagns[halfSize + i] = magns[halfSize - i];
+        _fullPhases[halfSize + i] = -phases[halfSize - i];
+    }
+}
@@ -0,0 +1,63 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FRAME_CONTEXT_H
+#define FRAME_CONTEXT_H
+
+#include "SplitSpectrum.h"
+
+// One fft frame of one channel, shared by the processors of an OverlapAdd
+// chain during a hop
+//
+// Holds the spectrum, and the features derived from it, computed on demand.
+// The features are recomputed only if the spectrum was written since
+// (see SplitSpectrum::getVersion()).
+class FrameContext
+{
+public:
+    FrameContext();
+    virtual ~FrameContext();
+
+    // Allocates
+    void resize(int numBins);
+
+    SplitSpectrum *getSpectrum();
+
+    // Shortcuts for the spectrum
+    int getNumBins() const;
+    const vector<float> &getMagns();
+    const vector<float> &getPhases();
+
+    // Magnitudes and phases of the whole spectrum, mirrored from
+    // the half spectrum, without the last bin
+    // (same as Utils::fillSecondFftHalf(), then complexToMagnPhase())
+    const vector<float> &getFullMagns();
+    const vector<float> &getFullPhases();
+
+protected:
+    void updateFullMagnsPhases();
+    
+    SplitSpectrum _spectrum;
+
+    // Features, and the version of the spectrum when they were computed
+    vector<float> _fullMagns;
+    vector<float> _fullPhases;
+    unsigned int _fullMagnsPhasesVersion;
+};
+
+#endif
@@ -0,0 +1,645 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <float.h>
+#include <string.h>
+
+#include "CpuFeatures.h"
+#include "MagnPhaseKernels.h"
+
+#if BL_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#if BL_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+// atan(a) for a in [0, 1], a*P(a^2), minimax
+#define ATAN_C1 0.99997726f
+#define ATAN_C3 -0.33262347f
+#define ATAN_C5 0.19354346f
+#define ATAN_C7 -0.11643287f
+#define ATAN_C9 0.05265332f
+#define ATAN_C11 -0.01172120f
+
+#define PI_F 3.14159265f
+#define HALF_PI_F 1.57079633f
+#define TWO_OVER_PI_F 0.63661977f
+
+// pi/2 in 3 parts, for the reduction of the phases (Cody-Waite)
+#define HALF_PI_1 1.5703125f
+#define HALF_PI_2 4.837512969970703125e-4f
+#define HALF_PI_3 7.549789948768648e-8f
+
+// sin(r) and cos(r) for r in [-pi/4, pi/4] (cephes)
+#define SIN_C3 -1.6666654611e-1f
+#define SIN_C5 8.3321608736e-3f
+#define SIN_C7 -1.9515295891e-4f
+
+#define COS_C4 4.166664568298827e-2f
+#define COS_C6 -1.388731625493765e-3f
+#define COS_C8 2.443315711809948e-5f
+
+void
+MagnPhaseKernels::complexToMagnPhase(float *magns, float *phases,
+                                     const complex<float> *comp, int numBins)
+{
+    switch (CpuFeatures::getLevel())
+    {
+#if BL_SIMD_X86
+        case CpuFeatures::SIMD_256:
+            complexToMagnPhaseAVX2(magns, phases, comp, numBins);
+            break;
+            
+        case CpuFeatures::SIMD_128:
+            complexToMagnPhaseSSE2(magns, phases, comp, numBins);
+            break;
+#endif
+#if BL_SIMD_NEON
+        case CpuFeatures::SIMD_128:
+            complexToMagnPhaseNEON(magns, phases, comp, numBins);
+            break;
+#endif
+        default:
+            complexToMagnPhaseScalar(magns, phases, comp, numBins);
+            break;
+    }
+}
+
+void
+MagnPhaseKernels::complexToMagn(float *magns, const complex<float> *comp, int numBins)
+{
+    switch (CpuFeatures::getLevel())
+    {
+#if BL_SIMD_X86
+        case CpuFeatures::SIMD_256:
+            complexToMagnAVX2(magns, comp, numBins);
+            break;
+            
+        case CpuFeatures::SIMD_128:
+            complexToMagnSSE2(magns, comp, numBins);
+            break;
+#endif
+#if BL_SIMD_NEON
+        case CpuFeatures::SIMD_128:
+            complexToMagnNEON(magns, comp, numBins);
+            break;
+#endif
+        default:
+            complexToMagnScalar(magns, comp, numBins);
+            break;
+    }
+}
+
+void
+MagnPhaseKernels::magnPhaseToComplex(complex<float> *comp,
+                                     const float *magns, const float *phases,
+                                     int numBins)
+{
+    switch (CpuFeatures::getLevel())
+    {
+#if BL_SIMD_X86
+        case CpuFeatures::SIMD_256:
+            magnPhaseToComplexAVX2(comp, magns, phases, numBins);
+            break;
+            
+        case CpuFeatures::SIMD_128:
+            magnPhaseToComplexSSE2(comp, magns, phases, numBins);
+            break;
+#endif
+#if BL_SIMD_NEON
+        case CpuFeatures::SIMD_128:
+            magnPhaseToComplexNEON(comp, magns, phases, numBins);
+            break;
+#endif
+        default:
+            magnPhaseToComplexScalar(comp, magns, phases, numBins);
+            break;
+    }
+}
+
+// Scalar
+void
+MagnPhaseKernels::complexToMagnPhaseScalar(float *magns, float *phases,
+                                           const complex<float> *comp, int numBins)
+{
+    for (int i = 0; i < numBins; i++)
+    {
+        magns[i] = abs(comp[i]);
+        phases[i] = arg(comp[i]);
+    }
+}
+
+void
+MagnPhaseKernels::complexToMagnScalar(float *magns, const complex<float> *comp, int numBins)
+{
+    for (int i = 0; i < numBins; i++)
+        magns[i] = abs(comp[i]);
+}
+
+void
+MagnPhaseKernels::magnPhaseToComplexScalar(complex<float> *comp,
+                                           const float *magns, const float *phases,
+                                           int numBins)
+{
+    for (int i = 0; i < numBins; i++)
+        comp[i] = polar(magns[i], phases[i]);
+}
+
+// For all the SIMD versions: the last bins are copied to padded buffers,
+// and processed like the others (so that the results do not depend
+// on the position of the bins)
+#define PROCESS_TAIL_TO_MAGN_PHASE(__WIDTH__, __FUNC__)                 \
+    if (i < numBins)                                                    \
+    {                                                                   \
+        complex<float> compTail[__WIDTH__] = {};                        \
+        float magnsTail[__WIDTH__];                                     \
+        float phasesTail[__WIDTH__];                                    \
+        int numTail = numBins - i;                                      \
+        memcpy(compTail, &comp[i], numTail*sizeof(complex<float>));     \
+        __FUNC__(magnsTail, phasesTail, compTail);                      \
+        memcpy(&magns[i], magnsTail, numTail*sizeof(float));            \
+        if (phases != NULL)                                             \
+            memcpy(&phases[i], phasesTail, numTail*sizeof(float));      \
+    }
+
+#define PROCESS_TAIL_TO_COMPLEX(__WIDTH__, __FUNC__)                    \
+    if (i < numBins)                                                    \
+    {                                                                   \
+        complex<float> compTail[__WIDTH__];                             \
+        float magnsTail[__WIDTH__] = {};                                \
+        float phasesTail[__WIDTH__] = {};                               \
+        int numTail = numBins - i;                                      \
+        memcpy(magnsTail, &magns[i], numTail*sizeof(float));            \
+        memcpy(phasesTail, &phases[i], numTail*sizeof(float));          \
+        __FUNC__(compTail, magnsTail, phasesTail);                      \
+        memcpy(&comp[i], compTail, numTail*sizeof(complex<float>));     \
+    }
+
+#if BL_SIMD_X86
+
+// SSE2
+static inline __m128
+selectSSE2(__m128 mask, __m128 a, __m128 b)
+{
+    // mask ? a : b
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128
+atan2SSE2(__m128 y, __m128 x)
+{
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    
+    __m128 ax = _mm_andnot_ps(signMask, x);
+    __m128 ay = _mm_andnot_ps(signMask, y);
+
+    // First octant
+    __m128 a = _mm_div_ps(_mm_min_ps(ax, ay),
+                          _mm_max_ps(_mm_max_ps(ax, ay), _mm_set1_ps(FLT_MIN)));
+    __m128 s = _mm_mul_ps(a, a);
+    
+    __m128 p = _mm_set1_ps(ATAN_C11);
+    p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(ATAN_C9));
+    p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(ATAN_C7));
+    p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(ATAN_C5));
+    p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(ATAN_C3));
+    p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(ATAN_C1));
+    __m128 r = _mm_mul_ps(p, a);
+
+    // Other octants
+    r = selectSSE2(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(HALF_PI_F), r), r);
+    __m128 xNeg = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(x), 31));
+    r = selectSSE2(xNeg, _mm_sub_ps(_mm_set1_ps(PI_F), r), r);
+
+    // r >= 0, so copy the sign of y
+    return _mm_or_ps(r, _mm_and_ps(y, signMask));
+}
+
+static inline void
+sinCosSSE2(__m128 x, __m128 *outSin, __m128 *outCos)
+{
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+    
+    // Quadrant
+    __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI_F)));
+    __m128 qf = _mm_cvtepi32_ps(q);
+    
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(HALF_PI_1)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(HALF_PI_2)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(HALF_PI_3)));
+    __m128 r2 = _mm_mul_ps(r, r);
+
+    __m128 s = _mm_set1_ps(SIN_C7);
+    s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(SIN_C5));
+    s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(SIN_C3));
+    s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, r2), r), r);
+
+    __m128 c = _mm_set1_ps(COS_C8);
+    c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(COS_C6));
+    c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(COS_C4));
+    c = _mm_mul_ps(_mm_mul_ps(c, r2), r2);
+    c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(r2, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+    // Odd quadrants: swap sin and cos
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+    __m128 sinValue = selectSSE2(swap, c, s);
+    __m128 cosValue = selectSSE2(swap, s, c);
+
+    // Signs
+    __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+    __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+    
+    *outSin = _mm_xor_ps(sinValue, sinSign);
+    *outCos = _mm_xor_ps(cosValue, cosSign);
+}
+
+// 4 bins
+static inline void
+toMagnPhaseSSE2(float *magns, float *phases, const complex<float> *comp)
+{
+    __m128 c0 = _mm_loadu_ps((const float *)comp);
+    __m128 c1 = _mm_loadu_ps((const float *)comp + 4);
+    __m128 re = _mm_shuffle_ps(c0, c1, _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 im = _mm_shuffle_ps(c0, c1, _MM_SHUFFLE(3, 1, 3, 1));
+
+    __m128 magn = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im)));
+    _mm_storeu_ps(magns, magn);
+
+    if (phases != NULL)
+        _mm_storeu_ps(phases, atan2SSE2(im, re));
+}
+
+static inline void
+toComplexSSE2(complex<float> *comp, const float *magns, const float *phases)
+{
+    __m128 magn = _mm_loadu_ps(magns);
+
+    __m128 s;
+    __m128 c;
+    sinCosSSE2(_mm_loadu_ps(phases), &s, &c);
+
+    __m128 re = _mm_mul_ps(magn, c);
+    __m128 im = _mm_mul_ps(magn, s);
+    
+    _mm_storeu_ps((float *)comp, _mm_unpacklo_ps(re, im));
+    _mm_storeu_ps((float *)comp + 4, _mm_unpackhi_ps(re, im));
+}
+
+static inline void
+toMagnSSE2(float *magns, float * /*phases*/, const complex<float> *comp)
+{
+    toMagnPhaseSSE2(magns, NULL, comp);
+}
+
+void
+MagnPhaseKernels::complexToMagnPhaseSSE2(float *magns, float *phases,
+                                         const complex<float> *comp, int numBins)
+{
+    int i = 0;
+    for (; i + 4 <= numBins; i += 4)
+        toMagnPhaseSSE2(&magns[i], &phases[i], &comp[i]);
+
+    PROCESS_TAIL_TO_MAGN_PHASE(4, toMagnPhaseSSE2);
+}
+
+void
+MagnPhaseKernels::complexToMagnSSE2(float *magns, const complex<float> *comp, int numBins)
+{
+    float *phases = NULL;
+    
+    int i = 0;
+    for (; i + 4 <= numBins; i += 4)
+        toMagnPhaseSSE2(&magns[i], NULL, &comp[i]);
+    
+    PROCESS_TAIL_TO_MAGN_PHASE(4, toMagnSSE2);
+}
+
+void
+MagnPhaseKernels::magnPhaseToComplexSSE2(complex<float> *comp,
+                                         const float *magns, const float *phases,
+                                         int numBins)
+{
+    int i = 0;
+    for (; i + 4 <= numBins; i += 4)
+        toComplexSSE2(&comp[i], &magns[i], &phases[i]);
+
+    PROCESS_TAIL_TO_COMPLEX(4, toComplexSSE2);
+}
+
+// AVX2
+static inline BL_TARGET_AVX2 __m256
+atan2AVX2(__m256 y, __m256 x)
+{
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    
+    __m256 ax = _mm256_andnot_ps(signMask, x);
+    __m256 ay = _mm256_andnot_ps(signMask, y);
+
+    // First octant
+    __m256 a = _mm256_div_ps(_mm256_min_ps(ax, ay),
+                             _mm256_max_ps(_mm256_max_ps(ax, ay), _mm256_set1_ps(FLT_MIN)));
+    __m256 s = _mm256_mul_ps(a, a);
+    
+    __m256 p = _mm256_set1_ps(ATAN_C11);
+    p = _mm256_fmadd_ps(p, s, _mm256_set1_ps(ATAN_C9));
+    p = _mm256_fmadd_ps(p, s, _mm256_set1_ps(ATAN_C7));
+    p = _mm256_fmadd_ps(p, s, _mm256_set1_ps(ATAN_C5));
+    p = _mm256_fmadd_ps(p, s, _mm256_set1_ps(ATAN_C3));
+    p = _mm256_fmadd_ps(p, s, _mm256_set1_ps(ATAN_C1));
+    __m256 r = _mm256_mul_ps(p, a);
+
+    // Other octants
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(HALF_PI_F), r),
+                         _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+    // blendv only uses the sign bit of the mask
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(PI_F), r), x);
+
+    // r >= 0, so copy the sign of y
+    return _mm256_or_ps(r, _mm256_and_ps(y, signMask));
+}
+
+static inline BL_TARGET_AVX2 void
+sinCosAVX2(__m256 x, __m256 *outSin, __m256 *outCos)
+{
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i two = _mm256_set1_epi32(2);
+    
+    // Quadrant
+    __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(TWO_OVER_PI_F)));
+    __m256 qf = _mm256_cvtepi32_ps(q);
+    
+    __m256 r = _mm256_fnmadd_ps(qf, _mm256_set1_ps(HALF_PI_1), x);
+    r = _mm256_fnmadd_ps(qf, _mm256_set1_ps(HALF_PI_2), r);
+    r = _mm256_fnmadd_ps(qf, _mm256_set1_ps(HALF_PI_3), r);
+    __m256 r2 = _mm256_mul_ps(r, r);
+
+    __m256 s = _mm256_set1_ps(SIN_C7);
+    s = _mm256_fmadd_ps(s, r2, _mm256_set1_ps(SIN_C5));
+    s = _mm256_fmadd_ps(s, r2, _mm256_set1_ps(SIN_C3));
+    s = _mm256_fmadd_ps(_mm256_mul_ps(s, r2), r, r);
+
+    __m256 c = _mm256_set1_ps(COS_C8);
+    c = _mm256_fmadd_ps(c, r2, _mm256_set1_ps(COS_C6));
+    c = _mm256_fmadd_ps(c, r2, _mm256_set1_ps(COS_C4));
+    c = _mm256_mul_ps(_mm256_mul_ps(c, r2), r2);
+    c = _mm256_add_ps(_mm256_fnmadd_ps(r2, _mm256_set1_ps(0.5f), c), _mm256_set1_ps(1.0f));
+
+    // Odd quadrants: swap sin and cos
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+    __m256 sinValue = _mm256_blendv_ps(s, c, swap);
+    __m256 cosValue = _mm256_blendv_ps(c, s, swap);
+
+    // Signs
+    __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+    __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one),
+                                                                            two), 30));
+    
+    *outSin = _mm256_xor_ps(sinValue, sinSign);
+    *outCos = _mm256_xor_ps(cosValue, cosSign);
+}
+
+// 8 bins
+static inline BL_TARGET_AVX2 void
+toMagnPhaseAVX2(float *magns, float *phases, const complex<float> *comp)
+{
+    __m256 c0 = _mm256_loadu_ps((const float *)comp);
+    __m256 c1 = _mm256_loadu_ps((const float *)comp + 8);
+
+    // The shuffles work on each 128 bits lane: bins 0 1 4 5 2 3 6 7,
+    // then reorder the 64 bits blocks
+    __m256 re = _mm256_shuffle_ps(c0, c1, _MM_SHUFFLE(2, 0, 2, 0));
+    __m256 im = _mm256_shuffle_ps(c0, c1, _MM_SHUFFLE(3, 1, 3, 1));
+    re = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(re), _MM_SHUFFLE(3, 1, 2, 0)));
+    im = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(im), _MM_SHUFFLE(3, 1, 2, 0)));
+
+    __m256 magn = _mm256_sqrt_ps(_mm256_fmadd_ps(re, re, _mm256_mul_ps(im, im)));
+    _mm256_storeu_ps(magns, magn);
+
+    if (phases != NULL)
+        _mm256_storeu_ps(phases, atan2AVX2(im, re));
+}
+
+static inline BL_TARGET_AVX2 void
+toComplexAVX2(complex<float> *comp, const float *magns, const float *phases)
+{
+    __m256 magn = _mm256_loadu_ps(magns);
+
+    __m256 s;
+    __m256 c;
+    sinCosAVX2(_mm256_loadu_ps(phases), &s, &c);
+
+    // Reorder to bins 0 1 4 5 2 3 6 7, so that the unpacks give the bins in order
+    __m256 re = _mm256_mul_ps(magn, c);
+    __m256 im = _mm256_mul_ps(magn, s);
+    re = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(re), _MM_SHUFFLE(3, 1, 2, 0)));
+    im = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(im), _MM_SHUFFLE(3, 1, 2, 0)));
+    
+    _mm256_storeu_ps((float *)comp, _mm256_unpacklo_ps(re, im));
+    _mm256_storeu_ps((float *)comp + 8, _mm256_unpackhi_ps(re, im));
+}
+
+static inline BL_TARGET_AVX2 void
+toMagnAVX2(float *magns, float * /*phases*/, const complex<float> *comp)
+{
+    toMagnPhaseAVX2(magns, NULL, comp);
+}
+
+BL_TARGET_AVX2 void
+MagnPhaseKernels::complexToMagnPhaseAVX2(float *magns, float *phases,
+                                         const complex<float> *comp, int numBins)
+{
+    int i = 0;
+    for (; i + 8 <= numBins; i += 8)
+        toMagnPhaseAVX2(&magns[i], &phases[i], &comp[i]);
+
+    PROCESS_TAIL_TO_MAGN_PHASE(8, toMagnPhaseAVX2);
+}
+
+BL_TARGET_AVX2 void
+MagnPhaseKernels::complexToMagnAVX2(float *magns, const complex<float> *comp, int numBins)
+{
+    float *phases = NULL;
+    
+    int i = 0;
+    for (; i + 8 <= numBins; i += 8)
+        toMagnPhaseAVX2(&magns[i], NULL, &comp[i]);
+
+    PROCESS_TAIL_TO_MAGN_PHASE(8, toMagnAVX2);
+}
+
+BL_TARGET_AVX2 void
+MagnPhaseKernels::magnPhaseToComplexAVX2(complex<float> *comp,
+                                         const float *magns, const float *phases,
+                                         int numBins)
+{
+    int i = 0;
+    for (; i + 8 <= numBins; i += 8)
+        toComplexAVX2(&comp[i], &magns[i], &phases[i]);
+
+    PROCESS_TAIL_TO_COMPLEX(8, toComplexAVX2);
+}
+
+#endif
+
+#if BL_SIMD_NEON
+
+// NEON
+static inline float32x4_t
+atan2NEON(float32x4_t y, float32x4_t x)
+{
+    float32x4_t ax = vabsq_f32(x);
+    float32x4_t ay = vabsq_f32(y);
+
+    // First octant
+    float32x4_t a = vdivq_f32(vminq_f32(ax, ay),
+                              vmaxq_f32(vmaxq_f32(ax, ay), vdupq_n_f32(FLT_MIN)));
+    float32x4_t s = vmulq_f32(a, a);
+    
+    float32x4_t p = vdupq_n_f32(ATAN_C11);
+    p = vfmaq_f32(vdupq_n_f32(ATAN_C9), p, s);
+    p = vfmaq_f32(vdupq_n_f32(ATAN_C7), p, s);
+    p = vfmaq_f32(vdupq_n_f32(ATAN_C5), p, s);
+    p = vfmaq_f32(vdupq_n_f32(ATAN_C3), p, s);
+    p = vfmaq_f32(vdupq_n_f32(ATAN_C1), p, s);
+    float32x4_t r = vmulq_f32(p, a);
+
+    // Other octants
+    r = vbslq_f32(vcgtq_f32(ay, ax), vsubq_f32(vdupq_n_f32(HALF_PI_F), r), r);
+    uint32x4_t xNeg = vcltq_s32(vreinterpretq_s32_f32(x), vdupq_n_s32(0));
+    r = vbslq_f32(xNeg, vsubq_f32(vdupq_n_f32(PI_F), r), r);
+
+    // r >= 0, so copy the sign of y
+    uint32x4_t ySign = vandq_u32(vreinterpretq_u32_f32(y), vdupq_n_u32(0x80000000));
+    return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(r), ySign));
+}
+
+static inline void
+sinCosNEON(float32x4_t x, float32x4_t *outSin, float32x4_t *outCos)
+{
+    const int32x4_t one = vdupq_n_s32(1);
+    const int32x4_t two = vdupq_n_s32(2);
+    
+    // Quadrant
+    int32x4_t q = vcvtnq_s32_f32(vmulq_f32(x, vdupq_n_f32(TWO_OVER_PI_F)));
+    float32x4_t qf = vcvtq_f32_s32(q);
+
+    float32x4_t r = vfmsq_f32(x, qf, vdupq_n_f32(HALF_PI_1));
+    r = vfmsq_f32(r, qf, vdupq_n_f32(HALF_PI_2));
+    r = vfmsq_f32(r, qf, vdupq_n_f32(HALF_PI_3));
+    float32x4_t r2 = vmulq_f32(r, r);
+
+    float32x4_t s = vdupq_n_f32(SIN_C7);
+    s = vfmaq_f32(vdupq_n_f32(SIN_C5), s, r2);
+    s = vfmaq_f32(vdupq_n_f32(SIN_C3), s, r2);
+    s = vfmaq_f32(r, vmulq_f32(s, r2), r);
+
+    float32x4_t c = vdupq_n_f32(COS_C8);
+    c = vfmaq_f32(vdupq_n_f32(COS_C6), c, r2);
+    c = vfmaq_f32(vdupq_n_f32(COS_C4), c, r2);
+    c = vmulq_f32(vmulq_f32(c, r2), r2);
+    c = vaddq_f32(vfmsq_f32(c, r2, vdupq_n_f32(0.5f)), vdupq_n_f32(1.0f));
+
+    // Odd quadrants: swap sin and cos
+    uint32x4_t swap = vceqq_s32(vandq_s32(q, one), one);
+    float32x4_t sinValue = vbslq_f32(swap, c, s);
+    float32x4_t cosValue = vbslq_f32(swap, s, c);
+
+    // Signs
+    uint32x4_t sinSign = vreinterpretq_u32_s32(vshlq_n_s32(vandq_s32(q, two), 30));
+    uint32x4_t cosSign = vreinterpretq_u32_s32(vshlq_n_s32(vandq_s32(vaddq_s32(q, one), two), 30));
+    
+    *outSin = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(sinValue), sinSign));
+    *outCos = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(cosValue), cosSign));
+}
+
+// 4 bins
+static inline void
+toMagnPhaseNEON(float *magns, float *phases, const complex<float> *comp)
+{
+    // Deinterleaved load
+    float32x4x2_t c = vld2q_f32((const float *)comp);
+    float32x4_t re = c.val[0];
+    float32x4_t im = c.val[1];
+
+    vst1q_f32(magns, vsqrtq_f32(vfmaq_f32(vmulq_f32(re, re), im, im)));
+
+    if (phases != NULL)
+        vst1q_f32(phases, atan2NEON(im, re));
+}
+
+static inline void
+toComplexNEON(complex<float> *comp, const float *magns, const float *phases)
+{
+    float32x4_t magn = vld1q_f32(magns);
+
+    float32x4_t s;
+    float32x4_t c;
+    sinCosNEON(vld1q_f32(phases), &s, &c);
+
+    // Interleaved store
+    float32x4x2_t result;
+    result.val[0] = vmulq_f32(magn, c);
+    result.val[1] = vmulq_f32(magn, s);
+    vst2q_f32((float *)comp, result);
+}
+
+static inline void
+toMagnNEON(float *magns, float * /*phases*/, const complex<float> *comp)
+{
+    toMagnPhaseNEON(magns, NULL, comp);
+}
+
+void
+MagnPhaseKernels::complexToMagnPhaseNEON(float *magns, float *phases,
+                                         const complex<float> *comp, int numBins)
+{
+    int i = 0;
+    for (; i + 4 <= numBins; i += 4)
+        toMagnPhaseNEON(&magns[i], &phases[i], &comp[i]);
+
+    PROCESS_TAIL_TO_MAGN_PHASE(4, toMagnPhaseNEON);
+}
+
+void
+MagnPhaseKernels::complexToMagnNEON(float *magns, const complex<float> *comp, int numBins)
+{
+    float *phases = NULL;
+    
+    int i = 0;
+    for (; i + 4 <= numBins; i += 4)
+        toMagnPhaseNEON(&magns[i], NULL, &comp[i]);
+
+    PROCESS_TAIL_TO_MAGN_PHASE(4, toMagnNEON);
+}
+
+void
+MagnPhaseKernels::magnPhaseToComplexNEON(complex<float> *comp,
+                                         const float *magns, const float *phases,
+                                         int numBins)
+{
+    int i = 0;
+    for (; i + 4 <= numBins; i += 4)
+        toComplexNEON(&comp[i], &magns[i], &phases[i]);
+
+    PROCESS_TAIL_TO_COMPLEX(4, toComplexNEON);
+}
+
+#endif
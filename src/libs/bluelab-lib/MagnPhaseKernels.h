@@ -0,0 +1,77 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef MAGN_PHASE_KERNELS_H
+#define MAGN_PHASE_KERNELS_H
+
+#include <complex>
+using namespace std;
+
+// Conversions between complex and magnitude/phase buffers
+//
+// The implementation is chosen at runtime, with CpuFeatures::getLevel():
+// scalar (std::abs, std::arg, std::polar), sse2, avx2/fma or neon.
+// The SIMD versions use approximations, with these maximum errors:
+// - magnitude: sqrt(re*re + im*im), with the hardware sqrt, 2 ulp
+//   (no overflow protection, unlike std::abs, above 1e19)
+// - phase: polynomial atan2, 2e-6 rad (the signs of zeros are the same as atan2)
+// - sin/cos: polynomials after reduction to [-pi/4, pi/4], 1e-7 for phases
+//   in [-100pi, 100pi], 5e-7 in [-1e4pi, 1e4pi]
+class MagnPhaseKernels
+{
+public:
+    static void complexToMagnPhase(float *magns, float *phases,
+                                   const complex<float> *comp, int numBins);
+
+    static void complexToMagn(float *magns, const complex<float> *comp, int numBins);
+
+    static void magnPhaseToComplex(complex<float> *comp,
+                                   const float *magns, const float *phases,
+                                   int numBins);
+
+protected:
+    static void complexToMagnPhaseScalar(float *magns, float *phases,
+                                         const complex<float> *comp, int numBins);
+    static void complexToMagnScalar(float *magns, const complex<float> *comp, int numBins);
+    static void magnPhaseToComplexScalar(complex<float> *comp,
+                                         const float *magns, const float *phases,
+                                         int numBins);
+    
+    static void complexToMagnPhaseSSE2(float *magns, float *phases,
+                                       const complex<float> *comp, int numBins);
+    static void complexToMagnSSE2(float *magns, const complex<float> *comp, int numBins);
+    static void magnPhaseToComplexSSE2(complex<float> *comp,
+                                       const float *magns, const float *phases,
+                                       int numBins);
+
+    static void complexToMagnPhaseAVX2(float *magns, float *phases,
+                                       const complex<float> *comp, int numBins);
+    static void complexToMagnAVX2(float *magns, const complex<float> *comp, int numBins);
+    static void magnPhaseToComplexAVX2(complex<float> *comp,
+                                       const float *magns, const float *phases,
+                                       int numBins);
+
+    static void complexToMagnPhaseNEON(float *magns, float *phases,
+                                       const complex<float> *comp, int numBins);
+    static void complexToMagnNEON(float *magns, const complex<float> *comp, int numBins);
+    static void magnPhaseToComplexNEON(complex<float> *comp,
+                                       const float *magns, const float *phases,
+                                       int numBins);
+};
+
+#endif
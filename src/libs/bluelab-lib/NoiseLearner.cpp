@@ -0,0 +1,370 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <math.h>
+#include <float.h>
+
+#include "Utils.h"
+#include "BufferKernels.h"
+#include "NoiseLearner.h"
+
+#define AVG_SMOOTH_COEFF 0.99
+
+// Histograms, from -144dB to 48dB
+#define HISTO_MIN_DB -144.0
+#define HISTO_CELL_DB 2.0
+#define HISTO_NUM_CELLS 96
+#define HISTO_EPS 1e-15
+
+// Median
+#define HISTO_QUANTILE 0.5
+
+// The counts are halved when reached (about 6mn at 86 frames per second),
+// so they fit in 16 bits, and the oldest frames are progressively forgotten
+#define HISTO_MAX_NUM_FRAMES 32768
+
+// Below HISTO_MIN_DB, flushed to 0 by DBToAmp()
+#define ZERO_DB -1000.0
+
+#define MIN_STATS_SMOOTH_TIME 0.05
+#define MIN_STATS_SUB_WINDOW_TIME 0.25
+#define MIN_STATS_NUM_SUB_WINDOWS 6
+
+// The minimum of the smoothed power is below its mean
+// (measured on white noise, fft size 2048, it is less accurate with larger sizes)
+#define MIN_STATS_BIAS 3.0
+
+NoiseLearner::NoiseLearner()
+{
+    _method = AVERAGE;
+    
+    _numBins = 0;
+    _numFrames = 0;
+
+    _numHistoFrames = 0;
+
+    _smoothCoeff = 0.0;
+    _subWindowSize = 1;
+    _numSubWindows = 0;
+    _subWindowPos = 0;
+
+    setFrameRate(44100.0/512);
+}
+
+NoiseLearner::~NoiseLearner() {}
+
+void
+NoiseLearner::resize(int numBins)
+{
+    if (numBins != _numBins)
+    {
+        _numBins = numBins;
+
+        _avgCurve.resize(_numBins);
+
+        _histograms.resize(_numBins*HISTO_NUM_CELLS);
+        _histoTotals.resize(_numBins);
+        _quantileCells.resize(_numBins);
+        _quantileCountsBelow.resize(_numBins);
+
+        _smoothPowers.resize(_numBins);
+        _subWindowMins.resize(_numBins);
+        _prevSubWindowMins.resize(MIN_STATS_NUM_SUB_WINDOWS, _numBins);
+        _prevMins.resize(_numBins);
+
+        _tmpBuf0.resize(_numBins);
+    }
+
+    clear();
+}
+
+int
+NoiseLearner::getNumBins()
+{
+    return _numBins;
+}
+
+void
+NoiseLearner::setFrameRate(float frameRate)
+{
+    _smoothCoeff = exp(-1.0/(MIN_STATS_SMOOTH_TIME*frameRate));
+
+    // Applied at the end of the current sub-window
+    _subWindowSize = (int)(MIN_STATS_SUB_WINDOW_TIME*frameRate + 0.5);
+    if (_subWindowSize < 1)
+        _subWindowSize = 1;
+}
+
+void
+NoiseLearner::setMethod(Method method)
+{
+    if (method == _method)
+        return;
+
+    _method = method;
+
+    clear();
+}
+
+NoiseLearner::Method
+NoiseLearner::getMethod()
+{
+    return _method;
+}
+
+void
+NoiseLearner::clear()
+{
+    _numFrames = 0;
+
+    Utils::fillZero(&_avgCurve);
+
+    memset(_histograms.data(), 0, _histograms.size()*sizeof(unsigned short));
+    Utils::fillZero(&_histoTotals);
+    Utils::fillZero(&_quantileCells);
+    Utils::fillZero(&_quantileCountsBelow);
+    _numHistoFrames = 0;
+
+    Utils::fillZero(&_smoothPowers);
+    Utils::fillValue(&_subWindowMins, FLT_MAX);
+    Utils::fillValue(&_prevMins, FLT_MAX);
+    _numSubWindows = 0;
+    _subWindowPos = 0;
+}
+
+void
+NoiseLearner::addFrame(const float *magns, int numBins)
+{
+    if (numBins != _numBins)
+        return;
+
+    switch(_method)
+    {
+        case AVERAGE:
+            addFrameAverage(magns);
+            break;
+
+        case QUANTILE:
+            addFrameQuantile(magns);
+            break;
+            
+        case MIN_STATISTICS:
+            addFrameMinStatistics(magns);
+            break;
+    }
+
+    _numFrames++;
+}
+
+void
+NoiseLearner::getNoiseCurve(vector<float> *curve)
+{
+    curve->resize(_numBins);
+
+    if (_numFrames == 0)
+    {
+        Utils::fillZero(curve);
+
+        return;
+    }
+    
+    switch(_method)
+    {
+        case AVERAGE:
+            memcpy(curve->data(), _avgCurve.data(), _numBins*sizeof(float));
+            break;
+
+        case QUANTILE:
+            getNoiseCurveQuantile(curve);
+            break;
+            
+        case MIN_STATISTICS:
+            getNoiseCurveMinStatistics(curve);
+            break;
+    }
+}
+
+void
+NoiseLearner::addFrameAverage(const float *magns)
+{
+    for (int i = 0; i < _numBins; i++)
+        _avgCurve[i] = AVG_SMOOTH_COEFF*_avgCurve[i] + (1.0 - AVG_SMOOTH_COEFF)*magns[i];
+}
+
+void
+NoiseLearner::addFrameQuantile(const float *magns)
+{
+    vector<float> &dBs = _tmpBuf0;
+    BufferKernels::ampToDB(dBs.data(), magns, _numBins, HISTO_EPS, HISTO_MIN_DB);
+    
+    for (int i = 0; i < _numBins; i++)
+    {
+        int cell = (int)((dBs[i] - HISTO_MIN_DB)*(1.0/HISTO_CELL_DB));
+        if (cell < 0)
+            cell = 0;
+        if (cell > HISTO_NUM_CELLS - 1)
+            cell = HISTO_NUM_CELLS - 1;
+
+        _histograms[i*HISTO_NUM_CELLS + cell]++;
+        _histoTotals[i]++;
+        
+        if (cell < _quantileCells[i])
+            _quantileCountsBelow[i]++;
+
+        updateQuantileCell(i);
+    }
+
+    _numHistoFrames++;
+    if (_numHistoFrames >= HISTO_MAX_NUM_FRAMES)
+        halveHistograms();
+}
+
+void
+NoiseLearner::updateQuantileCell(int binNum)
+{
+    const unsigned short *counts = &_histograms.data()[binNum*HISTO_NUM_CELLS];
+    float target = HISTO_QUANTILE*_histoTotals[binNum];
+    
+    int cell = _quantileCells[binNum];
+    int below = _quantileCountsBelow[binNum];
+
+    // First cell where the cumulative count reaches the target
+    while ((below + counts[cell] < target) && (cell < HISTO_NUM_CELLS - 1))
+    {
+        below += counts[cell];
+        cell++;
+    }
+
+    while ((cell > 0) && (below >= target))
+    {
+        cell--;
+        below -= counts[cell];
+    }
+
+    _quantileCells[binNum] = cell;
+    _quantileCountsBelow[binNum] = below;
+}
+
+void
+NoiseLearner::halveHistograms()
+{
+    _numHistoFrames = 0;
+    
+    for (int i = 0; i < _numBins; i++)
+    {
+        unsigned short *counts = &_histograms.data()[i*HISTO_NUM_CELLS];
+
+        // Rounded up, to keep the rare values
+        int total = 0;
+        for (int j = 0; j < HISTO_NUM_CELLS; j++)
+        {
+            counts[j] = (counts[j] + 1)/2;
+            total += counts[j];
+        }
+        _histoTotals[i] = total;
+
+        if (total > _numHistoFrames)
+            _numHistoFrames = total;
+        
+        _quantileCells[i] = 0;
+        _quantileCountsBelow[i] = 0;
+        updateQuantileCell(i);
+    }
+}
+
+void
+NoiseLearner::getNoiseCurveQuantile(vector<float> *curve)
+{
+    // Quantile of a Rayleigh distribution, to its mean
+    static const float rayleighCoeff = sqrt(M_PI/(-4.0*log(1.0 - HISTO_QUANTILE)));
+    
+    for (int i = 0; i < _numBins; i++)
+    {
+        int cell = _quantileCells[i];
+        
+        // Below the histogram range
+        if (cell == 0)
+        {
+            (*curve)[i] = ZERO_DB;
+            continue;
+        }
+
+        // Linear inside the cell
+        float count = _histograms[i*HISTO_NUM_CELLS + cell];
+        float t = (HISTO_QUANTILE*_histoTotals[i] - _quantileCountsBelow[i])/count;
+        
+        (*curve)[i] = HISTO_MIN_DB + (cell + t)*HISTO_CELL_DB;
+    }
+
+    BufferKernels::DBToAmp(curve->data(), _numBins);
+    BufferKernels::multValue(curve->data(), rayleighCoeff, _numBins);
+}
+
+void
+NoiseLearner::addFrameMinStatistics(const float *magns)
+{
+    if (_numFrames == 0)
+    {
+        for (int i = 0; i < _numBins; i++)
+            _smoothPowers[i] = magns[i]*magns[i];
+    }
+    else
+    {
+        for (int i = 0; i < _numBins; i++)
+            _smoothPowers[i] = _smoothCoeff*_smoothPowers[i] +
+                (1.0f - _smoothCoeff)*magns[i]*magns[i];
+    }
+
+    for (int i = 0; i < _numBins; i++)
+        _subWindowMins[i] = fmin(_subWindowMins[i], _smoothPowers[i]);
+
+    _subWindowPos++;
+    if (_subWindowPos < _subWindowSize)
+        return;
+
+    // End of the sub-window
+    _prevSubWindowMins.pushLine(_subWindowMins.data());
+    Utils::fillValue(&_subWindowMins, FLT_MAX);
+    _subWindowPos = 0;
+    
+    if (_numSubWindows < MIN_STATS_NUM_SUB_WINDOWS)
+        _numSubWindows++;
+
+    // Recompute the minimum of the last sub-windows
+    Utils::fillValue(&_prevMins, FLT_MAX);
+    for (int j = 0; j < _numSubWindows; j++)
+    {
+        const float *line = _prevSubWindowMins.getLine(MIN_STATS_NUM_SUB_WINDOWS - 1 - j);
+        for (int i = 0; i < _numBins; i++)
+            _prevMins[i] = fmin(_prevMins[i], line[i]);
+    }
+}
+
+void
+NoiseLearner::getNoiseCurveMinStatistics(vector<float> *curve)
+{
+    // Mean magnitude of a Rayleigh distribution, from its mean power
+    static const float rayleighCoeff = M_PI*0.25*MIN_STATS_BIAS;
+    
+    for (int i = 0; i < _numBins; i++)
+    {
+        float minPower = fmin(_prevMins[i], _subWindowMins[i]);
+        
+        (*curve)[i] = sqrt(rayleighCoeff*minPower);
+    }
+}
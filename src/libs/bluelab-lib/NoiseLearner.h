@@ -0,0 +1,118 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef NOISE_LEARNER_H
+#define NOISE_LEARNER_H
+
+#include <vector>
+using namespace std;
+
+#include "RingBuffer2D.h"
+
+// Learns a noise curve (one magnitude per bin) from a stream of frames
+//
+// AVERAGE: exponential average of the magnitudes
+// QUANTILE: median of the magnitudes, from a dB histogram for each bin
+// (not disturbed by the signal peaks during the learning)
+// MIN_STATISTICS: minimum of the smoothed power over a sliding window
+// (the noise can be learned under the signal, see Martin 2001)
+//
+// The memory only depends on the number of bins, not on the learning duration.
+// The robust estimates are scaled to match the average of a gaussian noise,
+// so the curves of the different methods can be used the same way.
+class NoiseLearner
+{
+public:
+    enum Method
+    {
+        AVERAGE = 0,
+        QUANTILE,
+        MIN_STATISTICS
+    };
+    
+    NoiseLearner();
+    
+    virtual ~NoiseLearner();
+
+    // Allocates if the number of bins changed, then clears
+    void resize(int numBins);
+
+    int getNumBins();
+    
+    // Frames per second, for the time constants of the minimum statistics
+    void setFrameRate(float frameRate);
+    
+    // Clears if the method changed
+    void setMethod(Method method);
+    Method getMethod();
+    
+    // Restart the learning (doesn't allocate)
+    void clear();
+    
+    void addFrame(const float *magns, int numBins);
+
+    // Doesn't allocate if the curve has already the right size
+    void getNoiseCurve(vector<float> *curve);
+    
+protected:
+    void addFrameAverage(const float *magns);
+    void addFrameQuantile(const float *magns);
+    void addFrameMinStatistics(const float *magns);
+
+    void getNoiseCurveQuantile(vector<float> *curve);
+    void getNoiseCurveMinStatistics(vector<float> *curve);
+
+    // Find the quantile cell of a bin from its cumulative counts
+    void updateQuantileCell(int binNum);
+    
+    // Forget the oldest frames, before the counts overflow
+    void halveHistograms();
+    
+    Method _method;
+    
+    int _numBins;
+    int _numFrames;
+    
+    // Average
+    vector<float> _avgCurve;
+
+    // Quantile
+    // numBins x cells (counts of the frames in each dB interval)
+    vector<unsigned short> _histograms;
+    vector<int> _histoTotals;
+    // Cell where the quantile is, and sum of the counts of the cells below
+    vector<int> _quantileCells;
+    vector<int> _quantileCountsBelow;
+    int _numHistoFrames;
+    
+    // Minimum statistics
+    float _smoothCoeff;
+    int _subWindowSize;
+    vector<float> _smoothPowers;
+    // Minimum of the current sub-window
+    vector<float> _subWindowMins;
+    // Minimums of the last completed sub-windows, and their minimum
+    RingBuffer2D<float> _prevSubWindowMins;
+    vector<float> _prevMins;
+    int _numSubWindows;
+    int _subWindowPos;
+
+    vector<float> _tmpBuf0;
+};
+
+#endif
@@ -0,0 +1,183 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <math.h>
+
+#include "NoiseProfile.h"
+
+// 0.01dB steps, from -327.67dB to 327.67dB
+#define COMPACT_DB_STEP 0.01
+// Magnitude 0
+#define COMPACT_ZERO -32768
+
+juce::String
+NoiseProfile::encode(const vector<vector<float> > &profiles)
+{
+    juce::MemoryBlock block;
+    {
+        juce::MemoryOutputStream stream(block, true);
+
+        // Write the number of vectors
+        stream.writeInt(static_cast<int>(profiles.size()));
+
+        // Write each vector
+        for (int i = 0; i < profiles.size(); i++)
+        {
+            stream.writeInt(static_cast<int>(profiles[i].size()));
+            for (int j = 0; j < profiles[i].size(); j++)
+                stream.writeFloat(profiles[i][j]);
+        }
+    }
+
+    return block.toBase64Encoding();
+}
+
+bool
+NoiseProfile::decode(const juce::String &encoded, vector<vector<float> > *profiles)
+{
+    profiles->clear();
+    
+    juce::MemoryBlock block;
+    if (!block.fromBase64Encoding(encoded))
+        return false;
+
+    juce::MemoryInputStream stream(block, false);
+
+    // Read the number of vectors
+    int numVectors = stream.readInt();
+    if (numVectors < 0)
+        return false;
+    
+    // Read each vector
+    for (int i = 0; i < numVectors; i++)
+    {
+        int vectorSize = stream.readInt();
+
+        // Truncated blob
+        if ((vectorSize < 0) ||
+            (stream.getNumBytesRemaining() < (juce::int64)vectorSize*sizeof(float)))
+        {
+            profiles->clear();
+            
+            return false;
+        }
+        
+        vector<float> profile;
+        profile.resize(vectorSize);
+        for (int j = 0; j < vectorSize; j++)
+            profile[j] = stream.readFloat();
+
+        profiles->push_back(profile);
+    }
+
+    return true;
+}
+
+void
+NoiseProfile::writeToState(juce::ValueTree *state,
+                           const vector<vector<float> > &profiles, float sampleRate)
+{
+    state->setProperty("noiseProfile", encode(profiles), NULL);
+
+    // The profile is resampled if it is loaded with another resolution or sample rate
+    state->setProperty("noiseProfileSampleRate", sampleRate, NULL);
+}
+
+bool
+NoiseProfile::readFromState(const juce::ValueTree &state,
+                            vector<vector<float> > *profiles, float *sampleRate)
+{
+    profiles->clear();
+    *sampleRate = 0.0;
+    
+    if (!state.hasProperty("noiseProfile"))
+        return false;
+
+    decode(state["noiseProfile"].toString(), profiles);
+
+    // Older states: unknown, the current sample rate is used
+    *sampleRate = state.getProperty("noiseProfileSampleRate", 0.0);
+
+    return true;
+}
+
+void
+NoiseProfile::writeCompact(juce::OutputStream *stream,
+                           const vector<vector<float> > &profiles)
+{
+    stream->writeCompressedInt(static_cast<int>(profiles.size()));
+
+    for (int i = 0; i < profiles.size(); i++)
+    {
+        stream->writeCompressedInt(static_cast<int>(profiles[i].size()));
+        for (int j = 0; j < profiles[i].size(); j++)
+        {
+            float magn = profiles[i][j];
+            
+            int value = COMPACT_ZERO;
+            if (magn > 0.0)
+            {
+                value = (int)lround(20.0*log10(magn)*(1.0/COMPACT_DB_STEP));
+                value = juce::jlimit(COMPACT_ZERO + 1, 32767, value);
+            }
+            
+            stream->writeShort(static_cast<short>(value));
+        }
+    }
+}
+
+bool
+NoiseProfile::readCompact(juce::InputStream *stream, vector<vector<float> > *profiles)
+{
+    profiles->clear();
+
+    // Each vector takes at least one byte (its size), so a corrupted count
+    // can't make a huge allocation
+    int numVectors = stream->readCompressedInt();
+    if ((numVectors < 0) || (numVectors > stream->getNumBytesRemaining()))
+        return false;
+
+    profiles->resize(numVectors);
+    for (int i = 0; i < numVectors; i++)
+    {
+        int vectorSize = stream->readCompressedInt();
+
+        // Truncated data
+        if ((vectorSize < 0) ||
+            (stream->getNumBytesRemaining() < (juce::int64)vectorSize*sizeof(short)))
+        {
+            profiles->clear();
+            
+            return false;
+        }
+
+        vector<float> &profile = (*profiles)[i];
+        profile.resize(vectorSize);
+        for (int j = 0; j < vectorSize; j++)
+        {
+            int value = stream->readShort();
+
+            if (value == COMPACT_ZERO)
+                profile[j] = 0.0;
+            else
+                profile[j] = pow(10.0, value*COMPACT_DB_STEP*(1.0/20.0));
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,61 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef NOISE_PROFILE_H
+#define NOISE_PROFILE_H
+
+#include <vector>
+using namespace std;
+
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+
+// Serialization of the learned noise profiles (one curve for each channel)
+//
+// In the plugin state, the profiles are a base64 blob: the number of curves,
+// then for each curve its size and its values (little endian int and float).
+// The sample rate at which they were learned is stored next to it
+// (0 for the older states).
+//
+// The compact format (used by NoiseProfileBank) has for each curve its size,
+// then its values in dB, quantized to 0.01dB on 16 bits.
+class NoiseProfile
+{
+public:
+    static juce::String encode(const vector<vector<float> > &profiles);
+
+    // Return false if the blob is not valid
+    static bool decode(const juce::String &encoded, vector<vector<float> > *profiles);
+
+    static void writeToState(juce::ValueTree *state,
+                             const vector<vector<float> > &profiles, float sampleRate);
+
+    // Return false if the state contains no noise profile
+    // (if the blob is not valid, the profiles are empty)
+    static bool readFromState(const juce::ValueTree &state,
+                              vector<vector<float> > *profiles, float *sampleRate);
+
+    // Compact format
+    static void writeCompact(juce::OutputStream *stream,
+                             const vector<vector<float> > &profiles);
+
+    // Return false if the data is not valid
+    static bool readCompact(juce::InputStream *stream, vector<vector<float> > *profiles);
+};
+
+#endif
@@ -0,0 +1,228 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "NoiseProfile.h"
+#include "NoiseProfileBank.h"
+
+// "BLNB", then a version number
+#define BANK_MAGIC 0x424c4e42
+#define BANK_VERSION 1
+
+NoiseProfileBank::NoiseProfileBank(int numProfiles)
+{
+    _profiles.resize(numProfiles);
+    for (int i = 0; i < _profiles.size(); i++)
+        _profiles[i]._sampleRate = 0.0;
+
+    setDefaultNames();
+}
+
+NoiseProfileBank::~NoiseProfileBank() {}
+
+void
+NoiseProfileBank::reserve(int numChannels, int maxNumBins)
+{
+    for (int i = 0; i < _profiles.size(); i++)
+    {
+        vector<vector<float> > &curves = _profiles[i]._curves;
+
+        if (curves.size() < numChannels)
+            curves.resize(numChannels);
+        
+        for (int j = 0; j < curves.size(); j++)
+            curves[j].reserve(maxNumBins);
+    }
+}
+
+int
+NoiseProfileBank::getNumProfiles() const
+{
+    return _profiles.size();
+}
+
+const juce::String &
+NoiseProfileBank::getName(int index) const
+{
+    return _profiles[index]._name;
+}
+
+void
+NoiseProfileBank::setName(int index, const juce::String &name)
+{
+    _profiles[index]._name = name;
+}
+
+vector<vector<float> > *
+NoiseProfileBank::getCurves(int index)
+{
+    return &_profiles[index]._curves;
+}
+
+const vector<vector<float> > &
+NoiseProfileBank::getCurves(int index) const
+{
+    return _profiles[index]._curves;
+}
+
+float
+NoiseProfileBank::getSampleRate(int index) const
+{
+    return _profiles[index]._sampleRate;
+}
+
+void
+NoiseProfileBank::setSampleRate(int index, float sampleRate)
+{
+    _profiles[index]._sampleRate = sampleRate;
+}
+
+void
+NoiseProfileBank::setCurves(int index, const vector<vector<float> > &curves, float sampleRate)
+{
+    vector<vector<float> > &dstCurves = _profiles[index]._curves;
+
+    // Keep the reserved curves of the other channels, empty
+    if (dstCurves.size() < curves.size())
+        dstCurves.resize(curves.size());
+    
+    for (int i = 0; i < dstCurves.size(); i++)
+    {
+        if (i < curves.size())
+            dstCurves[i] = curves[i];
+        else
+            dstCurves[i].clear();
+    }
+    
+    _profiles[index]._sampleRate = sampleRate;
+}
+
+void
+NoiseProfileBank::copyProfiles(const NoiseProfileBank &other)
+{
+    for (int i = 0; i < _profiles.size(); i++)
+    {
+        if (i < other._profiles.size())
+        {
+            _profiles[i]._name = other._profiles[i]._name;
+            setCurves(i, other._profiles[i]._curves, other._profiles[i]._sampleRate);
+        }
+        else
+        {
+            setCurves(i, vector<vector<float> >(), 0.0);
+        }
+    }
+}
+
+void
+NoiseProfileBank::encode(juce::MemoryBlock *block) const
+{
+    juce::MemoryOutputStream stream(*block, false);
+
+    stream.writeInt(BANK_MAGIC);
+    stream.writeByte(BANK_VERSION);
+    
+    stream.writeCompressedInt(static_cast<int>(_profiles.size()));
+    for (int i = 0; i < _profiles.size(); i++)
+    {
+        stream.writeString(_profiles[i]._name);
+        stream.writeFloat(_profiles[i]._sampleRate);
+
+        NoiseProfile::writeCompact(&stream, _profiles[i]._curves);
+    }
+}
+
+bool
+NoiseProfileBank::decode(const juce::MemoryBlock &block)
+{
+    juce::MemoryInputStream stream(block, false);
+
+    if ((stream.readInt() != BANK_MAGIC) || (stream.readByte() != BANK_VERSION))
+        return false;
+
+    // Profiles over the number of profiles of the bank are ignored
+    int numProfiles = stream.readCompressedInt();
+    if (numProfiles < 0)
+        return false;
+
+    vector<vector<float> > curves;
+    for (int i = 0; i < numProfiles; i++)
+    {
+        juce::String name = stream.readString();
+        float sampleRate = stream.readFloat();
+
+        if (!NoiseProfile::readCompact(&stream, &curves))
+            return false;
+
+        if (i < _profiles.size())
+        {
+            _profiles[i]._name = name;
+            setCurves(i, curves, sampleRate);
+        }
+    }
+
+    return true;
+}
+
+void
+NoiseProfileBank::writeToState(juce::ValueTree *state) const
+{
+    juce::MemoryBlock block;
+    encode(&block);
+    
+    state->setProperty("noiseProfiles", block, NULL);
+}
+
+bool
+NoiseProfileBank::readFromState(const juce::ValueTree &state)
+{
+    for (int i = 0; i < _profiles.size(); i++)
+        setCurves(i, vector<vector<float> >(), 0.0);
+    setDefaultNames();
+    
+    if (state.hasProperty("noiseProfiles"))
+    {
+        const juce::MemoryBlock *block = state["noiseProfiles"].getBinaryData();
+        if ((block == NULL) || !decode(*block))
+        {
+            // Not valid, no profile
+            for (int i = 0; i < _profiles.size(); i++)
+                setCurves(i, vector<vector<float> >(), 0.0);
+            setDefaultNames();
+        }
+        
+        return true;
+    }
+
+    // Older states
+    vector<vector<float> > curves;
+    float sampleRate;
+    if (!NoiseProfile::readFromState(state, &curves, &sampleRate))
+        return false;
+
+    if (!_profiles.empty())
+        setCurves(0, curves, sampleRate);
+
+    return true;
+}
+
+void
+NoiseProfileBank::setDefaultNames()
+{
+    for (int i = 0; i < _profiles.size(); i++)
+        _profiles[i]._name = "Profile " + juce::String(i + 1);
+}
@@ -0,0 +1,87 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef NOISE_PROFILE_BANK_H
+#define NOISE_PROFILE_BANK_H
+
+#include <vector>
+using namespace std;
+
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+
+// Several named noise profiles, each with one curve for each channel
+//
+// The curves can be reserved at their maximum size, then learning a profile
+// or switching to another one doesn't allocate.
+// In the plugin state, the profiles are a binary block, with the curves
+// in the compact format of NoiseProfile.
+class NoiseProfileBank
+{
+public:
+    NoiseProfileBank(int numProfiles);
+    
+    virtual ~NoiseProfileBank();
+
+    void reserve(int numChannels, int maxNumBins);
+    
+    int getNumProfiles() const;
+
+    const juce::String &getName(int index) const;
+    void setName(int index, const juce::String &name);
+    
+    // One curve for each channel
+    vector<vector<float> > *getCurves(int index);
+    const vector<vector<float> > &getCurves(int index) const;
+
+    // 0 if unknown
+    float getSampleRate(int index) const;
+    void setSampleRate(int index, float sampleRate);
+    
+    // Doesn't allocate if the curves are reserved
+    void setCurves(int index, const vector<vector<float> > &curves, float sampleRate);
+
+    // Copy the names and the curves (keeps the reserved sizes)
+    void copyProfiles(const NoiseProfileBank &other);
+    
+    void encode(juce::MemoryBlock *block) const;
+
+    // Return false if the block is not valid
+    bool decode(const juce::MemoryBlock &block);
+    
+    void writeToState(juce::ValueTree *state) const;
+
+    // Return false if the state contains no noise profile
+    // The single profile of the older states is read in the first profile
+    bool readFromState(const juce::ValueTree &state);
+    
+protected:
+    void setDefaultNames();
+    
+    class Profile
+    {
+    public:
+        juce::String _name;
+        float _sampleRate;
+        vector<vector<float> > _curves;
+    };
+
+    vector<Profile> _profiles;
+};
+
+#endif
@@ -20,10 +20,17 @@
 
 #include <juce_dsp/juce_dsp.h>
 
-#include "Window.h"
-#include "Utils.h"
+#include "WindowCache.h"
+#include "RealtimeAllocCheck.h"
+#include "RTWorkerPool.h"
+#include "Profiler.h"
 #include "OverlapAdd.h"
 
+// Capacity of the output ring, as a multiple of the fft size, in addition
+// to the max block size
+// It grows only if the host sends blocks bigger than the max block size
+#define OUT_SAMPLES_CAPACITY_COEFF 4
+
 // OverlapAddProcessor
 OverlapAddProcessor::OverlapAddProcessor() {}
 
@@ -32,13 +39,60 @@ OverlapAddProcessor::~OverlapAddProcessor() {}
 void
 OverlapAddProcessor::processFFT(vector<complex<float> > *compBuf) {}
 
+void
+OverlapAddProcessor::processFrame(FrameContext *frame)
+{
+    processFFT(frame->getSpectrum()->editComplex());
+}
+
 void
 OverlapAddProcessor::processSamples(vector<float> *buff) {}
 
+void
+OverlapAddProcessor::processFrameMulti(vector<FrameContext> *frames)
+{
+    for (int i = 0; i < frames->size(); i++)
+        processFrame(&(*frames)[i]);
+}
+
+void
+OverlapAddProcessor::processSamplesMulti(vector<vector<float> > *bufs)
+{
+    for (int i = 0; i < bufs->size(); i++)
+        processSamples(&(*bufs)[i]);
+}
+
 // OverlapAdd
 OverlapAdd::OverlapAdd(int fftSize, int overlap, bool fft, bool ifft)
-: _overlap(overlap), _fftFlag(fft), _ifftFlag(ifft)
+: OverlapAdd(1, fftSize, overlap, fft, ifft) {}
+
+OverlapAdd::OverlapAdd(int numChannels, int fftSize, int overlap, bool fft, bool ifft)
+: _numChannels(numChannels), _overlap(overlap), _fftFlag(fft), _ifftFlag(ifft)
 {
+    _fftBackend = FftEngine::getDefaultBackend();
+
+    _anaWindowType = Window::HANN;
+    _synthWindowType = Window::HANN;
+    _windowNormalization = WindowCache::NORMALIZE_LEGACY;
+    _lowLatencySize = 0;
+    _maxBlockSize = 0;
+
+    _workerPool = NULL;
+    _feedSamples = NULL;
+    _feedNumSamples = 0;
+
+    _channelProcessors.resize(_numChannels);
+    
+    _circSampBufsIn.resize(_numChannels);
+    _circSampBufsOut.resize(_numChannels);
+    _tmpSampBufsIn.resize(_numChannels);
+    _frames.resize(_numChannels);
+    _tmpSampBufsOut.resize(_numChannels);
+    _outSamples.resize(_numChannels);
+    _fftEngines.resize(_numChannels);
+    _numHopsProcessed.resize(_numChannels);
+    _tmpChannelPtrs.resize(_numChannels);
+    
     setFftSize(fftSize);
 }
 
@@ -49,22 +103,34 @@ OverlapAdd::setFftSize(int fftSize)
 {
     _fftSize = fftSize;
 
-    _forwardFFT = std::make_unique<juce::dsp::FFT>(log2(fftSize));
-    _backwardFFT = std::make_unique<juce::dsp::FFT>(log2(fftSize));
-
     vector<float> zeros;
     zeros.resize(_fftSize * 2);
     memset(zeros.data(), 0, zeros.size() * sizeof(float));
 
-    _circSampBufsIn.setCapacity(_fftSize * 2);
-    _circSampBufsOut.setCapacity(_fftSize * 2);
+    for (int c = 0; c < _numChannels; c++)
+    {
+        _circSampBufsIn[c].setCapacity(_fftSize * 2);
+        _circSampBufsOut[c].setCapacity(_fftSize * 2);
+
+        _circSampBufsOut[c].push(zeros.data(), zeros.size());
 
-    _circSampBufsOut.push(zeros.data(), zeros.size());
+        _tmpSampBufsIn[c].resize(_fftSize);
+        _tmpSampBufsOut[c].resize(_fftSize);
+        _frames[c].resize(_fftSize / 2 + 1);
 
-    _tmpSampBufIn.resize(_fftSize);
-    _tmpSampBufOut.resize(_fftSize);
-    _tmpCompBufOut.resize(_fftSize / 2 + 1);
+        // One engine for each channel, so that the channels can be processed
+        // in parallel (the engines have internal buffers)
+        _fftEngines[c] = FftEngine::create(_fftBackend, _fftSize);
+    }
 
+    _tmpSynthZeroBuf.resize(_fftSize / _overlap);
+    memset(_tmpSynthZeroBuf.data(), 0, _tmpSynthZeroBuf.size() * sizeof(float));
+
+    ensureOutSamplesCapacity(getOutSamplesCapacity());
+
+    for (int c = 0; c < _numChannels; c++)
+        _numHopsProcessed[c] = 0;
+    
     makeWindows();
 }
 
@@ -77,14 +143,72 @@ OverlapAdd::setOverlap(int overlap)
     zeros.resize(_fftSize * 2);
     memset(zeros.data(), 0, zeros.size() * sizeof(float));
 
-    _circSampBufsIn.setCapacity(_fftSize * 2);
-    _circSampBufsOut.setCapacity(_fftSize * 2);
+    for (int c = 0; c < _numChannels; c++)
+    {
+        _circSampBufsIn[c].setCapacity(_fftSize * 2);
+        _circSampBufsOut[c].setCapacity(_fftSize * 2);
+
+        _circSampBufsOut[c].push(zeros.data(), zeros.size());
+    }
+    
+    _tmpSynthZeroBuf.resize(_fftSize / _overlap);
+    memset(_tmpSynthZeroBuf.data(), 0, _tmpSynthZeroBuf.size() * sizeof(float));
+
+    for (int c = 0; c < _numChannels; c++)
+        _numHopsProcessed[c] = 0;
+    
+    makeWindows();
+}
+
+void
+OverlapAdd::setFftBackend(FftEngine::Backend backend)
+{
+    _fftBackend = backend;
+
+    for (int c = 0; c < _numChannels; c++)
+        _fftEngines[c] = FftEngine::create(_fftBackend, _fftSize);
+}
+
+void
+OverlapAdd::setWindows(Window::Type anaWindow, Window::Type synthWindow,
+                       WindowCache::Normalization normalization)
+{
+    _anaWindowType = anaWindow;
+    _synthWindowType = synthWindow;
+    _windowNormalization = normalization;
+
+    makeWindows();
+}
+
+float
+OverlapAdd::getReconstructionError() const
+{
+    return _windows->_reconstructionError;
+}
 
-    _circSampBufsOut.push(zeros.data(), zeros.size());
+void
+OverlapAdd::setLowLatency(int synthesisSize)
+{
+    _lowLatencySize = synthesisSize;
 
     makeWindows();
 }
 
+int
+OverlapAdd::getLatency() const
+{
+    // The first output hop starts at the beginning of the synthesis window
+    return _fftSize - _windows->_synthOffset - _fftSize / _overlap;
+}
+
+void
+OverlapAdd::setMaxBlockSize(int maxBlockSize)
+{
+    _maxBlockSize = maxBlockSize;
+
+    ensureOutSamplesCapacity(getOutSamplesCapacity());
+}
+
 void
 OverlapAdd::addProcessor(OverlapAddProcessor *processor)
 {
@@ -94,180 +218,400 @@ OverlapAdd::addProcessor(OverlapAddProcessor *processor)
 void
 OverlapAdd::feed(const vector<float> &samples)
 {
-    _circSampBufsIn.push(samples.data(), samples.size());
-
-    while (_circSampBufsIn.getSize() >= _fftSize)
-    {
-        // Get current buffer
-        _circSampBufsIn.peek(_tmpSampBufIn.data(), _fftSize);
-        _circSampBufsIn.pop(_fftSize / _overlap);
-
-        if (_fftFlag)
-        {
-            // Apply analysis window
-            for (int k = 0; k < _tmpSampBufIn.size(); k++)
-                _tmpSampBufIn[k] *= _anaWin[k];
-            
-            // Convert real input to JUCE format
-            juce::HeapBlock<float> fftInput(2*_fftSize);
-            for (int k = 0; k < _tmpSampBufIn.size(); k++)
-                fftInput[k] = _tmpSampBufIn[k];
-            
-            // Apply FFT
-            _forwardFFT->performRealOnlyForwardTransform(fftInput.get(), true);
-            
-            // Store output in temporary buffer
-            for (int k = 0; k < _tmpCompBufOut.size(); k++)
-                _tmpCompBufOut[k] = complex(fftInput[k*2], fftInput[k*2 + 1]);
-        }
+    const float *samplesData = samples.data();
+    feedChannels(&samplesData, samples.size());
+}
 
-        // Apply analysis coeff
-        // Because fftw3 seems to scale the data when doint forward fft
-        float anaCoeff = 2.0 / (_fftSize / _overlap);
-        for (int k = 0; k < _tmpCompBufOut.size(); k++)
-            _tmpCompBufOut[k] *= anaCoeff;
-        
-        // Apply callback
-        processFFT(&_tmpCompBufOut);
-        
-        if (_ifftFlag)
-        {
-            // Convert to JUCE real format for inverse FFT
-            juce::HeapBlock<float> ifftInput(_fftSize * 2);
-            for (int k = 0; k < _tmpCompBufOut.size(); k++)
-            {
-                ifftInput[k*2] = _tmpCompBufOut[k].real();
-                ifftInput[k*2 + 1] = _tmpCompBufOut[k].imag();
-            }
-
-            // Apply inverse FFT
-            _backwardFFT->performRealOnlyInverseTransform(ifftInput.get());
-            
-            // Convert back to real samples
-            for (int k = 0; k < _tmpSampBufIn.size(); k++)
-                _tmpSampBufIn[k] = ifftInput[k];
-            
-            // Apply resynth coeff
-            //float resynthCoeff = 1.0 / _fftSize;
-            //for (int k = 0; k < _tmpSampBufIn.size(); k++)
-            //    _tmpSampBufIn[k] *= resynthCoeff;
+int
+OverlapAdd::getOutSamples(vector<float> *samples, int numSamples)
+{
+    samples->resize(numSamples);
+    
+    return getChannelOutSamples(0, samples->data(), numSamples);
+}
 
-            // Apply resynth coeff
-            float resynthCoeff = 0.66*_fftSize / 2.0;
-            for (int k = 0; k < _tmpSampBufIn.size(); k++)
-                _tmpSampBufIn[k] *= resynthCoeff;
+int
+OverlapAdd::process(const float *input, float *output, int numSamples)
+{
+    feedChannels(&input, numSamples);
 
-            processSamples(&_tmpSampBufIn);
-            
-            // Apply synthesis window
-            for (int k = 0; k < _tmpSampBufIn.size(); k++)
-                _tmpSampBufIn[k] *= _synthWin[k];
-            
-            // Output
-            _circSampBufsOut.peek(_tmpSampBufOut.data(),
-                                  _synthWin.size());
+    int numValidSamples = getChannelOutSamples(0, output, numSamples);
+    flushOutSamples(numValidSamples);
 
-            for (int k = 0; k < _tmpSampBufIn.size(); k++)
-                _tmpSampBufIn[k] += _tmpSampBufOut[k];
+    return numValidSamples;
+}
 
-            _circSampBufsOut.poke(_tmpSampBufIn.data(),
-                                  _synthWin.size());
-            
-            _circSampBufsOut.pop(_fftSize / _overlap);
+void
+OverlapAdd::clearOutSamples()
+{
+    for (int c = 0; c < _numChannels; c++)
+        _outSamples[c].clear();
+}
 
-            _tmpSynthZeroBuf.resize(_fftSize / _overlap);
-            memset(_tmpSynthZeroBuf.data(), 0, _tmpSynthZeroBuf.size() * sizeof(float));
-            
-            _circSampBufsOut.push(_tmpSynthZeroBuf.data(),
-                                  _tmpSynthZeroBuf.size());
-            
-            int size = _outSamples.size();
-            _outSamples.resize(size + _fftSize / _overlap);
-            memcpy(&_outSamples.data()[size], _tmpSampBufIn.data(), _fftSize / _overlap * sizeof(float));
+void
+OverlapAdd::flushOutSamples(int numToFlush)
+{
+    for (int c = 0; c < _numChannels; c++)
+    {
+        if (numToFlush > _outSamples[c].getSize())
+        {
+            _outSamples[c].clear();
+            continue;
         }
+        
+        _outSamples[c].pop(numToFlush);
     }
 }
 
 int
-OverlapAdd::getOutSamples(vector<float> *samples, int numSamples)
+OverlapAdd::getChannelOutSamples(int channel, float *samples, int numSamples)
 {
-    samples->resize(numSamples);
-   
-    int numZeros = numSamples - _outSamples.size();
+    int numOutSamples = _outSamples[channel].getSize();
+    
+    int numZeros = numSamples - numOutSamples;
     if (numZeros < 0)
         numZeros = 0;
     for (int i = 0; i < numZeros; i++)
-        (*samples)[i] = 0.0;
-    for (int i = numZeros; i < numSamples; i++)
-        (*samples)[i] = _outSamples[i - numZeros];
+        samples[i] = 0.0;
+
+    _outSamples[channel].peek(&samples[numZeros], numSamples - numZeros);
         
     return numSamples - numZeros;
 }
 
 void
-OverlapAdd::clearOutSamples()
+OverlapAdd::processFFT()
 {
-    _outSamples.clear();
+    for (int i = 0; i < _processors.size(); i++)
+    {
+        OverlapAddProcessor *processor = _processors[i];
+        processor->processFrameMulti(&_frames);
+    }
+
+    for (int c = 0; c < _numChannels; c++)
+        processChannelFFT(c);
 }
 
 void
-OverlapAdd::flushOutSamples(int numToFlush)
+OverlapAdd::processSamples()
+{
+    for (int i = 0; i < _processors.size(); i++)
+    {
+        OverlapAddProcessor *processor = _processors[i];
+        processor->processSamplesMulti(&_tmpSampBufsIn);
+    }
+
+    for (int c = 0; c < _numChannels; c++)
+        processChannelSamples(c);
+}
+
+void
+OverlapAdd::processChannelFFT(int channel)
 {
-    if (numToFlush > _outSamples.size())
+    for (int i = 0; i < _channelProcessors[channel].size(); i++)
     {
-        _outSamples.clear();
+        OverlapAddProcessor *processor = _channelProcessors[channel][i];
+        processor->processFrame(&_frames[channel]);
+    }
+}
+
+void
+OverlapAdd::processChannelSamples(int channel)
+{
+    for (int i = 0; i < _channelProcessors[channel].size(); i++)
+    {
+        OverlapAddProcessor *processor = _channelProcessors[channel][i];
+        processor->processSamples(&_tmpSampBufsIn[channel]);
+    }
+}
+
+void
+OverlapAdd::feedChannels(const float * const *samples, int numSamples)
+{
+    // Feeding n samples produces at most n + hop output samples
+    // Does not grow, unless the block is bigger than the max block size
+    ensureOutSamplesCapacity(_outSamples[0].getSize() + numSamples + _fftSize / _overlap + 1);
+
+    // The channels are independent if there is no processor for all the channels
+    // Then each channel can process the whole block separately
+    if ((_workerPool != NULL) && (_numChannels > 1) && _processors.empty())
+    {
+        _feedSamples = samples;
+        _feedNumSamples = numSamples;
+        
+        _workerPool->run(feedChannelJob, this, _numChannels);
+        
+        _feedSamples = NULL;
+        _feedNumSamples = 0;
+
         return;
     }
+    
+    // Push by chunks, so that the input buffers never overflow
+    // (they can contain at most 2*fftSize samples)
+    int pos = 0;
+    while (pos < numSamples)
+    {
+        int numToPush = numSamples - pos;
+        if (numToPush > _fftSize)
+            numToPush = _fftSize;
+
+        for (int c = 0; c < _numChannels; c++)
+            _circSampBufsIn[c].push(&samples[c][pos], numToPush);
+        pos += numToPush;
 
-    _outSamples.erase(_outSamples.begin(), _outSamples.begin() + numToFlush);
+        // All the channels have the same number of samples
+        while (_circSampBufsIn[0].getSize() >= _fftSize)
+            processHop();
+    }
 }
 
 void
-OverlapAdd::processFFT(vector<complex<float> > *compBuf)
+OverlapAdd::feedChannel(int channel, const float *samples, int numSamples)
 {
-    for (int i = 0; i < _processors.size(); i++)
+    int pos = 0;
+    while (pos < numSamples)
     {
-        OverlapAddProcessor *processor = _processors[i];
-        processor->processFFT(compBuf);
+        int numToPush = numSamples - pos;
+        if (numToPush > _fftSize)
+            numToPush = _fftSize;
+
+        _circSampBufsIn[channel].push(&samples[pos], numToPush);
+        pos += numToPush;
+
+        while (_circSampBufsIn[channel].getSize() >= _fftSize)
+            processChannelHop(channel);
     }
 }
 
 void
-OverlapAdd::processSamples(vector<float> *buff)
+OverlapAdd::feedChannelJob(void *data, int jobIndex)
 {
-    for (int i = 0; i < _processors.size(); i++)
+    OverlapAdd *overlapAdd = (OverlapAdd *)data;
+    
+    overlapAdd->feedChannel(jobIndex, overlapAdd->_feedSamples[jobIndex],
+                            overlapAdd->_feedNumSamples);
+}
+
+void
+OverlapAdd::processHop()
+{
+    // Nothing must be allocated from here
+    // (except during the first hop, where the processors may init their buffers)
+    RealtimeAllocCheck::ScopedNoAlloc noAlloc(_numHopsProcessed[0] > 0);
+    Profiler::ScopedTimer timer(Profiler::STAGE_OVERLAP_ADD_HOP);
+    
+    for (int c = 0; c < _numChannels; c++)
+        analyzeChannel(c);
+    
+    // Apply callbacks
+    processFFT();
+        
+    if (_ifftFlag)
     {
-        OverlapAddProcessor *processor = _processors[i];
-        processor->processSamples(buff);
+        for (int c = 0; c < _numChannels; c++)
+            synthesizeChannel(c);
+        
+        processSamples();
+
+        for (int c = 0; c < _numChannels; c++)
+            overlapAddChannel(c);
     }
+
+    for (int c = 0; c < _numChannels; c++)
+        _numHopsProcessed[c]++;
+}
+
+void
+OverlapAdd::processChannelHop(int channel)
+{
+    RealtimeAllocCheck::ScopedNoAlloc noAlloc(_numHopsProcessed[channel] > 0);
+    Profiler::ScopedTimer timer(Profiler::STAGE_OVERLAP_ADD_HOP);
+
+    analyzeChannel(channel);
+
+    processChannelFFT(channel);
+
+    if (_ifftFlag)
+    {
+        synthesizeChannel(channel);
+
+        processChannelSamples(channel);
+
+        overlapAddChannel(channel);
+    }
+
+    _numHopsProcessed[channel]++;
+}
+
+void
+OverlapAdd::analyzeChannel(int channel)
+{
+    vector<float> &sampBufIn = _tmpSampBufsIn[channel];
+    
+    // Get current buffer
+    _circSampBufsIn[channel].peek(sampBufIn.data(), _fftSize);
+    _circSampBufsIn[channel].pop(_fftSize / _overlap);
+    
+    if (_fftFlag)
+    {
+        // Apply analysis window and analysis coeff, in one pass
+        juce::FloatVectorOperations::multiply(sampBufIn.data(),
+                                              _windows->_anaTable.data(), _fftSize);
+            
+        // Apply FFT
+        Profiler::ScopedTimer timer(Profiler::STAGE_FFT_FORWARD);
+        // Overwritten, and the previous cached forms and features are invalidated
+        SplitSpectrum *spectrum = _frames[channel].getSpectrum();
+        vector<complex<float> > *compBufOut = spectrum->editComplex(false);
+        _fftEngines[channel]->forward(sampBufIn.data(), compBufOut->data());
+    }
+}
+
+void
+OverlapAdd::synthesizeChannel(int channel)
+{
+    vector<float> &sampBufIn = _tmpSampBufsIn[channel];
+
+    Profiler::ScopedTimer timer(Profiler::STAGE_FFT_INVERSE);
+    
+    // Apply inverse FFT and resynth coeff
+    // (the coeff is applied with the 1/fftSize scaling, so the sample
+    // processors still get the scaled samples)
+    const vector<complex<float> > &compBuf = _frames[channel].getSpectrum()->getComplex();
+    _fftEngines[channel]->inverse(compBuf.data(), sampBufIn.data(),
+                                  WindowCache::getResynthCoeff(_fftSize));
+}
+
+void
+OverlapAdd::overlapAddChannel(int channel)
+{
+    vector<float> &sampBufIn = _tmpSampBufsIn[channel];
+    vector<float> &sampBufOut = _tmpSampBufsOut[channel];
+    CircularBuffer<float> &circSampBufOut = _circSampBufsOut[channel];
+
+    // The synthesis window is zero before the offset (low latency mode),
+    // so only the end of the frame is overlap-added
+    int offset = _windows->_synthOffset;
+    int synthSize = _fftSize - offset;
+    
+    // Output
+    circSampBufOut.peek(sampBufOut.data(), synthSize);
+
+    // Apply synthesis window and overlap-add, in one pass
+    juce::FloatVectorOperations::addWithMultiply(sampBufOut.data(), &sampBufIn.data()[offset],
+                                                 &_windows->_synthTable.data()[offset],
+                                                 synthSize);
+
+    circSampBufOut.poke(sampBufOut.data(), synthSize);
+            
+    circSampBufOut.pop(_fftSize / _overlap);
+            
+    circSampBufOut.push(_tmpSynthZeroBuf.data(), _tmpSynthZeroBuf.size());
+            
+    _outSamples[channel].push(sampBufOut.data(), _fftSize / _overlap);
 }
 
 void
 OverlapAdd::makeWindows()
-{    
-    _anaWin.resize(_fftSize);
-    Window::makeWindowHann(&_anaWin);
+{
+    WindowCache::Settings settings;
+    settings._fftSize = _fftSize;
+    settings._overlap = _overlap;
+    settings._anaWindow = _anaWindowType;
+    settings._synthWindow = _synthWindowType;
+    settings._normalization = _windowNormalization;
+    settings._lowLatencySize = _lowLatencySize;
     
-    _synthWin.resize(_fftSize);
-    Window::makeWindowHann(&_synthWin);
+    // Shared with the other objects with the same settings
+    _windows = WindowCache::getTables(settings);
+}
 
-    // Calculate combined contributions
-    vector<float> combinedWindow(_fftSize, 0.0f);
-    int hopSize = _fftSize / _overlap; // Hop size for overlap-add
+int
+OverlapAdd::getOutSamplesCapacity() const
+{
+    return _fftSize * OUT_SAMPLES_CAPACITY_COEFF + _maxBlockSize;
+}
 
-    for (int frame = 0; frame < _overlap; ++frame)
+void
+OverlapAdd::ensureOutSamplesCapacity(int numSamples)
+{
+    for (int c = 0; c < _numChannels; c++)
     {
-        int startIndex = frame * hopSize; // Starting index for the current frame
-        for (int i = 0; i < _fftSize; ++i)
-        {
-            int wrappedIndex = (startIndex + i) % _fftSize; // Wrap around for circular buffer
-            combinedWindow[wrappedIndex] += _synthWin[i];
-        }
+        CircularBuffer<float> &outSamples = _outSamples[c];
+        
+        if (outSamples.getCapacity() >= numSamples)
+            continue;
+
+        // Keep the current content
+        vector<float> samples;
+        samples.resize(outSamples.getSize());
+        outSamples.peek(samples.data(), samples.size());
+
+        outSamples.setCapacity(numSamples);
+        outSamples.push(samples.data(), samples.size());
     }
+}
+
+// MultiChannelOverlapAdd
+MultiChannelOverlapAdd::MultiChannelOverlapAdd(int numChannels, int fftSize, int overlap,
+                                               bool fft, bool ifft)
+: OverlapAdd(numChannels, fftSize, overlap, fft, ifft) {}
 
-    // Compute the normalization factor (maximum combined contribution)
-    float normalizationFactor = *std::max_element(combinedWindow.begin(), combinedWindow.end());
+MultiChannelOverlapAdd::~MultiChannelOverlapAdd() {}
+
+int
+MultiChannelOverlapAdd::getNumChannels() const
+{
+    return _numChannels;
+}
+
+void
+MultiChannelOverlapAdd::addChannelProcessor(int channel, OverlapAddProcessor *processor)
+{
+    _channelProcessors[channel].push_back(processor);
+}
+
+void
+MultiChannelOverlapAdd::setWorkerPool(RTWorkerPool *pool)
+{
+    _workerPool = pool;
+}
+
+void
+MultiChannelOverlapAdd::feed(const vector<float> samples[])
+{
+    for (int c = 0; c < _numChannels; c++)
+        _tmpChannelPtrs[c] = samples[c].data();
     
-    Utils::multValue(&_anaWin, 1.0 / normalizationFactor);
-    Utils::multValue(&_synthWin, 1.0 / normalizationFactor);
+    feedChannels(_tmpChannelPtrs.data(), samples[0].size());
+}
+
+void
+MultiChannelOverlapAdd::feed(const float * const *samples, int numSamples)
+{
+    feedChannels(samples, numSamples);
+}
+
+int
+MultiChannelOverlapAdd::getOutSamples(int channel, vector<float> *samples, int numSamples)
+{
+    samples->resize(numSamples);
+    
+    return getChannelOutSamples(channel, samples->data(), numSamples);
+}
+
+int
+MultiChannelOverlapAdd::process(const float * const *input, float * const *output,
+                                int numSamples)
+{
+    feedChannels(input, numSamples);
+
+    int numValidSamples = 0;
+    for (int c = 0; c < _numChannels; c++)
+        numValidSamples = getChannelOutSamples(c, output[c], numSamples);
+
+    flushOutSamples(numValidSamples);
+
+    return numValidSamples;
 }
@@ -22,6 +22,11 @@
 #include <juce_dsp/juce_dsp.h>
 
 #include "CircularBuffer.h"
+#include "FftEngine.h"
+#include "WindowCache.h"
+#include "FrameContext.h"
+
+class RTWorkerPool;
 
 class OverlapAddProcessor
 {
@@ -31,8 +36,19 @@ public:
     
     virtual void processFFT(vector<complex<float> > *compBuf);
 
+    // The frame is shared by the processors of the chain, so the
+    // magnitudes, phases and other features are computed only once per hop
+    // (if no processor modifies the spectrum)
+    // By default, call processFFT() with the complex form of the spectrum
+    virtual void processFrame(FrameContext *frame);
+    
     // After ifft
     virtual void processSamples(vector<float> *buf);
+
+    // Process all the channels of a hop at once
+    // By default, call processFrame()/processSamples() for each channel
+    virtual void processFrameMulti(vector<FrameContext> *frames);
+    virtual void processSamplesMulti(vector<vector<float> > *bufs);
 };
 
 class OverlapAdd
@@ -43,7 +59,37 @@ public:
 
     void setFftSize(int fftSize);
     void setOverlap(int overlap);
-    
+
+    // Not real-time safe (creates the fft plans)
+    void setFftBackend(FftEngine::Backend backend);
+
+    // Hann/Hann with legacy normalization by default
+    // With NORMALIZE_COLA, small overlaps can be used with sqrt-Hann pairs
+    // Not real-time safe (may create the tables)
+    void setWindows(Window::Type anaWindow, Window::Type synthWindow,
+                    WindowCache::Normalization normalization);
+
+    // Maximum relative reconstruction error of the current windows
+    // (if the processors do not modify the signal)
+    float getReconstructionError() const;
+
+    // Low latency mode: the spectrum is still computed on the whole frame,
+    // but only the last synthesisSize samples are overlap-added
+    // (asymmetric windows, see Window::makeWindowPairLowLatency())
+    // synthesisSize must be at least 2 hops, 0 to disable
+    // Not real-time safe (may create the tables)
+    void setLowLatency(int synthesisSize);
+
+    // Delay between the input and the output, in samples
+    int getLatency() const;
+
+    // Size the output rings for blocks of at most maxBlockSize samples
+    // (e.g samplesPerBlock in prepareToPlay()), so that feed() and process()
+    // don't allocate
+    // Not real-time safe
+    void setMaxBlockSize(int maxBlockSize);
+
+    // Processor applied to all the channels
     void addProcessor(OverlapAddProcessor *processor);
     
     void feed(const vector<float> &samples);
@@ -52,37 +98,132 @@ public:
     int getOutSamples(vector<float> *samples, int numSamples);
     void clearOutSamples();
     void flushOutSamples(int numToFlush);
+
+    // Feed, get the output and flush it, in one call
+    // input and output can be the same buffer
+    // The output is padded with zeros at the beginning, until enough samples
+    // are available. Return the number of valid samples (at the end of output)
+    int process(const float *input, float *output, int numSamples);
     
 protected:
-    void processFFT(vector<complex<float> > *compBuf);
-    void processSamples(vector<float> *buf);
+    OverlapAdd(int numChannels, int fftSize, int overlap, bool fft, bool ifft);
+
+    void processFFT();
+    void processSamples();
+
+    void processChannelFFT(int channel);
+    void processChannelSamples(int channel);
+    
+    // Feed all the channels, with the same number of samples
+    void feedChannels(const float * const *samples, int numSamples);
+
+    // Feed only one channel, when the channels are independent
+    void feedChannel(int channel, const float *samples, int numSamples);
+    static void feedChannelJob(void *data, int jobIndex);
+
+    // Return the number of valid samples
+    int getChannelOutSamples(int channel, float *samples, int numSamples);
+    
+    // Process one fft frame for all the channels, from the input buffers
+    void processHop();
+    // Process one fft frame for one channel
+    void processChannelHop(int channel);
+
+    // Steps of a hop
+    void analyzeChannel(int channel);
+    void synthesizeChannel(int channel);
+    void overlapAddChannel(int channel);
     
     void makeWindows();
-        
+
+    // Grow the output rings if necessary, keeping their content
+    // (allocates, so it should not happen after the first blocks)
+    void ensureOutSamplesCapacity(int numSamples);
+    int getOutSamplesCapacity() const;
+
+    int _numChannels;
+    
     vector<OverlapAddProcessor *> _processors;
+
+    // Processors applied to one channel only
+    vector<vector<OverlapAddProcessor *> > _channelProcessors;
     
     int _fftSize;
     int _overlap;
 
     bool _fftFlag;
     bool _ifftFlag;
+
+    // One for each channel
+    vector<CircularBuffer<float> > _circSampBufsIn;
+    vector<CircularBuffer<float> > _circSampBufsOut;
     
-    CircularBuffer<float> _circSampBufsIn;
-    CircularBuffer<float> _circSampBufsOut;
-    
-    vector<float> _tmpSampBufIn;
-    vector<float> _tmpSampBufOut;
-    vector<complex<float> > _tmpCompBufOut;
+    vector<vector<float> > _tmpSampBufsIn;
+    vector<vector<float> > _tmpSampBufsOut;
+    vector<FrameContext> _frames;
 
+    vector<CircularBuffer<float> > _outSamples;
+    
     vector<float> _tmpSynthZeroBuf;
     
-    vector<float> _anaWin;
-    vector<float> _synthWin;
+    Window::Type _anaWindowType;
+    Window::Type _synthWindowType;
+    WindowCache::Normalization _windowNormalization;
+    int _lowLatencySize;
+    int _maxBlockSize;
+    
+    std::shared_ptr<const WindowCache::Tables> _windows;
+
+    // For real-time allocation checks, skip the first hop
+    vector<int> _numHopsProcessed;
+
+    FftEngine::Backend _fftBackend;
+    vector<std::unique_ptr<FftEngine> > _fftEngines;
+
+    // Not owned
+    RTWorkerPool *_workerPool;
+    // Current block, for the worker jobs
+    const float * const *_feedSamples;
+    int _feedNumSamples;
+
+    vector<const float *> _tmpChannelPtrs;
+};
+
+// Process all the channels together, hop by hop
+// (same hop for all the channels, so a processor can use all of them)
+//
+// The channels are not batched: each channel keeps its own buffers, spectrum
+// and fft engine, and each step of a hop loops over the channels.
+// Each step is already a vectorized pass over a whole frame, so the cost
+// is the same as one OverlapAdd per channel (see the "OverlapAdd/6ch-ov32"
+// and "OverlapAdd/8ch-ov32" benchmarks in BL_Bench)
+class MultiChannelOverlapAdd : public OverlapAdd
+{
+public:
+    MultiChannelOverlapAdd(int numChannels, int fftSize, int overlap,
+                           bool fft, bool ifft);
+    virtual ~MultiChannelOverlapAdd();
+
+    int getNumChannels() const;
+
+    // Processor applied to one channel only
+    // Called after the processors applied to all the channels
+    void addChannelProcessor(int channel, OverlapAddProcessor *processor);
+
+    // Optional, not owned
+    // If set and if there are only channel processors, the channels are
+    // processed in parallel
+    void setWorkerPool(RTWorkerPool *pool);
+
+    // One buffer for each channel, all with the same size
+    void feed(const vector<float> samples[]);
+    void feed(const float * const *samples, int numSamples);
 
-    vector<float> _outSamples;
+    // Return the number of samples to flush (the same for all channels)
+    int getOutSamples(int channel, vector<float> *samples, int numSamples);
 
-    std::unique_ptr<juce::dsp::FFT> _forwardFFT;
-    std::unique_ptr<juce::dsp::FFT> _backwardFFT;
+    // See OverlapAdd::process(), with one buffer for each channel
+    int process(const float * const *input, float * const *output, int numSamples);
 };
 
 #endif // OVERLAP_ADD_H
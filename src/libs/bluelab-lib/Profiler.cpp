@@ -0,0 +1,326 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Profiler.h"
+
+#if BL_PROFILE_RDTSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// Each thread that records samples takes a slot
+// The threads beyond the limit are not profiled
+#define PROFILER_MAX_THREADS 32
+
+// Log2 buckets, in ticks
+#define PROFILER_NUM_BUCKETS 48
+
+// Minimum time to compare the tick counter with steady_clock, in seconds
+#define PROFILER_CALIBRATION_TIME 0.01
+
+struct ProfilerThreadStats
+{
+    std::atomic<int64_t> _count[Profiler::NUM_STAGES];
+    std::atomic<int64_t> _sumTicks[Profiler::NUM_STAGES];
+    std::atomic<int64_t> _maxTicks[Profiler::NUM_STAGES];
+    std::atomic<int64_t> _buckets[Profiler::NUM_STAGES][PROFILER_NUM_BUCKETS];
+};
+
+// Static storage, zero initialized
+static ProfilerThreadStats threadStats[PROFILER_MAX_THREADS];
+static std::atomic<int> numThreadStats(0);
+
+// -1: no slot yet, -2: no slot left
+static thread_local int threadStatsIndex = -1;
+
+static const char *stageNames[Profiler::NUM_STAGES] =
+{
+    "OverlapAdd::processHop",
+    "FFT forward",
+    "FFT inverse",
+    "DenoiserProcessor::processFrame",
+    "DenoiserProcessor::residualDenoise",
+    "DenoiserProcessor::autoResidualDenoise",
+    "WienerSoftMasking::processCentered"
+};
+
+// Reference point, to convert the ticks to seconds
+struct ProfilerCalibration
+{
+    uint64_t _ticks;
+    std::chrono::steady_clock::time_point _time;
+};
+
+static const ProfilerCalibration calibrationStart =
+{
+    Profiler::getTicks(), std::chrono::steady_clock::now()
+};
+
+const char *
+Profiler::getStageName(int stage)
+{
+    if ((stage < 0) || (stage >= NUM_STAGES))
+        return "";
+
+    return stageNames[stage];
+}
+
+void
+Profiler::getSnapshot(Snapshot *snapshot)
+{
+    snapshot->_ticksPerSecond = getTicksPerSecond();
+    
+    snapshot->_stages.resize(NUM_STAGES);
+
+    int numThreads = numThreadStats.load();
+    if (numThreads > PROFILER_MAX_THREADS)
+        numThreads = PROFILER_MAX_THREADS;
+
+    double microsPerTick = 1e6/snapshot->_ticksPerSecond;
+    
+    for (int s = 0; s < NUM_STAGES; s++)
+    {
+        StageStats &stats = snapshot->_stages[s];
+
+        stats._histogram.resize(PROFILER_NUM_BUCKETS);
+        for (int b = 0; b < PROFILER_NUM_BUCKETS; b++)
+            stats._histogram[b] = 0;
+
+        int64_t count = 0;
+        int64_t sumTicks = 0;
+        int64_t maxTicks = 0;
+        for (int t = 0; t < numThreads; t++)
+        {
+            const ProfilerThreadStats &thread = threadStats[t];
+            
+            count += thread._count[s].load(std::memory_order_relaxed);
+            sumTicks += thread._sumTicks[s].load(std::memory_order_relaxed);
+            
+            int64_t threadMax = thread._maxTicks[s].load(std::memory_order_relaxed);
+            if (threadMax > maxTicks)
+                maxTicks = threadMax;
+
+            for (int b = 0; b < PROFILER_NUM_BUCKETS; b++)
+                stats._histogram[b] += thread._buckets[s][b].load(std::memory_order_relaxed);
+        }
+
+        stats._count = count;
+        stats._meanTime = (count > 0) ? sumTicks*microsPerTick/count : 0.0;
+        stats._maxTime = maxTicks*microsPerTick;
+        stats._medianTime = getPercentileTime(stats._histogram, 0.5,
+                                              snapshot->_ticksPerSecond);
+        stats._p99Time = getPercentileTime(stats._histogram, 0.99,
+                                           snapshot->_ticksPerSecond);
+    }
+}
+
+void
+Profiler::reset()
+{
+    int numThreads = numThreadStats.load();
+    if (numThreads > PROFILER_MAX_THREADS)
+        numThreads = PROFILER_MAX_THREADS;
+    
+    for (int t = 0; t < numThreads; t++)
+    {
+        ProfilerThreadStats &thread = threadStats[t];
+        
+        for (int s = 0; s < NUM_STAGES; s++)
+        {
+            thread._count[s].store(0, std::memory_order_relaxed);
+            thread._sumTicks[s].store(0, std::memory_order_relaxed);
+            thread._maxTicks[s].store(0, std::memory_order_relaxed);
+            
+            for (int b = 0; b < PROFILER_NUM_BUCKETS; b++)
+                thread._buckets[s][b].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool
+Profiler::dumpCSV(const char *fileName)
+{
+    Snapshot snapshot;
+    getSnapshot(&snapshot);
+    
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL)
+        return false;
+
+    fprintf(file, "stage,count,mean_us,max_us,median_us,p99_us");
+    for (int b = 0; b < PROFILER_NUM_BUCKETS; b++)
+        fprintf(file, ",bucket_%d", b);
+    fprintf(file, "\n");
+    
+    for (int s = 0; s < snapshot._stages.size(); s++)
+    {
+        const StageStats &stats = snapshot._stages[s];
+        
+        fprintf(file, "\"%s\",%lld,%g,%g,%g,%g", getStageName(s), (long long)stats._count,
+                stats._meanTime, stats._maxTime, stats._medianTime, stats._p99Time);
+        for (int b = 0; b < stats._histogram.size(); b++)
+            fprintf(file, ",%lld", (long long)stats._histogram[b]);
+        fprintf(file, "\n");
+    }
+    
+    fclose(file);
+
+    return true;
+}
+
+bool
+Profiler::dumpJSON(const char *fileName)
+{
+    Snapshot snapshot;
+    getSnapshot(&snapshot);
+    
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL)
+        return false;
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"ticksPerSecond\": %.0f,\n", snapshot._ticksPerSecond);
+    fprintf(file, "  \"stages\": [\n");
+    
+    for (int s = 0; s < snapshot._stages.size(); s++)
+    {
+        const StageStats &stats = snapshot._stages[s];
+        
+        fprintf(file, "    {\"name\": \"%s\", \"count\": %lld, ", getStageName(s),
+                (long long)stats._count);
+        fprintf(file, "\"meanUs\": %g, \"maxUs\": %g, \"medianUs\": %g, \"p99Us\": %g,\n",
+                stats._meanTime, stats._maxTime, stats._medianTime, stats._p99Time);
+
+        fprintf(file, "     \"histogram\": [");
+        for (int b = 0; b < stats._histogram.size(); b++)
+            fprintf(file, (b > 0) ? ", %lld" : "%lld", (long long)stats._histogram[b]);
+        fprintf(file, "]}");
+        
+        fprintf(file, (s < snapshot._stages.size() - 1) ? ",\n" : "\n");
+    }
+
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+    
+    fclose(file);
+
+    return true;
+}
+
+uint64_t
+Profiler::getTicks()
+{
+#if BL_PROFILE_RDTSC
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void
+Profiler::addSample(Stage stage, uint64_t ticks)
+{
+    if (threadStatsIndex == -1)
+    {
+        int index = numThreadStats.fetch_add(1);
+        threadStatsIndex = (index < PROFILER_MAX_THREADS) ? index : -2;
+    }
+
+    if (threadStatsIndex < 0)
+        return;
+    
+    ProfilerThreadStats &thread = threadStats[threadStatsIndex];
+    
+    int bucket = 0;
+    uint64_t t = ticks;
+    while ((t >>= 1) != 0)
+        bucket++;
+    if (bucket >= PROFILER_NUM_BUCKETS)
+        bucket = PROFILER_NUM_BUCKETS - 1;
+    
+    thread._count[stage].fetch_add(1, std::memory_order_relaxed);
+    thread._sumTicks[stage].fetch_add(ticks, std::memory_order_relaxed);
+    thread._buckets[stage][bucket].fetch_add(1, std::memory_order_relaxed);
+    
+    // Only this thread writes in its slot
+    if ((int64_t)ticks > thread._maxTicks[stage].load(std::memory_order_relaxed))
+        thread._maxTicks[stage].store(ticks, std::memory_order_relaxed);
+}
+
+double
+Profiler::getTicksPerSecond()
+{
+#if BL_PROFILE_RDTSC
+    // Compare with steady_clock, since the beginning
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - calibrationStart._time;
+    if (elapsed.count() < PROFILER_CALIBRATION_TIME)
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(PROFILER_CALIBRATION_TIME));
+        
+        elapsed = std::chrono::steady_clock::now() - calibrationStart._time;
+    }
+    
+    return (getTicks() - calibrationStart._ticks)/elapsed.count();
+#else
+    return 1e9;
+#endif
+}
+
+double
+Profiler::getPercentileTime(const vector<int64_t> &histogram, double fraction,
+                            double ticksPerSecond)
+{
+    int64_t count = 0;
+    for (int b = 0; b < histogram.size(); b++)
+        count += histogram[b];
+
+    if (count == 0)
+        return 0.0;
+    
+    double target = fraction*count;
+    
+    int64_t sum = 0;
+    for (int b = 0; b < histogram.size(); b++)
+    {
+        if ((histogram[b] == 0) || (sum + histogram[b] < target))
+        {
+            sum += histogram[b];
+            continue;
+        }
+
+        // Interpolate in the bucket
+        double t = (target - sum)/histogram[b];
+        double minTicks = (b > 0) ? (double)(1ULL << b) : 0.0;
+        double maxTicks = (double)(2ULL << b);
+        
+        return (minTicks + t*(maxTicks - minTicks))*1e6/ticksPerSecond;
+    }
+
+    return 0.0;
+}
@@ -0,0 +1,130 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+#include <vector>
+using namespace std;
+
+// Set to 1 (e.g in the jucer defines) to measure the time spent
+// in the main processing stages
+#ifndef BL_PROFILE
+#define BL_PROFILE 0
+#endif
+
+// Use the cpu time stamp counter on x86, steady_clock otherwise
+#ifndef BL_PROFILE_RDTSC
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BL_PROFILE_RDTSC 1
+#else
+#define BL_PROFILE_RDTSC 0
+#endif
+#endif
+
+// Lightweight timers, usable from the audio thread and the worker threads
+//
+// Each thread records its timings in its own histograms (log2 buckets,
+// in ticks), with relaxed atomics only: no lock, no allocation.
+// The snapshots can be taken from any thread (e.g the editor timer),
+// and converted to microseconds at this moment.
+// When BL_PROFILE is disabled, ScopedTimer is an empty object.
+class Profiler
+{
+public:
+    enum Stage
+    {
+        STAGE_OVERLAP_ADD_HOP = 0,
+        STAGE_FFT_FORWARD,
+        STAGE_FFT_INVERSE,
+        STAGE_DENOISER_PROCESS_FFT,
+        STAGE_RESIDUAL_DENOISE,
+        STAGE_AUTO_RESIDUAL_DENOISE,
+        STAGE_SOFT_MASKING,
+        NUM_STAGES
+    };
+
+    class ScopedTimer
+    {
+    public:
+#if BL_PROFILE
+        ScopedTimer(Stage stage)
+        : _stage(stage), _startTicks(getTicks()) {}
+
+        ~ScopedTimer() { addSample(_stage, getTicks() - _startTicks); }
+
+    protected:
+        Stage _stage;
+        uint64_t _startTicks;
+#else
+        ScopedTimer(Stage stage) {}
+#endif
+    };
+
+    struct StageStats
+    {
+        int64_t _count;
+
+        // In microseconds
+        double _meanTime;
+        double _maxTime;
+        // Estimated from the histogram
+        double _medianTime;
+        double _p99Time;
+        
+        // Number of samples in each bucket, for all the threads
+        // Bucket i contains the times from 2^i to 2^(i+1) ticks
+        vector<int64_t> _histogram;
+    };
+    
+    struct Snapshot
+    {
+        double _ticksPerSecond;
+        
+        vector<StageStats> _stages;
+    };
+    
+    static const char *getStageName(int stage);
+
+    // Not real-time safe
+    static void getSnapshot(Snapshot *snapshot);
+
+    // The samples recorded at the same time may be lost
+    static void reset();
+
+    // Return false if the file can't be written
+    static bool dumpCSV(const char *fileName);
+    static bool dumpJSON(const char *fileName);
+    
+    static uint64_t getTicks();
+
+    // Real-time safe
+    static void addSample(Stage stage, uint64_t ticks);
+
+protected:
+    static double getTicksPerSecond();
+    
+    // Time below which there is the given fraction of the samples
+    // (interpolated in the histogram bucket)
+    static double getPercentileTime(const vector<int64_t> &histogram, double fraction,
+                                    double ticksPerSecond);
+};
+
+#endif
@@ -0,0 +1,96 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <juce_core/juce_core.h>
+
+#if JUCE_WINDOWS
+#include <windows.h>
+#elif JUCE_MAC || JUCE_IOS
+#include <dispatch/dispatch.h>
+#else
+#include <semaphore.h>
+#endif
+
+#include "RTSemaphore.h"
+
+class RTSemaphore::Impl
+{
+public:
+#if JUCE_WINDOWS
+    HANDLE _sem;
+#elif JUCE_MAC || JUCE_IOS
+    dispatch_semaphore_t _sem;
+#else
+    sem_t _sem;
+#endif
+};
+
+RTSemaphore::RTSemaphore()
+{
+    _impl = new Impl();
+    
+#if JUCE_WINDOWS
+    _impl->_sem = CreateSemaphore(NULL, 0, 0x7fffffff, NULL);
+#elif JUCE_MAC || JUCE_IOS
+    _impl->_sem = dispatch_semaphore_create(0);
+#else
+    sem_init(&_impl->_sem, 0, 0);
+#endif
+}
+
+RTSemaphore::~RTSemaphore()
+{
+#if JUCE_WINDOWS
+    CloseHandle(_impl->_sem);
+#elif JUCE_MAC || JUCE_IOS
+    dispatch_release(_impl->_sem);
+#else
+    sem_destroy(&_impl->_sem);
+#endif
+
+    delete _impl;
+}
+
+void
+RTSemaphore::post(int count)
+{
+#if JUCE_WINDOWS
+    ReleaseSemaphore(_impl->_sem, count, NULL);
+#else
+    for (int i = 0; i < count; i++)
+    {
+#if JUCE_MAC || JUCE_IOS
+        dispatch_semaphore_signal(_impl->_sem);
+#else
+        sem_post(&_impl->_sem);
+#endif
+    }
+#endif
+}
+
+void
+RTSemaphore::wait()
+{
+#if JUCE_WINDOWS
+    WaitForSingleObject(_impl->_sem, INFINITE);
+#elif JUCE_MAC || JUCE_IOS
+    dispatch_semaphore_wait(_impl->_sem, DISPATCH_TIME_FOREVER);
+#else
+    while (sem_wait(&_impl->_sem) != 0) {}
+#endif
+}
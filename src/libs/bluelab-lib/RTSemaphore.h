@@ -0,0 +1,43 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef RT_SEMAPHORE_H
+#define RT_SEMAPHORE_H
+
+// Counting semaphore, that can be posted from the audio thread
+// Posting does not take a lock (unlike juce::WaitableEvent,
+// which uses a mutex and a condition variable)
+class RTSemaphore
+{
+public:
+    RTSemaphore();
+    virtual ~RTSemaphore();
+
+    // Real-time safe
+    void post(int count = 1);
+
+    // Wait until posted
+    void wait();
+
+protected:
+    class Impl;
+
+    Impl *_impl;
+};
+
+#endif
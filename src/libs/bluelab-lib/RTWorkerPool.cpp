@@ -0,0 +1,232 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <juce_core/juce_core.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#include "RTSemaphore.h"
+#include "RTWorkerPool.h"
+
+// Number of pause loops before going to sleep (a few microseconds)
+#define SPIN_COUNT 4000
+
+std::atomic<int> RTWorkerPool::_nextCpu { 0 };
+
+RTWorkerPool::RTWorkerPool(int numThreads, bool pinThreads)
+{
+    _pinThreads = pinThreads;
+    
+    _state = makeState(0, 0, 0);
+    _numJobsDone = 0;
+    _numSleeping = 0;
+    _mustQuit = false;
+
+    for (int i = 0; i < MAX_NUM_JOBS; i++)
+        _jobGenerations[i] = 0;
+    
+    _func = NULL;
+    _data = NULL;
+    
+    _semaphore = new RTSemaphore();
+    
+    for (int i = 0; i < numThreads; i++)
+        _threads.push_back(std::thread(&RTWorkerPool::workerLoop, this, i));
+}
+
+RTWorkerPool::~RTWorkerPool()
+{
+    _mustQuit = true;
+    _semaphore->post(_threads.size());
+
+    for (int i = 0; i < _threads.size(); i++)
+        _threads[i].join();
+
+    delete _semaphore;
+}
+
+int
+RTWorkerPool::getNumThreads() const
+{
+    return _threads.size();
+}
+
+void
+RTWorkerPool::run(JobFunc func, void *data, int numJobs)
+{
+    if (numJobs <= 0)
+        return;
+    
+    if (_threads.empty() || (numJobs == 1) || (numJobs > MAX_NUM_JOBS))
+    {
+        for (int i = 0; i < numJobs; i++)
+            func(data, i);
+
+        return;
+    }
+    
+    _func = func;
+    _data = data;
+    _numJobsDone = 0;
+
+    unsigned int generation = (unsigned int)(_state.load() >> 32) + 1;
+    // 0 is the initial generation of the workers
+    if (generation == 0)
+        generation = 1;
+    
+    // Publish
+    _state = makeState(generation, numJobs, 0);
+
+    // Wake up the sleeping workers
+    int numSleeping = _numSleeping.load();
+    if (numSleeping > 0)
+        _semaphore->post(numSleeping);
+
+    // Process jobs too, and the ones that the workers did not take in time
+    processJobs(generation);
+
+    // Take back the jobs claimed by the workers, but not started yet
+    for (int i = 0; i < numJobs; i++)
+    {
+        if (startJob(i, generation))
+        {
+            func(data, i);
+            
+            _numJobsDone.fetch_add(1, std::memory_order_release);
+        }
+    }
+    
+    // Wait for the jobs running on the workers
+    // (yield if a worker is preempted in the middle of a job)
+    int numSpins = 0;
+    while (_numJobsDone.load(std::memory_order_acquire) < numJobs)
+    {
+        if (++numSpins < SPIN_COUNT)
+            cpuPause();
+        else
+            std::this_thread::yield();
+    }
+}
+
+void
+RTWorkerPool::workerLoop(int threadIndex)
+{
+    if (_pinThreads)
+    {
+        // Keep cpu 0 for the host, and continue after the workers
+        // of the other pools
+        int numCpus = juce::SystemStats::getNumCpus();
+        int cpu = (numCpus > 1) ? 1 + _nextCpu++ % (numCpus - 1) : 0;
+        juce::Thread::setCurrentThreadAffinityMask(1u << (cpu % 32));
+    }
+
+    unsigned int lastGeneration = 0;
+    
+    while (!_mustQuit)
+    {
+        // Spin a bit
+        unsigned int generation = 0;
+        for (int i = 0; i < SPIN_COUNT; i++)
+        {
+            generation = (unsigned int)(_state.load(std::memory_order_acquire) >> 32);
+            if (generation != lastGeneration)
+                break;
+            
+            cpuPause();
+        }
+
+        if (generation != lastGeneration)
+        {
+            lastGeneration = generation;
+            processJobs(generation);
+
+            continue;
+        }
+
+        // Then wait
+        _numSleeping++;
+
+        // Check again, in case run() was called just before we incremented
+        generation = (unsigned int)(_state.load() >> 32);
+        if ((generation == lastGeneration) && !_mustQuit)
+            _semaphore->wait();
+        
+        _numSleeping--;
+    }
+}
+
+void
+RTWorkerPool::processJobs(unsigned int generation)
+{
+    while (true)
+    {
+        unsigned long long state = _state.load(std::memory_order_acquire);
+
+        unsigned int stateGeneration = (unsigned int)(state >> 32);
+        int numJobs = (int)((state >> 16) & 0xffff);
+        int nextJob = (int)(state & 0xffff);
+        
+        if ((stateGeneration != generation) || (nextJob >= numJobs))
+            break;
+
+        // Claim the job
+        unsigned long long newState = makeState(generation, numJobs, nextJob + 1);
+        if (!_state.compare_exchange_weak(state, newState))
+            continue;
+
+        // The calling thread may have taken it back
+        if (!startJob(nextJob, generation))
+            continue;
+        
+        _func(_data, nextJob);
+        
+        _numJobsDone.fetch_add(1, std::memory_order_release);
+    }
+}
+
+bool
+RTWorkerPool::startJob(int jobIndex, unsigned int generation)
+{
+    // Already started in this run, or in a later run
+    // (the worker was preempted between the claim and the start)
+    unsigned int jobGeneration = _jobGenerations[jobIndex].load();
+    if ((int)(generation - jobGeneration) <= 0)
+        return false;
+
+    return _jobGenerations[jobIndex].compare_exchange_strong(jobGeneration, generation);
+}
+
+void
+RTWorkerPool::cpuPause()
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+unsigned long long
+RTWorkerPool::makeState(unsigned int generation, int numJobs, int nextJob)
+{
+    return (((unsigned long long)generation) << 32) |
+        (((unsigned long long)(numJobs & 0xffff)) << 16) |
+        ((unsigned long long)(nextJob & 0xffff));
+}
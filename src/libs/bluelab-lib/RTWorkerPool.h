@@ -0,0 +1,97 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef RT_WORKER_POOL_H
+#define RT_WORKER_POOL_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+using namespace std;
+
+class RTSemaphore;
+
+// Pool of worker threads, to run independent jobs from the audio thread
+//
+// - no lock and no allocation in run()
+// - the workers spin for a short time, then wait on a semaphore
+// - the calling thread also takes jobs: the jobs that the workers did not
+// start in time (e.g sleeping or preempted workers) are processed inline,
+// so run() never waits for a worker to wake up
+// - a job is claimed then started: the calling thread takes back the jobs
+// claimed by a worker that was preempted before starting them, and only
+// waits for the jobs that are running
+class RTWorkerPool
+{
+public:
+    typedef void (*JobFunc)(void *data, int jobIndex);
+
+    // Above, the jobs are processed by the calling thread only
+    enum { MAX_NUM_JOBS = 64 };
+    
+    // numThreads: number of worker threads, in addition to the calling thread
+    // pinThreads: set the affinity of each worker to a different cpu
+    // (the cpus are shared by all the pools, so that the workers of several
+    // plugin instances do not pile on the same cpus)
+    RTWorkerPool(int numThreads, bool pinThreads = false);
+    virtual ~RTWorkerPool();
+
+    int getNumThreads() const;
+    
+    // Run func(data, i) for i in [0, numJobs[, and return when all are done
+    // Must be called from only one thread at a time
+    void run(JobFunc func, void *data, int numJobs);
+
+protected:
+    void workerLoop(int threadIndex);
+
+    void processJobs(unsigned int generation);
+
+    // Return false if the job was already started by another thread
+    bool startJob(int jobIndex, unsigned int generation);
+    
+    static void cpuPause();
+
+    static unsigned long long makeState(unsigned int generation,
+                                        int numJobs, int nextJob);
+    
+    vector<std::thread> _threads;
+    bool _pinThreads;
+    
+    // Generation, number of jobs and next job index, packed,
+    // so that a late worker can't claim a job of the next run
+    std::atomic<unsigned long long> _state;
+    
+    // Generation of the last start of each job
+    std::atomic<unsigned int> _jobGenerations[MAX_NUM_JOBS];
+    
+    std::atomic<int> _numJobsDone;
+    std::atomic<int> _numSleeping;
+    std::atomic<bool> _mustQuit;
+
+    // Written before publishing a new generation
+    JobFunc _func;
+    void *_data;
+    
+    RTSemaphore *_semaphore;
+
+    // Next cpu to pin a worker to, for all the pools
+    static std::atomic<int> _nextCpu;
+};
+
+#endif
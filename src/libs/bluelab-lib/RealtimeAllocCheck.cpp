@@ -0,0 +1,127 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <stdlib.h>
+
+#include <new>
+
+#include <juce_core/juce_core.h>
+
+#include "RealtimeAllocCheck.h"
+
+#if BL_DEBUG_RT_ALLOC
+static thread_local int noAllocDepth = 0;
+#endif
+
+RealtimeAllocCheck::ScopedNoAlloc::ScopedNoAlloc(bool enabled)
+{
+    _enabled = enabled;
+
+#if BL_DEBUG_RT_ALLOC
+    if (_enabled)
+        noAllocDepth++;
+#endif
+}
+
+RealtimeAllocCheck::ScopedNoAlloc::~ScopedNoAlloc()
+{
+#if BL_DEBUG_RT_ALLOC
+    if (_enabled)
+        noAllocDepth--;
+#endif
+}
+
+bool
+RealtimeAllocCheck::isInNoAllocSection()
+{
+#if BL_DEBUG_RT_ALLOC
+    return (noAllocDepth > 0);
+#else
+    return false;
+#endif
+}
+
+void
+RealtimeAllocCheck::checkAllocation()
+{
+    // If this asserts, look at the call stack:
+    // something allocates or frees memory on the audio thread
+    jassert(!isInNoAllocSection());
+}
+
+#if BL_DEBUG_RT_ALLOC
+// Replace the global allocation operators
+void *
+operator new(std::size_t size)
+{
+    RealtimeAllocCheck::checkAllocation();
+    
+    void *ptr = malloc((size > 0) ? size : 1);
+    if (ptr == NULL)
+        throw std::bad_alloc();
+    
+    return ptr;
+}
+
+void *
+operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *
+operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    RealtimeAllocCheck::checkAllocation();
+    
+    return malloc((size > 0) ? size : 1);
+}
+
+void *
+operator new[](std::size_t size, const std::nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void
+operator delete(void *ptr) noexcept
+{
+    if (ptr != NULL)
+        RealtimeAllocCheck::checkAllocation();
+    
+    free(ptr);
+}
+
+void
+operator delete[](void *ptr) noexcept
+{
+    operator delete(ptr);
+}
+
+void
+operator delete(void *ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void
+operator delete[](void *ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+#endif
@@ -0,0 +1,55 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef REALTIME_ALLOC_CHECK_H
+#define REALTIME_ALLOC_CHECK_H
+
+// Set to 1 (e.g in the jucer defines) to detect memory allocations
+// made from the audio thread, in debug builds
+#ifndef BL_DEBUG_RT_ALLOC
+#define BL_DEBUG_RT_ALLOC 0
+#endif
+
+// Debug helper to check that the real-time code does not allocate
+//
+// When BL_DEBUG_RT_ALLOC is enabled, the global operator new and operator delete
+// are replaced, and they assert if they are called from a thread that is
+// currently inside a ScopedNoAlloc section.
+// When disabled, ScopedNoAlloc is an empty object.
+class RealtimeAllocCheck
+{
+public:
+    class ScopedNoAlloc
+    {
+    public:
+        // If enabled is false, the section is not checked
+        // (e.g for the first hops, while the tmp buffers are growing)
+        ScopedNoAlloc(bool enabled = true);
+        ~ScopedNoAlloc();
+
+    protected:
+        bool _enabled;
+    };
+
+    static bool isInNoAllocSection();
+
+    // Called by the replaced operators
+    static void checkAllocation();
+};
+
+#endif
@@ -0,0 +1,113 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef RING_BUFFER_2D_H
+#define RING_BUFFER_2D_H
+
+#include <string.h>
+
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+// Fixed number of lines of the same width (e.g history x bins),
+// in one contiguous buffer
+//
+// Pushing a line replaces the oldest one, the other lines are not moved.
+// The lines can be read and written in place.
+template <typename T>
+class RingBuffer2D
+{
+public:
+    RingBuffer2D()
+    {
+        _height = 0;
+        _width = 0;
+        _pos = 0;
+    }
+    
+    virtual ~RingBuffer2D() {}
+
+    // Allocates, and fills with zeros
+    void resize(int height, int width)
+    {
+        _height = height;
+        _width = width;
+        
+        _data.resize(_height*_width);
+
+        clear();
+    }
+
+    int getHeight() const
+    {
+        return _height;
+    }
+    
+    int getWidth() const
+    {
+        return _width;
+    }
+
+    // Fill with zeros
+    void clear()
+    {
+        fill(_data.begin(), _data.end(), T());
+
+        _pos = 0;
+    }
+    
+    // Line 0 is the oldest, line height - 1 the most recent
+    T *getLine(int lineNum)
+    {
+        return &_data.data()[((_pos + lineNum) % _height)*_width];
+    }
+
+    const T *getLine(int lineNum) const
+    {
+        return &_data.data()[((_pos + lineNum) % _height)*_width];
+    }
+
+    // The oldest line becomes the most recent one, and is returned
+    // to be written in place (its content is not modified)
+    T *pushLine()
+    {
+        T *line = &_data.data()[_pos*_width];
+        
+        _pos = (_pos + 1) % _height;
+
+        return line;
+    }
+
+    // Copy width values in a new line
+    void pushLine(const T *line)
+    {
+        memcpy(pushLine(), line, _width*sizeof(T));
+    }
+    
+protected:
+    vector<T> _data;
+
+    int _height;
+    int _width;
+    
+    // Position of the oldest line
+    int _pos;
+};
+
+#endif
@@ -0,0 +1,213 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "Utils.h"
+#include "BufferKernels.h"
+#include "MagnPhaseKernels.h"
+
+#include "SplitSpectrum.h"
+
+SplitSpectrum::SplitSpectrum()
+{
+    _numBins = 0;
+    _validForms = 0;
+    _version = 0;
+}
+
+SplitSpectrum::~SplitSpectrum() {}
+
+void
+SplitSpectrum::resize(int numBins)
+{
+    _numBins = numBins;
+    
+    _complex.resize(_numBins);
+    _real.resize(_numBins);
+    _imag.resize(_numBins);
+    _magns.resize(_numBins);
+    _phases.resize(_numBins);
+
+    _validForms = 0;
+    _version++;
+}
+
+int
+SplitSpectrum::getNumBins() const
+{
+    return _numBins;
+}
+
+const vector<complex<float> > &
+SplitSpectrum::getComplex()
+{
+    updateComplex();
+    
+    return _complex;
+}
+
+const vector<float> &
+SplitSpectrum::getReal()
+{
+    updateSplit();
+
+    return _real;
+}
+
+const vector<float> &
+SplitSpectrum::getImag()
+{
+    updateSplit();
+
+    return _imag;
+}
+
+const vector<float> &
+SplitSpectrum::getMagns()
+{
+    updateMagnsPhases();
+
+    return _magns;
+}
+
+const vector<float> &
+SplitSpectrum::getPhases()
+{
+    updateMagnsPhases();
+
+    return _phases;
+}
+
+vector<complex<float> > *
+SplitSpectrum::editComplex(bool keepContent)
+{
+    if (keepContent)
+        updateComplex();
+
+    _validForms = FORM_COMPLEX;
+    _version++;
+    
+    return &_complex;
+}
+
+void
+SplitSpectrum::editSplit(vector<float> **real, vector<float> **imag,
+                         bool keepContent)
+{
+    if (keepContent)
+        updateSplit();
+
+    _validForms = FORM_SPLIT;
+    _version++;
+
+    *real = &_real;
+    *imag = &_imag;
+}
+
+void
+SplitSpectrum::editMagnsPhases(vector<float> **magns, vector<float> **phases,
+                               bool keepContent)
+{
+    if (keepContent)
+        updateMagnsPhases();
+
+    _validForms = FORM_MAGN_PHASE;
+    _version++;
+
+    *magns = &_magns;
+    *phases = &_phases;
+}
+
+void
+SplitSpectrum::setComplex(const vector<complex<float> > &comp)
+{
+    if (comp.size() != _numBins)
+        return;
+
+    _complex = comp;
+    
+    _validForms = FORM_COMPLEX;
+    _version++;
+}
+
+void
+SplitSpectrum::setMagnsPhases(const vector<float> &magns, const vector<float> &phases)
+{
+    if ((magns.size() != _numBins) || (phases.size() != _numBins))
+        return;
+    
+    _magns = magns;
+    _phases = phases;
+
+    _validForms = FORM_MAGN_PHASE;
+    _version++;
+}
+
+unsigned int
+SplitSpectrum::getVersion() const
+{
+    return _version;
+}
+
+void
+SplitSpectrum::updateComplex()
+{
+    if (_validForms & FORM_COMPLEX)
+        return;
+
+    if (_validForms & FORM_SPLIT)
+        BufferKernels::splitToComplex(_complex.data(), _real.data(), _imag.data(),
+                                      _numBins);
+    else if (_validForms & FORM_MAGN_PHASE)
+        MagnPhaseKernels::magnPhaseToComplex(_complex.data(),
+                                             _magns.data(), _phases.data(), _numBins);
+    else
+        // Nothing written yet
+        Utils::fillZero(&_complex);
+
+    _validForms |= FORM_COMPLEX;
+}
+
+void
+SplitSpectrum::updateSplit()
+{
+    if (_validForms & FORM_SPLIT)
+        return;
+
+    // Via the complex form, if it is not valid
+    // (no direct conversion from magnitudes and phases)
+    updateComplex();
+    
+    BufferKernels::complexToSplit(_real.data(), _imag.data(), _complex.data(),
+                                  _numBins);
+    
+    _validForms |= FORM_SPLIT;
+}
+
+void
+SplitSpectrum::updateMagnsPhases()
+{
+    if (_validForms & FORM_MAGN_PHASE)
+        return;
+
+    updateComplex();
+
+    MagnPhaseKernels::complexToMagnPhase(_magns.data(), _phases.data(),
+                                         _complex.data(), _numBins);
+    
+    _validForms |= FORM_MAGN_PHASE;
+}
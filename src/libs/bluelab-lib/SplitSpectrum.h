@@ -0,0 +1,96 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef SPLIT_SPECTRUM_H
+#define SPLIT_SPECTRUM_H
+
+#include <vector>
+#include <complex>
+using namespace std;
+
+// Spectrum of one fft frame, in several forms:
+// - complex: interleaved, the layout of the fft engines
+// - split: real and imaginary parts in separate buffers, for the SIMD code
+// - magnitudes and phases
+//
+// Only the forms that are read are computed, once after each modification.
+// Writing one form invalidates the others.
+// The vectors must not be resized by the callers.
+class SplitSpectrum
+{
+public:
+    SplitSpectrum();
+    virtual ~SplitSpectrum();
+
+    // Allocates, and invalidates the content
+    void resize(int numBins);
+    int getNumBins() const;
+
+    // Read, converted if necessary
+    const vector<complex<float> > &getComplex();
+    const vector<float> &getReal();
+    const vector<float> &getImag();
+    const vector<float> &getMagns();
+    const vector<float> &getPhases();
+
+    // Write
+    // If keepContent is false, the content is not converted first
+    // (e.g when it is overwritten by the fft)
+    vector<complex<float> > *editComplex(bool keepContent = true);
+    void editSplit(vector<float> **real, vector<float> **imag,
+                   bool keepContent = true);
+    void editMagnsPhases(vector<float> **magns, vector<float> **phases,
+                         bool keepContent = true);
+
+    // Copy, without conversion
+    void setComplex(const vector<complex<float> > &comp);
+    void setMagnsPhases(const vector<float> &magns, const vector<float> &phases);
+
+    // Incremented at each write, to invalidate the data derived
+    // from the spectrum (see FrameContext)
+    unsigned int getVersion() const;
+    
+protected:
+    enum Form
+    {
+        FORM_COMPLEX = 1,
+        FORM_SPLIT = 2,
+        FORM_MAGN_PHASE = 4
+    };
+    
+    void updateComplex();
+    void updateSplit();
+    void updateMagnsPhases();
+    
+    int _numBins;
+    
+    // Valid forms (Form flags)
+    int _validForms;
+
+    unsigned int _version;
+    
+    vector<complex<float> > _complex;
+    
+    vector<float> _real;
+    vector<float> _imag;
+    
+    vector<float> _magns;
+    vector<float> _phases;
+};
+
+#endif
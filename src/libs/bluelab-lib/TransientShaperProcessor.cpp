@@ -68,22 +68,18 @@ TransientShaperProcessor::setFreqAmpRatio(float ratio)
 
 void
 TransientShaperProcessor::
-processFFT(vector<complex<float> > *ioBuffer)
+processFrame(FrameContext *ioFrame)
 {
     if (fabs(_softHard) < BL_EPS)
         return;
     
     // Seems hard to take half of fft, since we work in sample space too...
-    
-    vector<complex<float> > &fftBuffer = _tmpBuf1;
 
-    vector<complex<float> > bufferResized = *ioBuffer;
-    bufferResized.resize(bufferResized.size() - 1);
-    Utils::fillSecondFftHalf(bufferResized, &fftBuffer);
-    
+    // Full spectrum, mirrored from the magnitudes and phases of the frame
+    // (shared with the previous processors, so they are not recomputed)
     vector<float> &magns = _tmpBuf2;
-    vector<float> &phases = _tmpBuf3;
-    Utils::complexToMagnPhase(&magns, &phases, fftBuffer);
+    magns = ioFrame->getFullMagns();
+    const vector<float> &phases = ioFrame->getFullPhases();
 
     // Fix magnitudes ammplitudes for TransientLib
     Utils::multValue(&magns, magns.size()/4);
@@ -37,7 +37,7 @@ public:
     
     void setFreqAmpRatio(float ratio);
     
-    void processFFT(vector<complex<float> > *ioBuffer) override;
+    void processFrame(FrameContext *ioFrame) override;
 
     void processSamples(vector<float> *ioBuffer) override;
         
@@ -66,7 +66,6 @@ protected:
 private:
     // Tmp buffers
     vector<float> _tmpBuf0;
-    vector<complex<float> > _tmpBuf1;
     vector<float> _tmpBuf2;
     vector<float> _tmpBuf3;
     vector<float> _tmpBuf4;
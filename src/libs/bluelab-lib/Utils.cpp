@@ -20,6 +20,8 @@
 
 #include "Defines.h"
 #include "ParamSmoother.h"
+#include "MagnPhaseKernels.h"
+#include "BufferKernels.h"
 #include "Utils.h"
 
 void
@@ -30,12 +32,8 @@ Utils::complexToMagnPhase(vector<float> *resultMagns,
     resultMagns->resize(complexBuf.size());
     resultPhases->resize(complexBuf.size());
 
-    for (int i = 0; i < complexBuf.size(); i++)
-    {
-        const complex<float> &c = complexBuf[i];
-        (*resultMagns)[i] = abs(c);
-        (*resultPhases)[i] = arg(c);
-    }
+    MagnPhaseKernels::complexToMagnPhase(resultMagns->data(), resultPhases->data(),
+                                         complexBuf.data(), complexBuf.size());
 }
 
 void
@@ -45,8 +43,8 @@ Utils::magnPhaseToComplex(vector<complex<float> > *complexBuf,
 {
     complexBuf->resize(magns.size());
 
-    for (int i = 0; i < magns.size(); i++)
-        (*complexBuf)[i] = polar(magns[i], phases[i]);
+    MagnPhaseKernels::magnPhaseToComplex(complexBuf->data(), magns.data(), phases.data(),
+                                         magns.size());
 }
 
 void
@@ -54,15 +52,7 @@ Utils::complexToMagn(vector<float> *result, const vector<complex<float> > &compl
 {
     result->resize(complexBuf.size());
     
-    int complexBufSize = complexBuf.size();
-    const complex<float> *complexBufData = complexBuf.data();
-    float *resultData = result->data();
-    
-    for (int i = 0; i < complexBufSize; i++)
-    {
-        float magn = abs(complexBufData[i]);
-        resultData[i] = magn;
-    }
+    MagnPhaseKernels::complexToMagn(result->data(), complexBuf.data(), complexBuf.size());
 }
 
 void
@@ -114,112 +104,76 @@ Utils::resizeFillZeros(vector<float> *buf, int newSize)
 void
 Utils::addBuffers(vector<float> *buf0, const vector<float> &buf1)
 {    
-    for (int i = 0; i < buf0->size(); i++)
-        (*buf0)[i] += buf1[i];
+    BufferKernels::add(buf0->data(), buf1.data(), buf0->size());
 }
 
 void
 Utils::addBuffers(vector<complex<float> > *buf0, const vector<complex<float> > &buf1)
 {    
-    for (int i = 0; i < buf0->size(); i++)
-        (*buf0)[i] += buf1[i];
+    BufferKernels::add(buf0->data(), buf1.data(), buf0->size());
 }
 
 void
 Utils::addBuffers(vector<float> *result, const vector<float> &buf0, const vector<float> &buf1)
 {
     result->resize(buf0.size());
-    
-    for (int i = 0; i < buf0.size(); i++)
-        (*result)[i] = buf0[i] + buf1[i];
+
+    BufferKernels::add(result->data(), buf0.data(), buf1.data(), buf0.size());
 }
 
 void
 Utils::multBuffers(vector<complex<float> > *buf0, const vector<float> &buf1)
 {
-    for (int i = 0; i < buf0->size(); i++)
-        (*buf0)[i] *= buf1[i];
+    BufferKernels::mult(buf0->data(), buf1.data(), buf0->size());
 }
 
 void
 Utils::multBuffers(vector<complex<float> > *buf0, const vector<complex<float> > &buf1)
 {
-    for (int i = 0; i < buf0->size(); i++)
-        (*buf0)[i] *= buf1[i];
+    BufferKernels::mult(buf0->data(), buf1.data(), buf0->size());
 }
 
 void
 Utils::multBuffers(vector<float> *buf,
                    const vector<float> &values)
 {
-    int bufSize = buf->size();
-    float  *bufData = buf->data();
-    const float *valuesData = values.data();
-     
-    for (int i = 0; i < bufSize; i++)
-    {
-        float val = valuesData[i];
-        bufData[i] *= val;
-    }
+    BufferKernels::mult(buf->data(), values.data(), buf->size());
 }
 
 void
 Utils::substractBuffers(vector<float> *ioBuf, const vector<float> &subBuf)
 {
-    int ioBufSize = ioBuf->size();
-    float *ioBufData = ioBuf->data();
-    const float *subBufData = subBuf.data();
-        
-    for (int i = 0; i < ioBufSize; i++)
-    {
-        float val = ioBufData[i];
-        float sub = subBufData[i];
-        
-        val -= sub;
-        
-        ioBufData[i] = val;
-    }
+    BufferKernels::substract(ioBuf->data(), subBuf.data(), ioBuf->size());
 }
 
 void
 Utils::substractBuffers(vector<complex<float> > *buf0, const vector<complex<float> > &buf1)
 {
-    for (int i = 0; i < buf0->size(); i++)
-        (*buf0)[i] -= buf1[i];
+    BufferKernels::substract(buf0->data(), buf1.data(), buf0->size());
 }
 
 void
 Utils::multValue(vector<float> *buf, float val)
 {
-    for (int i = 0; i < buf->size(); i++)
-        (*buf)[i] *= val;
+    BufferKernels::multValue(buf->data(), val, buf->size());
 }
 
 void
 Utils::multValue(vector<complex<float> > *buf, float val)
 {
-    for (int i = 0; i < buf->size(); i++)
-        (*buf)[i] *= val;
+    BufferKernels::multValue(buf->data(), val, buf->size());
 }
 
 void
 Utils::computeNormOpposite(vector<float> *buf)
 {
-    for (int i = 0; i < buf->size(); i++)
-        (*buf)[i] = 1.0 - (*buf)[i];
+    BufferKernels::computeNormOpposite(buf->data(), buf->size());
 }
 
 void
 Utils::computeSquareConjugate(vector<complex<float> > *buf)
 {
-    complex<float> conj;
-    complex<float> tmp;
-    for (int i = 0; i < buf->size(); i++)
-    {
-        complex<float> &c = (*buf)[i];
-        complex<float> cj = std::conj(c);
-        c = cj*c;
-    }
+    BufferKernels::computeSquareConjugate(buf->data(), buf->size());
 }
 
 float
@@ -322,43 +276,22 @@ Utils::DBToAmp(float dbVal)
 void
 Utils::DBToAmp(vector<float> *ioBuf)
 {
-    int ioBufSize = ioBuf->size();
-    float *ioBufData = ioBuf->data();
-    
-    for (int i = 0; i < ioBufSize; i++)
-    {
-        float db = ioBufData[i];
-        
-        float amp = Utils::DBToAmp(db);
-        
-        ioBufData[i] = amp;
-    }
+    BufferKernels::DBToAmp(ioBuf->data(), ioBuf->size());
 }
 
 void
 Utils::ampToDB(vector<float> *dBBuf, const vector<float> &ampBuf, float eps, float minDB)
 {
     dBBuf->resize(ampBuf.size());
-    
-    for (int i = 0; i < ampBuf.size(); i++)
-    {
-        float amp = ampBuf[i];
-        float dbAmp = ampToDB(ampBuf[i], eps, minDB);
-        (*dBBuf)[i] = dbAmp;
-    }
+
+    BufferKernels::ampToDB(dBBuf->data(), ampBuf.data(), ampBuf.size(), eps, minDB);
 }
 
 void
 Utils::ampToDB(float *dBBuf, const float *ampBuf, int bufSize,
                float eps, float minDB)
 {
-    for (int i = 0; i < bufSize; i++)
-    {
-        float amp = ampBuf[i];
-        float dbAmp = ampToDB(amp, eps, minDB);
-        
-        dBBuf[i] = dbAmp;
-    }
+    BufferKernels::ampToDB(dBBuf, ampBuf, bufSize, eps, minDB);
 }
 
 float
@@ -422,34 +355,13 @@ Utils::applyGamma(float t, float gamma)
 void
 Utils::clipMax(vector<float> *values, float maxValue)
 {
-    int valuesSize = values->size();
-    float *valuesBuf = values->data();
-        
-    for (int i = 0; i < valuesSize; i++)
-    {
-        float val = valuesBuf[i];
-        
-        if (val > maxValue)
-            val = maxValue;
-        
-        valuesBuf[i] = val;
-    }
+    BufferKernels::clipMax(values->data(), maxValue, values->size());
 }
 
 void
 Utils::clipMin(vector<float> *values, float minVal)
 {
-    int valuesSize = values->size();
-    float *valuesData = values->data();
-       
-    for (int i = 0; i < valuesSize; i++)
-    {
-        float val = valuesData[i];
-        if (val < minVal)
-            val = minVal;
-        
-        valuesData[i] = val;
-    }
+    BufferKernels::clipMin(values->data(), minVal, values->size());
 }
 
 void
@@ -781,12 +693,7 @@ Utils::mixParamToCoeffs(float mix,
 void
 Utils::computeOpposite(vector<float> *buf)
 {
-    for (int i = 0; i < buf->size(); i++)
-    {
-        float val = buf->data()[i];
-        val = 1.0f - val;
-        buf->data()[i] = val;
-    }
+    BufferKernels::computeNormOpposite(buf->data(), buf->size());
 }
 
 void
@@ -800,6 +707,17 @@ Utils::applyGain(const vector<float> &in, vector<float> *out, ParamSmoother *smo
     }
 }
 
+void
+Utils::applyGain(const float *in, float *out, int numSamples, ParamSmoother *smoother)
+{    
+    for (int i = 0; i < numSamples; i++)
+    {
+        float gain = smoother->process();
+
+        out[i] = in[i]*gain;
+    }
+}
+
 void
 Utils::fillMissingValues(vector<float> *values,
                          bool extendBounds, float undefinedValue)
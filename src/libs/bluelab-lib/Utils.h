@@ -28,6 +28,7 @@ class ParamSmoother;
 class Utils
 {
  public:
+    // SIMD versions if available (see MagnPhaseKernels for the precision)
     static void complexToMagnPhase(vector<float> *resultMagns,
                                    vector<float> *resultPhases,
                                    const vector<complex<float> > &complexBuf);
@@ -47,6 +48,7 @@ class Utils
     
     static void resizeFillZeros(vector<float> *buf, int newSize);
 
+    // Buffer arithmetic: SIMD versions if available (see BufferKernels)
     static void addBuffers(vector<float> *buf0, const vector<float> &buf1);
     static void addBuffers(vector<complex<float> > *buf0, const vector<complex<float> > &buf1);
     static void addBuffers(vector<float> *result, const vector<float> &buf0, const vector<float> &buf1);
@@ -139,6 +141,8 @@ class Utils
     static void computeOpposite(vector<float> *buf);
 
     static void applyGain(const vector<float> &in, vector<float> *out, ParamSmoother *smoother);
+    static void applyGain(const float *in, float *out, int numSamples,
+                          ParamSmoother *smoother);
 
     static void fillMissingValues(vector<float> *values,
                                   bool extendBounds, float undefinedValue);
@@ -18,44 +18,24 @@
 
 #include "Defines.h"
 #include "Utils.h"
+#include "BufferKernels.h"
 #include "Window.h"
+#include "Profiler.h"
 #include "WienerSoftMasking.h"
 
 // Optimization
 #define USE_FAKE_MASK1 1
 
-WienerSoftMasking::HistoryLine::HistoryLine()
-{
-    _size = 0;
-}
-
-WienerSoftMasking::HistoryLine::HistoryLine(const HistoryLine &other)
-{
-    _size = other._size;
-
-    resize(_size);
-    
-    _sum = other._sum;
-    _masked0Square = other._masked0Square;
-    _masked1Square = other._masked1Square;
-}
-
-WienerSoftMasking::HistoryLine::~HistoryLine() {}
+// Recompute the running sums from the history after this number of hops,
+// so the rounding errors don't accumulate
+#define SIGMA2_RESYNC_PERIOD 1024
 
 void
-WienerSoftMasking::HistoryLine::resize(int size)
+WienerSoftMasking::Sigma2Sums::clear(int size)
 {
-    _size = size;
-    
-    _sum.resize(_size);
-    _masked0Square.resize(_size);
-    _masked1Square.resize(_size);
-}
-
-int
-WienerSoftMasking::HistoryLine::getSize()
-{
-    return _size;
+    _sum.assign(size, 0.0);
+    _re.assign(size, 0.0);
+    _im.assign(size, 0.0);
 }
 
 WienerSoftMasking::WienerSoftMasking(int bufferSize, int overlap, int historySize)
@@ -64,6 +44,16 @@ WienerSoftMasking::WienerSoftMasking(int bufferSize, int overlap, int historySiz
     _overlap = overlap;
     
     _historySize = historySize;
+    _lookahead = LOOKAHEAD_CENTERED;
+    _historyFilled = false;
+    _powersPrimed = false;
+    
+    _windowSumInv = 0.0;
+    _windowLookahead = LOOKAHEAD_CENTERED;
+    
+    _sigma2Mode = SIGMA2_HANN;
+    _sigma2SumsValid = false;
+    _numSigma2Updates = 0;
     
     _processingEnabled = true;
 }
@@ -81,8 +71,12 @@ WienerSoftMasking::reset(int bufferSize, int overlap)
 
 void
 WienerSoftMasking::reset()
-{    
-    _history.resize(0);
+{
+    // Filled again with the next line (allocated if the size changed)
+    _historyFilled = false;
+    _powersPrimed = false;
+
+    _sigma2SumsValid = false;
 }
 
 void
@@ -99,6 +93,49 @@ WienerSoftMasking::getHistorySize()
     return _historySize;
 }
 
+void
+WienerSoftMasking::setLookahead(int lookahead)
+{
+    _lookahead = lookahead;
+}
+
+int
+WienerSoftMasking::getLookahead()
+{
+    // The index where we get the data (from the end)
+    // (this covers the case of odd and even history size)
+    if (_lookahead == LOOKAHEAD_CENTERED)
+        return (_historySize - 1) - _historySize/2;
+
+    if (_lookahead < 0)
+        return 0;
+    
+    if (_lookahead > _historySize - 1)
+        return _historySize - 1;
+    
+    return _lookahead;
+}
+
+bool
+WienerSoftMasking::isLookaheadCentered()
+{
+    return (getLookahead() == (_historySize - 1) - _historySize/2);
+}
+
+void
+WienerSoftMasking::setSigma2Mode(Sigma2Mode mode)
+{
+    _sigma2Mode = mode;
+
+    _sigma2SumsValid = false;
+}
+
+WienerSoftMasking::Sigma2Mode
+WienerSoftMasking::getSigma2Mode()
+{
+    return _sigma2Mode;
+}
+
 void
 WienerSoftMasking::setProcessingEnabled(bool flag)
 {
@@ -115,14 +152,9 @@ int
 WienerSoftMasking::getLatency()
 {
     // In history, we push_back() and pop_front()
-    // and we take the index historySize/2
-    //
-
-    // The index where we get the data (from the end)
-    // (this covers the case of odd and even history size)
-    // Index 0 has 0 latency, since we have just added the current data to it.
-    int revIndex = (_historySize - 1) - _historySize/2;
-    int latency = revIndex*(_bufferSize/_overlap);
+    // and we take the index (historySize - 1) - lookahead
+    // Index historySize - 1 has 0 latency, since we have just added the current data to it.
+    int latency = getLookahead()*(_bufferSize/_overlap);
     
     return latency;
 }
@@ -142,240 +174,428 @@ WienerSoftMasking::processCentered(vector<complex<float> > *ioSum,
                                    vector<complex<float> > *ioMaskedResult0,
                                    vector<complex<float> > *ioMaskedResult1)
 {
+    Profiler::ScopedTimer timer(Profiler::STAGE_SOFT_MASKING);
 
-    HistoryLine &newHistoLine = _tmpHistoryLine;
-    newHistoLine.resize(ioSum->size());
-
-    newHistoLine._sum = *ioSum;
-
-    // Optim: compute square history only if enabled
-    // Otherwise, fill with zeros
+    int size = ioSum->size();
+    
+    bool primePowers = pushHistoryLine(*ioSum, 2);
+    
+    const complex<float> *centeredSum = getCenteredSum();
+    
+    // Optim: compute power history only if enabled
+    // Otherwise, only the input lines are delayed
     if (_processingEnabled)
     {
+        float *newPower0 = _historyMaskedPowers[0].getLine(_historySize - 1);
+        float *newPower1 = _historyMaskedPowers[1].getLine(_historySize - 1);
+        
         // masked0 = sum*mask
-        newHistoLine._masked0Square = *ioSum;
-        Utils::multBuffers(&newHistoLine._masked0Square, mask);
-
         // maskd1 = sum - masked0
         // same as: masked1 = sum*(1 - mask)
-        newHistoLine._masked1Square = *ioSum;
-        Utils::substractBuffers(&newHistoLine._masked1Square,
-                                newHistoLine._masked0Square);
         
         // See: https://hal.inria.fr/hal-01881425/document
         // |x|^2
-        // NOTE: square abs => complex conjugate
         
-        // Compute squares (using complex conjugate)
-        Utils::computeSquareConjugate(&newHistoLine._masked0Square);
-        Utils::computeSquareConjugate(&newHistoLine._masked1Square);
+        // Compute the masked values and their powers in one pass
+        BufferKernels::computeMaskedPowers(newPower0, newPower1,
+                                           ioSum->data(), mask.data(), size);
+        
+        updateHistoryLine(primePowers);
+        
+        // Result when enabled
+        ioMaskedResult0->resize(size);
+        
+        // Mask 1
+        if (ioMaskedResult1 == NULL)
+        {
+            computeSoftMasks(1);
+            
+            // Apply mask 0
+            BufferKernels::multMaskValue(ioMaskedResult0->data(), centeredSum,
+                                         _softMasks[0].data(), 1.0, size);
+        }
+        else
+        {
+            ioMaskedResult1->resize(size);
+            
+#if USE_FAKE_MASK1
+            computeSoftMasks(1);
+            
+            // Simple difference, in the same pass as mask 0
+            BufferKernels::applyMask(ioMaskedResult0->data(), ioMaskedResult1->data(),
+                                     centeredSum, _softMasks[0].data(), size);
+#else
+            // Use real mask for second mask
+            computeSoftMasks(2);
+            
+            BufferKernels::multMaskValue(ioMaskedResult0->data(), centeredSum,
+                                         _softMasks[0].data(), 1.0, size);
+            BufferKernels::multMaskValue(ioMaskedResult1->data(), centeredSum,
+                                         _softMasks[1].data(), 1.0, size);
+#endif
+        }
     }
-    else // Not enabled, fill history with zeros
+    
+    // Update the data from the history even if processing enabled is false,
+    
+    // Compute the centered values
+    // Shifted input data
+    memcpy(ioSum->data(), centeredSum, size*sizeof(complex<float>));
+}
+
+void
+WienerSoftMasking::processCentered(vector<complex<float> > *ioSum,
+                                   const vector<vector<float> > &masks,
+                                   vector<vector<complex<float> > > *ioMaskedResults)
+{
+    Profiler::ScopedTimer timer(Profiler::STAGE_SOFT_MASKING);
+
+    int size = ioSum->size();
+    int numSources = masks.size();
+    if (numSources == 0)
+        return;
+    
+    bool primePowers = pushHistoryLine(*ioSum, numSources);
+
+    const complex<float> *centeredSum = getCenteredSum();
+    
+    if (_processingEnabled)
     {
-        newHistoLine._masked0Square.resize(ioSum->size());
-        Utils::fillZero(&newHistoLine._masked0Square);
+        for (int k = 0; k < numSources; k++)
+        {
+            float *newPower = _historyMaskedPowers[k].getLine(_historySize - 1);
+            BufferKernels::computeMaskedPower(newPower, ioSum->data(),
+                                              masks[k].data(), size);
+        }
+        
+        updateHistoryLine(primePowers);
+        
+        computeSoftMasks(numSources);
         
-        newHistoLine._masked1Square.resize(ioSum->size());
-        Utils::fillZero(&newHistoLine._masked1Square);
+        ioMaskedResults->resize(numSources);
+        for (int k = 0; k < numSources; k++)
+        {
+            (*ioMaskedResults)[k].resize(size);
+            BufferKernels::multMaskValue((*ioMaskedResults)[k].data(), centeredSum,
+                                         _softMasks[k].data(), 1.0, size);
+        }
     }
     
-    // Manage the history
-    if (_history.empty())
+    memcpy(ioSum->data(), centeredSum, size*sizeof(complex<float>));
+}
+
+bool
+WienerSoftMasking::pushHistoryLine(const vector<complex<float> > &sum, int numSources)
+{
+    int size = sum.size();
+    
+    // The input lines, also delayed when the processing is disabled
+    bool fillSums = (!_historyFilled ||
+                     (_historySums.getHeight() != _historySize) ||
+                     (_historySums.getWidth() != size));
+    if (fillSums)
     {
-        // Fill the whole history with the first line
-        _history.resize(_historySize);
-        _history.clear(newHistoLine);
+        _historySums.resize(_historySize, size);
+
+        _powersPrimed = false;
     }
-    else
+
+    // The oldest line is overwritten in place
+    complex<float> *newSum = _historySums.pushLine();
+    memcpy(newSum, sum.data(), size*sizeof(complex<float>));
+
+    if (fillSums)
     {
-        _history.freeze();
-        _history.push_pop(newHistoLine);
+        // Fill the whole history with the first line
+        for (int j = 0; j < _historySize - 1; j++)
+            memcpy(_historySums.getLine(j), newSum, size*sizeof(complex<float>));
+
+        _historyFilled = true;
     }
     
-    if (_processingEnabled)
+    if (!_processingEnabled)
     {
-        vector<complex<float> > &sigma2Mask0 = _tmpBuf0;
-        vector<complex<float> > &sigma2Mask1 = _tmpBuf1;
-        computeSigma2(&sigma2Mask0, &sigma2Mask1);
-
-        complex<float> *s0Data = sigma2Mask0.data();
-        complex<float> *s1Data = sigma2Mask1.data();
-        
-        // Create the mask
-        if (_history.empty()) // Just in case
-            return;
+        // Bypass, the powers will be primed again with the next enabled line
+        _powersPrimed = false;
+        _sigma2SumsValid = false;
 
-        vector<complex<float> > &softMask0 = _tmpBuf4;
-        softMask0.resize(_history[0].getSize());
-
-        int softMask0Size = softMask0.size();
-        complex<float> *softMask0Data = softMask0.data();
-        
-        // Compute soft mask 0
-        complex<float> csum;
-        complex<float> maskVal;
-        for (int i = 0; i < softMask0Size; i++)
+        return false;
+    }
+    
+    bool primePowers = (!_powersPrimed || (_historyMaskedPowers.size() != numSources));
+    if (primePowers)
+    {
+        _historyMaskedPowers.resize(numSources);
+        for (int k = 0; k < numSources; k++)
         {
-            const complex<float> &s0 = s0Data[i];
-            const complex<float> &s1 = s1Data[i];
+            RingBuffer2D<float> &powers = _historyMaskedPowers[k];
+            if ((powers.getHeight() != _historySize) || (powers.getWidth() != size))
+                powers.resize(_historySize, size);
+        }
 
-            // Compute s0 + s1
-            csum = s0;
-            csum += s1;
+        _sigma2Sums.resize(numSources);
+    }
+    else if ((_sigma2Mode != SIGMA2_HANN) && _sigma2SumsValid)
+    {
+        for (int k = 0; k < numSources; k++)
+            removeOldestSigma2(&_sigma2Sums[k], _historyMaskedPowers[k].getLine(0));
+    }
+    
+    for (int k = 0; k < numSources; k++)
+        _historyMaskedPowers[k].pushLine();
 
-            maskVal = complex<float>(0.0, 0.0);
+    return primePowers;
+}
 
-            if ((std::fabs(csum.real()) > BL_EPS) ||
-                (std::fabs(csum.imag()) > BL_EPS))
-                maskVal = s0 / csum;
-            
-            float maskMagn = abs(maskVal);
-
-            // Limit to 1
-            if (maskMagn >  1.0)
-            {
-                float maskMagnInv = 1.0/maskMagn;
-                maskVal *= maskMagnInv;
-            }
+void
+WienerSoftMasking::updateHistoryLine(bool primePowers)
+{
+    int size = _historySums.getWidth();
+    int numSources = _historyMaskedPowers.size();
+    
+    if (primePowers)
+    {
+        // Fill the whole power history with the first line
+        for (int k = 0; k < numSources; k++)
+        {
+            RingBuffer2D<float> &powers = _historyMaskedPowers[k];
             
-            softMask0Data[i] = maskVal;
+            const float *newPower = powers.getLine(_historySize - 1);
+            for (int j = 0; j < _historySize - 1; j++)
+                memcpy(powers.getLine(j), newPower, size*sizeof(float));
         }
-
-        // Result when enabled
         
-        // Apply mask 0
-        *ioMaskedResult0 = _history[_history.size()/2]._sum;
-        Utils::multBuffers(ioMaskedResult0, softMask0);
-
-        // Mask 1
-        if (ioMaskedResult1 != NULL)
-        {
-#if USE_FAKE_MASK1
-            // Simple difference
-            *ioMaskedResult1 = _history[_history.size()/2]._sum;;
-            Utils::substractBuffers(ioMaskedResult1, *ioMaskedResult0);
-#else
-            // Use real mask for second mask
-            
-            vector<complex<float> > &softMask1 = _tmpBuf5;
-            softMask1.resize(_history[0].size());
+        _powersPrimed = true;
+        _sigma2SumsValid = false;
+    }
+    else if ((_sigma2Mode != SIGMA2_HANN) && _sigma2SumsValid)
+    {
+        for (int k = 0; k < numSources; k++)
+            addNewestSigma2(&_sigma2Sums[k],
+                            _historyMaskedPowers[k].getLine(_historySize - 1));
 
-            int softMask1Size = softMask1.size();
-            complex<float> *softMask1Data = softMask1.data();
-        
-            // Compute soft mask 1
-            complex<float> csum;
-            complex<float> maskVal;
-            for (int i = 0; i < softMask1Size; i++)
-            {
-                const complex<float> &s0 = s0Data[i];
-                const complex<float> &s1 = s1Data[i];
-                
-                // Compute s0 + s1
-                csum = s0;
-                csum += s1;
-        
-                if ((fabs(csum.real()) > BL_EPS) ||
-                    (fabs(csum.imag()) > BL_EPS))
-                    maskVal = s1 / sum;
-
-                BL_float maskMagn = abs(maskVal);
-
-                // Limit to 1
-                if (maskMagn >  1.0)
-                {
-                    float maskMagnInv = 1.0/maskMagn;
-                    maskVal *= maskMagnInv;
-                }
-                    
-                softMask1Data[i] = maskVal;
-            }
-
-            // Apply mask 1
-            *ioMaskedResult1 = _history[_history.size()/2]._sum;
-            Utils::MultBuffers(ioMaskedResult1, softMask1);
-#endif
-        }
+        _numSigma2Updates++;
     }
+}
+
+const complex<float> *
+WienerSoftMasking::getCenteredSum()
+{
+    // Centered line (or more recent, with a shorter lookahead)
+    return _historySums.getLine((_historySize - 1) - getLookahead());
+}
+
+void
+WienerSoftMasking::computeSoftMasks(int numMasks)
+{
+    int size = _historySums.getWidth();
+    int numSources = _historyMaskedPowers.size();
     
-    // Update the data from the history even if processing enabled is false,
+    computeSigma2(&_sigma2);
+
+    // Sum of the variances
+    vector<float> &sigma2Sum = _tmpBuf0;
+    sigma2Sum.resize(size);
+    if (numSources == 1)
+        memcpy(sigma2Sum.data(), _sigma2[0].data(), size*sizeof(float));
+    else
+    {
+        BufferKernels::add(sigma2Sum.data(), _sigma2[0].data(), _sigma2[1].data(), size);
+        for (int k = 2; k < numSources; k++)
+            BufferKernels::add(sigma2Sum.data(), _sigma2[k].data(), size);
+    }
     
-    // Compute the centered values
-    if (!_history.empty())
-        // Shifted input data
-        *ioSum = _history[_history.size()/2]._sum;
+    // Normalize, limited to [0, 1]
+    _softMasks.resize(numSources);
+    for (int k = 0; k < numMasks; k++)
+    {
+        _softMasks[k].resize(size);
+        BufferKernels::normalizeSoftMask(_softMasks[k].data(), _sigma2[k].data(),
+                                         sigma2Sum.data(), BL_EPS, size);
+    }
 }
 
 // Variance is equal to sigma^2
 void
-WienerSoftMasking::computeSigma2(vector<complex<float> > *outSigma2Mask0,
-                                 vector<complex<float> > *outSigma2Mask1)
+WienerSoftMasking::computeSigma2(vector<vector<float> > *outSigma2)
 {    
-    if (_history.empty())
+    if (!_powersPrimed)
         return;
+
+    int size = _historySums.getWidth();
+    int historySize = _historySums.getHeight();
+    int numSources = _historyMaskedPowers.size();
     
-    outSigma2Mask0->resize(_history[0].getSize());
-    outSigma2Mask1->resize(_history[0].getSize());
-    
-    // Result sum 0
-    vector<complex<float> > &currentSum0 = _tmpBuf2;
-    currentSum0.resize(_history[0].getSize());
-    Utils::fillZero(&currentSum0);
+    outSigma2->resize(numSources);
+    for (int k = 0; k < numSources; k++)
+        (*outSigma2)[k].resize(size);
 
-    complex<float> *currentSum0Data = currentSum0.data();
+    updateWindow();
     
-    // Result sum 1
-    vector<complex<float> > &currentSum1 = _tmpBuf3;
-    currentSum1.resize(_history[0].getSize());
-    Utils::fillZero(&currentSum1);
+    // The recursive sums give the Hann window of the whole history
+    bool useSums = ((_sigma2Mode == SIGMA2_HANN_RECURSIVE) && (historySize >= 2) &&
+                    isLookaheadCentered());
+    if (useSums)
+    {
+        if (!_sigma2SumsValid || (_numSigma2Updates >= SIGMA2_RESYNC_PERIOD))
+            resyncSigma2Sums();
 
-    complex<float> *currentSum1Data = currentSum1.data();
+        for (int k = 0; k < numSources; k++)
+            computeSigma2Sums(_sigma2Sums[k], &(*outSigma2)[k]);
+        
+        return;
+    }
+    
+    // Result sums
+    for (int k = 0; k < numSources; k++)
+        Utils::fillZero(&(*outSigma2)[k]);
     
-    // Window
-    if (_window.size() != _history.size())
+    // All the sources in the same pass over the history
+    for (int j = 0; j < historySize; j++)
+    {
+        float p = _window[j];
+
+        // expect += p*val
+        for (int k = 0; k < numSources; k++)
+            BufferKernels::addMultValue((*outSigma2)[k].data(),
+                                        _historyMaskedPowers[k].getLine(j), p, size);
+    }
+
+    // Divide by sum probas
+    if (_windowSumInv > 0.0)
     {
-        _window.resize(_history.size());
+        for (int k = 0; k < numSources; k++)
+            BufferKernels::multValue((*outSigma2)[k].data(), _windowSumInv, size);
+    }
+}
+
+void
+WienerSoftMasking::updateWindow()
+{
+    int lookahead = getLookahead();
+    if ((_window.size() == _historySums.getHeight()) && (lookahead == _windowLookahead))
+        return;
+
+    _windowLookahead = lookahead;
+    
+    _window.resize(_historySums.getHeight());
+    if (isLookaheadCentered())
         Window::makeWindowHann(&_window);
+    else
+    {
+        // Hann window centered on the processed line,
+        // large enough for the past and the future lines
+        int center = (_window.size() - 1) - lookahead;
+        int halfSize = (center > lookahead) ? center : lookahead;
+        
+        vector<float> win;
+        win.resize(2*halfSize + 1);
+        Window::makeWindowHann(&win);
+
+        for (int j = 0; j < _window.size(); j++)
+            _window[j] = win[j - center + halfSize];
     }
     
     float sumProba = Utils::computeSum(_window);
-    float sumProbaInv = 0.0;
+    _windowSumInv = 0.0;
     if (sumProba > BL_EPS)
-        sumProbaInv = 1.0/sumProba;
+        _windowSumInv = 1.0/sumProba;
+}
+
+void
+WienerSoftMasking::resyncSigma2Sums()
+{
+    for (int k = 0; k < _sigma2Sums.size(); k++)
+        resyncSigma2Sums(&_sigma2Sums[k], k);
+
+    _sigma2SumsValid = true;
+    _numSigma2Updates = 0;
+}
+
+void
+WienerSoftMasking::resyncSigma2Sums(Sigma2Sums *sums, int sourceNum)
+{
+    int size = _historySums.getWidth();
+    sums->clear(size);
     
-    for (int j = 0; j < _history.size(); j++)
+    int historySize = _historySums.getHeight();
+    double w = 2.0*M_PI/(historySize - 1);
+
+    const RingBuffer2D<float> &powers = _historyMaskedPowers[sourceNum];
+    
+    for (int j = 0; j < historySize; j++)
     {
-        const HistoryLine &line = _history[j];
-        
-        const vector<complex<float> > &line0 = line._masked0Square;
-        int line0Size = line0.size();
-        const complex<float> *line0Data = line0.data();
+        const float *line = powers.getLine(j);
         
-        const vector<complex<float> > &line1 = line._masked1Square;
-        const complex<float> *line1Data = line1.data();
-        
-        float p = _window[j];
-        
-        for (int i = 0; i < line0Size; i++)
+        double c = cos(w*j);
+        double sn = sin(w*j);
+        for (int i = 0; i < size; i++)
         {
-            complex<float> &expect0 = currentSum0Data[i];
-            const complex<float> &val0 = line0Data[i];
-            expect0 += p * val0;
-
-            complex<float> &expect1 = currentSum1Data[i];
-            const complex<float> &val1 = line1Data[i];
-            expect1 += p * val1;
+            double x = line[i];
+            
+            sums->_sum[i] += x;
+            sums->_re[i] += x*c;
+            sums->_im[i] += x*sn;
         }
     }
+}
 
-    // Divide by sum probas
-    if (sumProba > BL_EPS)
+void
+WienerSoftMasking::removeOldestSigma2(Sigma2Sums *sums, const float *oldPowers)
+{
+    int size = sums->_sum.size();
+    double *sum = sums->_sum.data();
+    
+    for (int i = 0; i < size; i++)
+        sum[i] -= oldPowers[i];
+    
+    // The lines are shifted by one:
+    // z = (z - x0)*e^(-i*w) + xNew, since e^(i*w*(N - 1)) = 1
+    double w = 2.0*M_PI/(_historySums.getHeight() - 1);
+    double c = cos(w);
+    double sn = sin(w);
+
+    double *re = sums->_re.data();
+    double *im = sums->_im.data();
+    for (int i = 0; i < size; i++)
     {
-        Utils::multValue(&currentSum0, sumProbaInv);
-        Utils::multValue(&currentSum1, sumProbaInv);
+        double re0 = re[i] - oldPowers[i];
+        double im0 = im[i];
+        
+        re[i] = re0*c + im0*sn;
+        im[i] = im0*c - re0*sn;
     }
+}
+
+void
+WienerSoftMasking::addNewestSigma2(Sigma2Sums *sums, const float *newPowers)
+{
+    int size = sums->_sum.size();
+    double *sum = sums->_sum.data();
     
-    // Result
-    *outSigma2Mask0 = currentSum0;
-    *outSigma2Mask1 = currentSum1;
+    for (int i = 0; i < size; i++)
+        sum[i] += newPowers[i];
+
+    double *re = sums->_re.data();
+    for (int i = 0; i < size; i++)
+        re[i] += newPowers[i];
+}
+
+void
+WienerSoftMasking::computeSigma2Sums(const Sigma2Sums &sums, vector<float> *outSigma2)
+{
+    int size = outSigma2->size();
+    if (sums._sum.size() != size)
+        return;
+
+    float *outData = outSigma2->data();
+    
+    // Hann: sum of x*(0.5 - 0.5*cos(w*k))
+    double norm = (_windowSumInv > 0.0) ? _windowSumInv : 1.0;
+    for (int i = 0; i < size; i++)
+    {
+        // Can be slightly negative, with the rounding errors
+        double val = 0.5*(sums._sum[i] - sums._re[i])*norm;
+        outData[i] = (val > 0.0) ? val : 0.0;
+    }
 }
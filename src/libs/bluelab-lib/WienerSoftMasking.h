@@ -19,13 +19,18 @@
 #ifndef WIENER_SOFT_MASKING_H
 #define WIENER_SOFT_MASKING_H
 
+#include <vector>
 #include <complex>
 using namespace std;
 
-#include <bl_queue.h>
+#include "RingBuffer2D.h"
 
 // Wiener soft masking applied on complexes
 //
+// The history keeps the input lines, and the powers of the masked signals
+// (real values, one ring for each source), in rings whose lines are written in place.
+// The variances of all the sources are computed in the same pass over the history.
+//
 // See: https://github.com/TUIlmenauAMS/ASP/blob/master/MaskingMethods.py
 // and: http://www.jonathanleroux.org/pdf/Erdogan2015ICASSP04.pdf
 // and: https://www.researchgate.net/publication/220736985_Degenerate_Unmixing_Estimation_Technique_using_the_Constant_Q_Transform
@@ -34,6 +39,27 @@ using namespace std;
 class WienerSoftMasking
 {
 public:
+    // Weighting of the history, to compute the variances
+    //
+    // SIGMA2_HANN: the whole history is summed at each hop
+    // SIGMA2_HANN_RECURSIVE: same weights, with running sums, so the cost
+    // doesn't depend on the history size (faster for large histories only)
+    // (sliding sums of x and x*e^(i*w*k), resynchronized periodically)
+    // Only for the centered lookahead, SIGMA2_HANN is used otherwise
+    enum Sigma2Mode
+    {
+        SIGMA2_HANN = 0,
+        SIGMA2_HANN_RECURSIVE
+    };
+
+    // Number of future lines used for the processed line (the latency, in hops)
+    // LOOKAHEAD_CENTERED: the line at the middle of the history
+    // 0: causal, only the past lines are used (no added latency)
+    enum
+    {
+        LOOKAHEAD_CENTERED = -1
+    };
+    
     WienerSoftMasking(int bufferSize, int overlap, int historySize);
     
     virtual ~WienerSoftMasking();
@@ -45,67 +71,121 @@ public:
     void setHistorySize(int size);
     
     int getHistorySize();
+
+    // The history is kept, only the processed line changes
+    void setLookahead(int lookahead);
+    // Number of lines (at most historySize - 1)
+    int getLookahead();
+    
+    void setSigma2Mode(Sigma2Mode mode);
+    Sigma2Mode getSigma2Mode();
     
+    // When disabled, the history is only a delay line of the input
+    // (the power history is primed again with the next enabled line)
     void setProcessingEnabled(bool flag);
     bool isProcessingEnabled();
 
     int getLatency();
     
     // Returns the centered data value in ioSum
+    // (delayed by the lookahead, see setLookahead())
     // Returns the centered masked data in ioMaskedResult0
     // Return sum - maskedResult0 in  ioMaskedResult1 if required
     void processCentered(vector<complex<float> > *ioSum,
                          const vector<float> &mask,
                          vector<complex<float> > *ioMaskedResult0,
                          vector<complex<float> > *ioMaskedResult1 = NULL);
-               
+
+    // N sources (e.g signal/noise/transients), with one hard mask for each source
+    // (the masks usually sum to 1)
+    // Returns the centered data value in ioSum,
+    // and the centered masked data of each source in ioMaskedResults
+    // The history is filled again if the number of sources changes
+    void processCentered(vector<complex<float> > *ioSum,
+                         const vector<vector<float> > &masks,
+                         vector<vector<complex<float> > > *ioMaskedResults);
+    
 protected:
-    void computeSigma2(vector<complex<float> > *outSigma2Mask0,
-                       vector<complex<float> > *outSigma2Mask1);
-                       
+    // Push the sum in the history
+    // If enabled, the new power lines are to be written
+    // Returns true if the power history must be primed with the new line
+    bool pushHistoryLine(const vector<complex<float> > &sum, int numSources);
+    // After the power lines are written
+    void updateHistoryLine(bool primePowers);
+
+    // Centered line of the history
+    const complex<float> *getCenteredSum();
     
-    class HistoryLine
-    {
-    public:
-        HistoryLine();
-        HistoryLine(const HistoryLine &other);
+    // Soft masks of the first numMasks sources, in _softMasks
+    void computeSoftMasks(int numMasks);
+    
+    // One output for each source
+    void computeSigma2(vector<vector<float> > *outSigma2);
 
-        virtual ~HistoryLine();
+    // Hann window of the history size, and its sum
+    // (centered on the processed line, and truncated, if the lookahead is not centered)
+    void updateWindow();
 
-        void resize(int size);
-        int getSize();
+    bool isLookaheadCentered();
+    
+    // Running sums over the history, for the recursive mode
+    class Sigma2Sums
+    {
+    public:
+        // Resize and fill with zeros
+        void clear(int size);
         
     public:
-        vector<complex<float> > _sum;
+        // Sum of x
+        vector<double> _sum;
         
-        vector<complex<float> > _masked0Square;
-        vector<complex<float> > _masked1Square;
-
-    protected:
-        int _size;
+        // Sum of x*e^(i*w*k), k = 0 for the oldest line (Hann)
+        vector<double> _re;
+        vector<double> _im;
     };
 
+    // Recompute the sums from the history
+    void resyncSigma2Sums();
+    void resyncSigma2Sums(Sigma2Sums *sums, int sourceNum);
+
+    // Before the oldest line is overwritten, then after the new line is written
+    void removeOldestSigma2(Sigma2Sums *sums, const float *oldPowers);
+    void addNewestSigma2(Sigma2Sums *sums, const float *newPowers);
+
+    void computeSigma2Sums(const Sigma2Sums &sums, vector<float> *outSigma2);
+
     int _bufferSize;
     int _overlap;
     
     int _historySize;
+    int _lookahead;
     
-    bl_queue<HistoryLine> _history;
+    // History x bins, line 0 is the oldest
+    // Empty until the first line (then filled with it)
+    RingBuffer2D<complex<float> > _historySums;
+    // One for each source
+    vector<RingBuffer2D<float> > _historyMaskedPowers;
+    bool _historyFilled;
+    // False while the processing is disabled
+    bool _powersPrimed;
     
     vector<float> _window;
+    float _windowSumInv;
+    int _windowLookahead;
+
+    Sigma2Mode _sigma2Mode;
+    // One for each source
+    vector<Sigma2Sums> _sigma2Sums;
+    // False if the history was filled or modified without updating the sums
+    bool _sigma2SumsValid;
+    int _numSigma2Updates;
     
     bool _processingEnabled;
 
 private:
-    HistoryLine _tmpHistoryLine;
-    vector<complex<float> > _tmpBuf0;
-    vector<complex<float> > _tmpBuf1;
-    vector<complex<float> > _tmpBuf2;
-    vector<complex<float> > _tmpBuf3;
-    vector<complex<float>> _tmpBuf4;
-    vector<complex<float> > _tmpBuf5;
-    vector<float> _tmpBuf6;
-    vector<float> _tmpBuf7;
+    vector<vector<float> > _sigma2;
+    vector<vector<float> > _softMasks;
+    vector<float> _tmpBuf0;
 };
 
 #endif
@@ -21,11 +21,203 @@
 #include "Defines.h"
 #include "Window.h"
 
+// Kaiser window used by makeWindow()
+// (side lobes close to the Blackman-Harris ones)
+#define KAISER_BETA 8.0
+
+void
+Window::makeWindow(Type type, vector<float> *win, bool periodic)
+{
+    switch(type)
+    {
+        case HANN:
+            makeWindowHann(win, periodic);
+            break;
+
+        case SQRT_HANN:
+            makeWindowSqrtHann(win, periodic);
+            break;
+
+        case BLACKMAN_HARRIS:
+            makeWindowBlackmanHarris(win, periodic);
+            break;
+
+        case KAISER:
+            makeWindowKaiser(win, KAISER_BETA, periodic);
+            break;
+
+        case FLAT_TOP:
+            makeWindowFlatTop(win, periodic);
+            break;
+
+        default:
+            makeWindowHann(win, periodic);
+            break;
+    }
+}
+
 void
-Window::makeWindowHann(vector<float> *win)
+Window::makeWindowHann(vector<float> *win, bool periodic)
 {
     // Hann
     for (int i = 0; i < win->size(); i++)
         (*win)[i] = 0.5 * (1.0 - cos(2.0 * M_PI *
-                                     ((double)i) / (win->size() - 1)));
+                                     getPhase(i, win->size(), periodic)));
+}
+
+void
+Window::makeWindowSqrtHann(vector<float> *win, bool periodic)
+{
+    makeWindowHann(win, periodic);
+
+    for (int i = 0; i < win->size(); i++)
+        (*win)[i] = sqrt((*win)[i]);
+}
+
+void
+Window::makeWindowBlackmanHarris(vector<float> *win, bool periodic)
+{
+    static const double a0 = 0.35875;
+    static const double a1 = 0.48829;
+    static const double a2 = 0.14128;
+    static const double a3 = 0.01168;
+    
+    for (int i = 0; i < win->size(); i++)
+    {
+        double t = 2.0 * M_PI * getPhase(i, win->size(), periodic);
+        
+        (*win)[i] = a0 - a1*cos(t) + a2*cos(2.0*t) - a3*cos(3.0*t);
+    }
+}
+
+void
+Window::makeWindowKaiser(vector<float> *win, float beta, bool periodic)
+{
+    double denom = besselI0(beta);
+    
+    for (int i = 0; i < win->size(); i++)
+    {
+        // From -1 to 1
+        double x = 2.0*getPhase(i, win->size(), periodic) - 1.0;
+        
+        (*win)[i] = besselI0(beta*sqrt(1.0 - x*x))/denom;
+    }
+}
+
+void
+Window::makeWindowFlatTop(vector<float> *win, bool periodic)
+{
+    static const double a0 = 0.21557895;
+    static const double a1 = 0.41663158;
+    static const double a2 = 0.277263158;
+    static const double a3 = 0.083578947;
+    static const double a4 = 0.006947368;
+    
+    for (int i = 0; i < win->size(); i++)
+    {
+        double t = 2.0 * M_PI * getPhase(i, win->size(), periodic);
+        
+        (*win)[i] = a0 - a1*cos(t) + a2*cos(2.0*t) - a3*cos(3.0*t) + a4*cos(4.0*t);
+    }
+}
+
+void
+Window::makeWindowPairLowLatency(vector<float> *anaWin, vector<float> *synthWin,
+                                 int synthSize)
+{
+    int size = anaWin->size();
+    int halfSynthSize = synthSize/2;
+
+    // Periodic Hann, for the product
+    vector<float> hann;
+    hann.resize(synthSize);
+    makeWindowHann(&hann, true);
+
+    // Rising part of the analysis window: sqrt of a long Hann
+    vector<float> longHann;
+    longHann.resize(2*(size - halfSynthSize));
+    makeWindowHann(&longHann, true);
+    
+    for (int i = 0; i < size - halfSynthSize; i++)
+        (*anaWin)[i] = sqrt(longHann[i]);
+
+    // Falling part: sqrt of the short Hann
+    for (int i = size - halfSynthSize; i < size; i++)
+        (*anaWin)[i] = sqrt(hann[i - (size - synthSize)]);
+
+    // Synthesis, so that the product is the short Hann
+    for (int i = 0; i < size; i++)
+    {
+        if (i < size - synthSize)
+        {
+            (*synthWin)[i] = 0.0;
+            continue;
+        }
+
+        float a = (*anaWin)[i];
+        float h = hann[i - (size - synthSize)];
+        (*synthWin)[i] = (a > BL_EPS) ? h/a : 0.0;
+    }
+}
+
+float
+Window::checkCOLA(const vector<float> &anaWin, const vector<float> &synthWin,
+                  int overlap, float *minGain, float *maxGain)
+{
+    int size = anaWin.size();
+    int hopSize = size / overlap;
+
+    // The overlapped sum is periodic, with a period of one hop
+    double sum = 0.0;
+    double minSum = BL_INF;
+    double maxSum = -BL_INF;
+    for (int i = 0; i < hopSize; i++)
+    {
+        double s = 0.0;
+        for (int j = i; j < size; j += hopSize)
+            s += anaWin[j]*synthWin[j];
+
+        sum += s;
+        
+        if (s < minSum)
+            minSum = s;
+        if (s > maxSum)
+            maxSum = s;
+    }
+
+    if (minGain != NULL)
+        *minGain = minSum;
+    if (maxGain != NULL)
+        *maxGain = maxSum;
+    
+    return sum/hopSize;
+}
+
+double
+Window::getPhase(int i, int size, bool periodic)
+{
+    // From 0 to 1 (1 excluded if periodic)
+    if (periodic)
+        return ((double)i)/size;
+    
+    return ((double)i)/(size - 1);
+}
+
+double
+Window::besselI0(double x)
+{
+    // Power series
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x*0.5;
+    for (int k = 1; k < 64; k++)
+    {
+        term *= (halfX/k)*(halfX/k);
+        sum += term;
+        
+        if (term < sum*1e-12)
+            break;
+    }
+
+    return sum;
 }
@@ -22,10 +22,55 @@
 #include <vector>
 using namespace std;
 
+// Symmetric windows by default (the first and last values are equal)
+// Periodic windows are the ones to use for exact overlap-add
 class Window
 {
  public:
-    static void makeWindowHann(vector<float> *win);
+    enum Type
+    {
+        HANN = 0,
+        SQRT_HANN,
+        BLACKMAN_HARRIS,
+        KAISER,
+        FLAT_TOP
+    };
+    
+    static void makeWindow(Type type, vector<float> *win, bool periodic = false);
+    
+    static void makeWindowHann(vector<float> *win, bool periodic = false);
+
+    // The product of two sqrt-Hann windows is a Hann window
+    static void makeWindowSqrtHann(vector<float> *win, bool periodic = false);
+
+    // 4 terms, -92dB side lobes
+    static void makeWindowBlackmanHarris(vector<float> *win, bool periodic = false);
+    
+    static void makeWindowKaiser(vector<float> *win, float beta, bool periodic = false);
+
+    // For amplitude measurements
+    static void makeWindowFlatTop(vector<float> *win, bool periodic = false);
+
+    // Asymmetric pair for low latency overlap-add (Mauler & Martin)
+    // The analysis window covers the whole frame, the synthesis window only
+    // the last synthSize samples, and their product is a Hann window of
+    // size synthSize. The latency is synthSize - hop instead of size - hop
+    // (hop must be at most synthSize/2)
+    static void makeWindowPairLowLatency(vector<float> *anaWin, vector<float> *synthWin,
+                                         int synthSize);
+
+    // Check the constant overlap-add property of an analysis/synthesis pair
+    // (product of the two windows, overlapped with a hop of size/overlap)
+    // Return the mean gain of the overlapped windows: 1/gain is the exact
+    // normalization. minGain and maxGain are equal if the pair is COLA
+    static float checkCOLA(const vector<float> &anaWin, const vector<float> &synthWin,
+                           int overlap, float *minGain = NULL, float *maxGain = NULL);
+
+ protected:
+    static double getPhase(int i, int size, bool periodic);
+
+    // Modified Bessel function of order 0
+    static double besselI0(double x);
 };
 
 #endif
@@ -0,0 +1,215 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "Utils.h"
+#include "WindowCache.h"
+
+std::mutex WindowCache::_mutex;
+vector<std::weak_ptr<const WindowCache::Tables> > WindowCache::_tables;
+
+std::shared_ptr<const WindowCache::Tables>
+WindowCache::getTables(const Settings &settings)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (int i = 0; i < _tables.size(); i++)
+    {
+        std::shared_ptr<const Tables> tables = _tables[i].lock();
+        if (tables == NULL)
+            continue;
+
+        if (isSameSettings(tables->_settings, settings))
+            return tables;
+    }
+
+    // Remove the tables that are not used anymore
+    for (int i = _tables.size() - 1; i >= 0; i--)
+    {
+        if (_tables[i].expired())
+            _tables.erase(_tables.begin() + i);
+    }
+    
+    std::shared_ptr<Tables> tables = std::make_shared<Tables>();
+    tables->_settings = settings;
+    makeTables(tables.get());
+
+    _tables.push_back(tables);
+    
+    return tables;
+}
+
+float
+WindowCache::getAnalysisCoeff(int fftSize, int overlap)
+{
+    // Because fftw3 seems to scale the data when doint forward fft
+    return 2.0 / (fftSize / overlap);
+}
+
+float
+WindowCache::getResynthCoeff(int fftSize)
+{
+    return 0.66*fftSize / 2.0;
+}
+
+bool
+WindowCache::isSameSettings(const Settings &s0, const Settings &s1)
+{
+    return ((s0._fftSize == s1._fftSize) &&
+            (s0._overlap == s1._overlap) &&
+            (s0._anaWindow == s1._anaWindow) &&
+            (s0._synthWindow == s1._synthWindow) &&
+            (s0._normalization == s1._normalization) &&
+            (s0._lowLatencySize == s1._lowLatencySize));
+}
+
+void
+WindowCache::makeTables(Tables *tables)
+{
+    const Settings &settings = tables->_settings;
+
+    tables->_synthOffset = 0;
+    
+    if ((settings._lowLatencySize > 0) &&
+        (settings._lowLatencySize < settings._fftSize))
+        makeTablesLowLatency(tables);
+    else if (settings._normalization == NORMALIZE_COLA)
+        makeTablesCOLA(tables);
+    else
+        makeTablesLegacy(tables);
+    
+    // The fft is linear, so the analysis coeff can be applied before it,
+    // in the same pass as the window
+    Utils::multValue(&tables->_anaTable,
+                     getAnalysisCoeff(settings._fftSize, settings._overlap));
+
+    computeReconstructionError(tables);
+}
+
+void
+WindowCache::makeTablesLegacy(Tables *tables)
+{
+    int fftSize = tables->_settings._fftSize;
+    int overlap = tables->_settings._overlap;
+    
+    vector<float> &anaWin = tables->_anaTable;
+    anaWin.resize(fftSize);
+    Window::makeWindow(tables->_settings._anaWindow, &anaWin);
+    
+    vector<float> &synthWin = tables->_synthTable;
+    synthWin.resize(fftSize);
+    Window::makeWindow(tables->_settings._synthWindow, &synthWin);
+
+    // Calculate combined contributions
+    vector<float> combinedWindow(fftSize, 0.0f);
+    int hopSize = fftSize / overlap; // Hop size for overlap-add
+
+    for (int frame = 0; frame < overlap; ++frame)
+    {
+        int startIndex = frame * hopSize; // Starting index for the current frame
+        for (int i = 0; i < fftSize; ++i)
+        {
+            int wrappedIndex = (startIndex + i) % fftSize; // Wrap around for circular buffer
+            combinedWindow[wrappedIndex] += synthWin[i];
+        }
+    }
+
+    // Compute the normalization factor (maximum combined contribution)
+    float normalizationFactor = *std::max_element(combinedWindow.begin(), combinedWindow.end());
+    
+    Utils::multValue(&anaWin, 1.0 / normalizationFactor);
+    Utils::multValue(&synthWin, 1.0 / normalizationFactor);
+}
+
+void
+WindowCache::makeTablesCOLA(Tables *tables)
+{
+    int fftSize = tables->_settings._fftSize;
+    
+    vector<float> &anaWin = tables->_anaTable;
+    anaWin.resize(fftSize);
+    Window::makeWindow(tables->_settings._anaWindow, &anaWin, true);
+    
+    vector<float> &synthWin = tables->_synthTable;
+    synthWin.resize(fftSize);
+    Window::makeWindow(tables->_settings._synthWindow, &synthWin, true);
+
+    normalizeCOLA(tables);
+}
+
+void
+WindowCache::makeTablesLowLatency(Tables *tables)
+{
+    int fftSize = tables->_settings._fftSize;
+    int synthSize = tables->_settings._lowLatencySize;
+
+    vector<float> &anaWin = tables->_anaTable;
+    anaWin.resize(fftSize);
+    
+    vector<float> &synthWin = tables->_synthTable;
+    synthWin.resize(fftSize);
+
+    Window::makeWindowPairLowLatency(&anaWin, &synthWin, synthSize);
+
+    tables->_synthOffset = fftSize - synthSize;
+    
+    normalizeCOLA(tables);
+}
+
+void
+WindowCache::normalizeCOLA(Tables *tables)
+{
+    int fftSize = tables->_settings._fftSize;
+    int overlap = tables->_settings._overlap;
+    
+    vector<float> &anaWin = tables->_anaTable;
+    vector<float> &synthWin = tables->_synthTable;
+    
+    // Same sum as the legacy Hann analysis window (about one hop),
+    // so that a sine has the same magnitude in the spectrum
+    double anaSum = 0.0;
+    for (int i = 0; i < fftSize; i++)
+        anaSum += anaWin[i];
+    if (anaSum > 0.0)
+        Utils::multValue(&anaWin, (fftSize / overlap) / anaSum);
+
+    // Exact gain of the pair, including the fft coeffs
+    float gain = Window::checkCOLA(anaWin, synthWin, overlap);
+    gain *= getAnalysisCoeff(fftSize, overlap)*getResynthCoeff(fftSize);
+    if (gain > 0.0)
+        Utils::multValue(&synthWin, 1.0 / gain);
+}
+
+void
+WindowCache::computeReconstructionError(Tables *tables)
+{
+    float minGain;
+    float maxGain;
+    Window::checkCOLA(tables->_anaTable, tables->_synthTable,
+                      tables->_settings._overlap, &minGain, &maxGain);
+
+    // The analysis coeff is already in the analysis table
+    float resynthCoeff = getResynthCoeff(tables->_settings._fftSize);
+    minGain *= resynthCoeff;
+    maxGain *= resynthCoeff;
+    
+    tables->_reconstructionError = std::max(fabs(minGain - 1.0), fabs(maxGain - 1.0));
+}
@@ -0,0 +1,107 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef WINDOW_CACHE_H
+#define WINDOW_CACHE_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+using namespace std;
+
+#include "Window.h"
+
+// Windows for OverlapAdd, with the gains folded in
+// The tables are immutable once created, and shared by all the objects
+// with the same settings
+class WindowCache
+{
+ public:
+    enum Normalization
+    {
+        // Symmetric windows, both divided by the maximum of the overlapped
+        // synthesis windows (original behavior, the gain is not exactly 1)
+        NORMALIZE_LEGACY = 0,
+
+        // Periodic windows. The analysis window keeps the gain of the legacy
+        // Hann window (so the processors see the same magnitudes), and the
+        // synthesis window gets the exact gain of the pair (see Window::checkCOLA())
+        NORMALIZE_COLA
+    };
+
+    struct Settings
+    {
+        int _fftSize;
+        int _overlap;
+
+        Window::Type _anaWindow;
+        Window::Type _synthWindow;
+        Normalization _normalization;
+
+        // Size of the synthesis window, for the low latency mode
+        // (0 for the whole frame)
+        // If set, the window types are not used: the asymmetric pair of
+        // Window::makeWindowPairLowLatency() is used, with COLA normalization
+        int _lowLatencySize;
+    };
+    
+    struct Tables
+    {
+        Settings _settings;
+        
+        // Normalized analysis window, multiplied by the analysis coeff
+        vector<float> _anaTable;
+
+        // Normalized synthesis window
+        vector<float> _synthTable;
+
+        // The synthesis window is zero before this index
+        // (only in low latency mode)
+        int _synthOffset;
+
+        // Maximum relative error of the reconstruction, if the spectrum
+        // is not modified (includes the gain error)
+        float _reconstructionError;
+    };
+
+    // Not real-time safe (may create the tables)
+    static std::shared_ptr<const Tables> getTables(const Settings &settings);
+
+    // Scale applied to the spectrum after the forward fft
+    static float getAnalysisCoeff(int fftSize, int overlap);
+
+    // Scale applied to the samples after the inverse fft
+    static float getResynthCoeff(int fftSize);
+    
+ protected:
+    static bool isSameSettings(const Settings &s0, const Settings &s1);
+    
+    static void makeTables(Tables *tables);
+    static void makeTablesLegacy(Tables *tables);
+    static void makeTablesCOLA(Tables *tables);
+    static void makeTablesLowLatency(Tables *tables);
+    static void normalizeCOLA(Tables *tables);
+    static void computeReconstructionError(Tables *tables);
+    
+    static std::mutex _mutex;
+
+    // Weak, so that the tables are freed when no object uses them anymore
+    static vector<std::weak_ptr<const Tables> > _tables;
+};
+
+#endif
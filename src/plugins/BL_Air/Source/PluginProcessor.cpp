@@ -18,11 +18,14 @@
 
 #include "OverlapAdd.h"
 #include "AirProcessor.h"
+#include "WienerSoftMasking.h"
 #include "BufProcessor.h"
 #include "Utils.h"
 #include "ParamSmoother.h"
 #include "CrossoverSplitterNBands.h"
 #include "Delay.h"
+#include "ChainSwitcher.h"
+#include "Profiler.h"
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
@@ -40,6 +43,86 @@
 
 #define MIN_SPLIT_FREQ 20.0
 
+// Resolution 0 is auto (depends on the sample rate)
+#define MIN_FFT_SIZE 512
+#define MAX_FFT_SIZE 8192
+
+// Max latency difference between two chains, when switching
+#define MAX_LATENCY_DIFF (2*MAX_FFT_SIZE)
+
+// Crossfade when the resolution changes, in seconds
+#define RESOLUTION_FADE_TIME 0.05
+
+// Added to the fft size in the chain setting
+#define LOW_LATENCY_FLAG (1 << 16)
+// Then the "softMaskLookahead" choice
+#define SOFT_MASK_LOOKAHEAD_SHIFT 17
+
+// Size of the synthesis window in low latency mode, in hops
+#define LOW_LATENCY_NUM_HOPS 2
+
+// AirChain
+AirChain::AirChain(int numChannels, int fftSize, bool lowLatency, double sampleRate)
+{
+    _fftSize = fftSize;
+    _lowLatency = lowLatency;
+    
+    // All the channels are processed together, hop by hop
+    _overlapAdd = new MultiChannelOverlapAdd(numChannels, fftSize, OVERLAP, true, true);
+
+    // The gains are still computed on the whole frame,
+    // but applied on a shorter window
+    if (_lowLatency)
+        _overlapAdd->setLowLatency(LOW_LATENCY_NUM_HOPS*fftSize/OVERLAP);
+        
+    for (int i = 0; i < numChannels; i++)
+    {
+        AirProcessor *processor = new AirProcessor(fftSize, OVERLAP, sampleRate);
+        processor->setThreshold(DEFAULT_TRACKER_THRESHOLD);
+
+        // For freq splitter
+        processor->setEnableSum(false);
+
+        _processors.push_back(processor);
+
+        _overlapAdd->addChannelProcessor(i, processor);
+    }
+
+    // Out
+    _outOverlapAdd = new MultiChannelOverlapAdd(numChannels, fftSize, OVERLAP, true, false);
+        
+    for (int i = 0; i < numChannels; i++)
+    {
+        BufProcessor *processor = new BufProcessor();
+        _outProcessors.push_back(processor);
+
+        _outOverlapAdd->addChannelProcessor(i, processor);
+    }
+
+    for (int i = 0; i < numChannels; i++)
+    {
+        Delay *delay = new Delay(fftSize);
+        _inputDelays.push_back(delay);
+    }
+}
+
+AirChain::~AirChain()
+{
+    delete _overlapAdd;
+
+    for (int i = 0; i < _processors.size(); i++)
+        delete _processors[i];
+
+    delete _outOverlapAdd;
+
+    for (int i = 0; i < _outProcessors.size(); i++)
+        delete _outProcessors[i];
+
+    for (int i = 0; i < _inputDelays.size(); i++)
+        delete _inputDelays[i];
+}
+
+// BLAirAudioProcessor
 BLAirAudioProcessor::BLAirAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
      : AudioProcessor (BusesProperties()
@@ -63,7 +146,15 @@ BLAirAudioProcessor::BLAirAudioProcessor()
                      std::make_unique<juce::AudioParameterFloat>(
             juce::ParameterID{"wetFreq", 700}, "Wet Freq", 20.0f, 20000.0f, 20.0f),
                      std::make_unique<juce::AudioParameterFloat>(
-            juce::ParameterID{"wetGain", 700}, "Wet Gain", -12.0f, 12.0f, 0.0f)
+            juce::ParameterID{"wetGain", 700}, "Wet Gain", -12.0f, 12.0f, 0.0f),
+                     std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID{"resolution", 701}, "Resolution",
+            juce::StringArray{"Auto", "512", "1024", "2048", "4096", "8192"}, 0),
+                     std::make_unique<juce::AudioParameterBool>(
+            juce::ParameterID{"lowLatency", 702}, "Low Latency", false),
+                     std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID{"softMaskLookahead", 720}, "Smart Resynth Lookahead",
+            juce::StringArray{"Centered", "Short", "Causal"}, 0)
                  })
 #endif
 {
@@ -78,21 +169,18 @@ BLAirAudioProcessor::BLAirAudioProcessor()
     
     _splitFreqSmoother = new ParamSmoother(sampleRate, defaultSplitFreq,
                                            splitFreqSmoothTime);
+
+    // The chains are built on a background thread when the resolution,
+    // the low latency mode or the smart resynth lookahead changes
+    // (so the latency changes with a crossfade)
+    _chainSwitcher =
+        new ChainSwitcher<AirChain>([this](const ChainContext &context, int setting)
+                                    { return createChain(context, setting); }, 0);
 }
 
 BLAirAudioProcessor::~BLAirAudioProcessor()
 {
-    for (int i = 0; i < _overlapAdds.size(); i++)
-        delete _overlapAdds[i];
-
-    for (int i = 0; i < _processors.size(); i++)
-        delete _processors[i];
-
-    for (int i = 0; i < _outOverlapAdds.size(); i++)
-        delete _outOverlapAdds[i];
-
-    for (int i = 0; i < _outProcessors.size(); i++)
-        delete _outProcessors[i];
+    delete _chainSwitcher;
 
     for (int i = 0; i < _outGainSmoothers.size(); i++)
         delete _outGainSmoothers[i];
@@ -108,8 +196,12 @@ BLAirAudioProcessor::~BLAirAudioProcessor()
     for (int i = 0; i < _bandSplittersOut.size(); i++)
         delete _bandSplittersOut[i];
 
-    for (int i = 0; i < _inputDelays.size(); i++)
-        delete _inputDelays[i];
+#if BL_PROFILE
+    // Timings of the session
+    juce::File tmpDir = juce::File::getSpecialLocation(juce::File::tempDirectory);
+    Profiler::dumpJSON(tmpDir.getChildFile("BL-Air-profile.json").getFullPathName().toRawUTF8());
+    Profiler::dumpCSV(tmpDir.getChildFile("BL-Air-profile.csv").getFullPathName().toRawUTF8());
+#endif
 }
 
 const juce::String
@@ -187,30 +279,28 @@ void
 BLAirAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     int numInputChannels = getTotalNumInputChannels();
+
+    bool sampleRateChanged = (sampleRate != _sampleRate);
+    _sampleRate = sampleRate;
     
-    int fftSize = Utils::nearestPowerOfTwo(sampleRate/FFT_SIZE_COEFF);
+    auto resolution = _parameters.getRawParameterValue("resolution")->load();
+    int fftSize = getFftSize(resolution);
     
-    if (sampleRate != _sampleRate)
+    if (sampleRateChanged || (fftSize/2 + 1 != _notifiedNumBins))
     {
-        _sampleRate = sampleRate;
-        
         // Notify listener
         if (_sampleRateChangeListener != nullptr)
             _sampleRateChangeListener(sampleRate, fftSize/2 + 1);
-    }
 
+        _notifiedNumBins = fftSize/2 + 1;
+    }
+    _numBins = fftSize/2 + 1;
+    
     // Number of channels changed?
-    if (_overlapAdds.size() != numInputChannels)
+    if (numInputChannels != _numChannels)
     {
-        // Air
-        for (int i = 0; i < _overlapAdds.size(); i++)
-            delete _overlapAdds[i];
-        _overlapAdds.clear();
+        _numChannels = numInputChannels;
         
-        for (int i = 0; i < _processors.size(); i++)
-            delete _processors[i];
-        _processors.clear();
-
         for (int i = 0; i < _bandSplittersIn.size(); i++)
             delete _bandSplittersIn[i];
         _bandSplittersIn.clear();
@@ -219,10 +309,6 @@ BLAirAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
             delete _bandSplittersOut[i];
         _bandSplittersOut.clear();
         
-        for (int i = 0; i < _inputDelays.size(); i++)
-            delete _inputDelays[i];
-        _inputDelays.clear();
-
         for (int i = 0; i < _outGainSmoothers.size(); i++)
             delete _outGainSmoothers[i];
         _outGainSmoothers.clear();
@@ -230,41 +316,7 @@ BLAirAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
         for (int i = 0; i < _wetGainSmoothers.size(); i++)
             delete _wetGainSmoothers[i];
         _wetGainSmoothers.clear();
-    
-        for (int i = 0; i < numInputChannels; i++)
-        {
-            AirProcessor *processor = new AirProcessor(fftSize, OVERLAP, sampleRate);
-            processor->setThreshold(DEFAULT_TRACKER_THRESHOLD);
-
-            // For freq splitter
-            processor->setEnableSum(false);
-
-            _processors.push_back(processor);
-            
-            OverlapAdd *overlapAdd = new OverlapAdd(fftSize, OVERLAP, true, true);
-            overlapAdd->addProcessor(processor);
-            _overlapAdds.push_back(overlapAdd);
-        }
-
-        // Out
-        for (int i = 0; i < _outOverlapAdds.size(); i++)
-            delete _outOverlapAdds[i];
-        _outOverlapAdds.clear();
-        
-        for (int i = 0; i < _outProcessors.size(); i++)
-            delete _outProcessors[i];
-        _outProcessors.clear();
         
-        for (int i = 0; i < numInputChannels; i++)
-        {
-            BufProcessor *processor = new BufProcessor();
-            _outProcessors.push_back(processor);
-            
-            OverlapAdd *overlapAdd = new OverlapAdd(fftSize, OVERLAP, true, false);
-            overlapAdd->addProcessor(processor);
-            _outOverlapAdds.push_back(overlapAdd);
-        }
-
         float splitFreqs[1] = { DEFAULT_SPLIT_FREQ };
         for (int i = 0; i < numInputChannels; i++)
         {
@@ -283,12 +335,6 @@ BLAirAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
         auto wetFreq = _parameters.getRawParameterValue("wetFreq")->load();
         setSplitFreq(wetFreq);
         
-        for (int i = 0; i < numInputChannels; i++)
-        {
-            Delay *delay = new Delay(fftSize);
-            _inputDelays.push_back(delay);
-        }
-
         for (int i = 0; i < numInputChannels; i++)
         {
             float defaultOutGain = 1.0;
@@ -304,23 +350,37 @@ BLAirAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
         }
     }
 
-    // Air
-    for (int i = 0; i < _overlapAdds.size(); i++)
+    // Scratch buffers
+    _dryBufs.resize(numInputChannels);
+    _wetBufs.resize(numInputChannels);
+    _nextBufs.resize(numInputChannels);
+    _nextBufPtrs.resize(numInputChannels);
+    for (int i = 0; i < numInputChannels; i++)
     {
-        _overlapAdds[i]->setFftSize(fftSize);
-        _overlapAdds[i]->setOverlap(OVERLAP);
+        _dryBufs[i].resize(samplesPerBlock);
+        _wetBufs[i].resize(samplesPerBlock);
+        _nextBufs[i].resize(samplesPerBlock);
     }
-
-    for (int i = 0; i < _processors.size(); i++)
-        _processors[i]->reset(fftSize, OVERLAP, sampleRate);
-
-    // Out
-    for (int i = 0; i < _outOverlapAdds.size(); i++)
+    for (int i = 0; i < 2; i++)
     {
-        _outOverlapAdds[i]->setFftSize(fftSize);
-        _outOverlapAdds[i]->setOverlap(OVERLAP);
+        _splitInBufs[i].resize(samplesPerBlock);
+        _splitOutBufs[i].resize(samplesPerBlock);
     }
-
+    _nextLowBuf.resize(samplesPerBlock);
+    
+    ChainContext context;
+    context._numChannels = numInputChannels;
+    context._sampleRate = sampleRate;
+    context._maxBlockSize = samplesPerBlock;
+    
+    // Not on the audio thread, so the chain can be built directly
+    int setting = getChainSetting();
+    AirChain *chain = createChain(context, setting);
+    _chainSwitcher->setChain(chain, setting, context);
+    _chainSwitcher->setFadeSamples(RESOLUTION_FADE_TIME*sampleRate);
+    // Wet signals, then dry signals
+    _chainSwitcher->prepare(2*numInputChannels, MAX_LATENCY_DIFF);
+    
     auto outGain = _parameters.getRawParameterValue("outGain")->load();
     outGain = Utils::DBToAmp(outGain);
     for (int i = 0; i < _outGainSmoothers.size(); i++)
@@ -343,13 +403,9 @@ BLAirAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
     _splitFreqSmoother->reset(sampleRate);
     
     // Update latency
-    int latency = getLatency(samplesPerBlock);
+    int latency = getLatency(chain, samplesPerBlock);
     setLatencySamples(latency);
     updateHostDisplay();
-
-    // Update the delays
-    for (int i = 0; i < _inputDelays.size(); i++)
-        _inputDelays[i]->setDelay(latency);
     
     for (int i = 0; i < _bandSplittersIn.size(); i++)
         _bandSplittersIn[i]->reset(sampleRate);
@@ -409,40 +465,52 @@ BLAirAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBu
         buffer.clear(i, 0, buffer.getNumSamples());
 
     // Retrieve parameter values
-    auto threshold = _parameters.getRawParameterValue("threshold")->load();
-    auto harmoAirMix = _parameters.getRawParameterValue("harmoAirMix")->load();
     auto outGain = _parameters.getRawParameterValue("outGain")->load();
     auto smartResynth = _parameters.getRawParameterValue("smartResynth")->load();
     auto wetFreq = _parameters.getRawParameterValue("wetFreq")->load();
     auto wetGain = _parameters.getRawParameterValue("wetGain")->load();
+    auto resolution = _parameters.getRawParameterValue("resolution")->load();
     
-    harmoAirMix *= 0.01;
-    harmoAirMix = -harmoAirMix;
     outGain = Utils::DBToAmp(outGain);
 
     bool smartResynthChanged = (smartResynth > 0.5) != _prevSmartResynthParam;
     _prevSmartResynthParam = (smartResynth > 0.5);
 
     wetGain = Utils::DBToAmp(wetGain);
+
+    int numSamples = buffer.getNumSamples();
+    
+    // Build a new chain in background if the resolution
+    // or the low latency mode changed
+    // Warmup: until the overlap-add output of the new chain is complete
+    int fftSize = getFftSize(resolution);
+    _chainSwitcher->requestSetting(getChainSetting(), 2*fftSize);
+    
+    AirChain *chain = _chainSwitcher->getChain();
+    AirChain *nextChain = _chainSwitcher->getNextChain();
     
     // Set parameters
-    for (int i = 0; i < _processors.size(); i++)
-    {
-        _processors[i]->setThreshold(threshold);
-        _processors[i]->setMix(harmoAirMix);
-        _processors[i]->setUseSoftMasks(smartResynth > 0.5);
-    }
+    setChainParameters(chain);
+    if (nextChain != nullptr)
+        setChainParameters(nextChain);
 
     if (smartResynthChanged)
     {            
         // Update latency
-        int latency = getLatency(buffer.getNumSamples());
+        int latency = getLatency(chain, numSamples);
         setLatencySamples(latency);
         updateHostDisplay();
 
         // Update the delays
-        for (int i = 0; i < _inputDelays.size(); i++)
-            _inputDelays[i]->setDelay(latency);
+        for (int i = 0; i < chain->_inputDelays.size(); i++)
+            chain->_inputDelays[i]->setDelay(latency);
+
+        if (nextChain != nullptr)
+        {
+            int nextLatency = getLatency(nextChain, numSamples);
+            for (int i = 0; i < nextChain->_inputDelays.size(); i++)
+                nextChain->_inputDelays[i]->setDelay(nextLatency);
+        }
     }
 
     _splitFreqSmoother->setTargetValue(wetFreq);
@@ -460,71 +528,132 @@ BLAirAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBu
         _outGainSmoothers[i]->setTargetValue(outGain);
     
     // Process
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    bool splitEnabled = (wetFreq >= MIN_SPLIT_FREQ);
+    
+    // Keep a copy of the dry input, for the splitter
+    if (splitEnabled)
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        
-        vector<float> inBuf;
-        inBuf.resize(buffer.getNumSamples());
-        memcpy(inBuf.data(), channelData, buffer.getNumSamples()*sizeof(float));
-        
-        _overlapAdds[channel]->feed(inBuf);
+        for (int channel = 0; channel < totalNumInputChannels; ++channel)
+        {
+            _dryBufs[channel].resize(numSamples);
+            memcpy(_dryBufs[channel].data(), buffer.getReadPointer(channel),
+                   numSamples*sizeof(float));
+        }
+    }
+
+    // The new chain processes a copy of the input
+    if (nextChain != nullptr)
+    {
+        for (int channel = 0; channel < totalNumInputChannels; ++channel)
+        {
+            _nextBufs[channel].resize(numSamples);
+            memcpy(_nextBufs[channel].data(), buffer.getReadPointer(channel),
+                   numSamples*sizeof(float));
+
+            _nextBufPtrs[channel] = _nextBufs[channel].data();
+        }
+
+        nextChain->_overlapAdd->process(_nextBufPtrs.data(), _nextBufPtrs.data(), numSamples);
+    }
+    
+    // Wet, in place
+    chain->_overlapAdd->process(buffer.getArrayOfReadPointers(),
+                                buffer.getArrayOfWritePointers(),
+                                numSamples);
+
+    if (nextChain != nullptr)
+    {
+        // Align the two chains during the switch
+        _chainSwitcher->setLatencies(getLatency(chain, numSamples),
+                                     getLatency(nextChain, numSamples));
         
-        vector<float> outBuf;
-        int numSamplesToFlush = _overlapAdds[channel]->getOutSamples(&outBuf, buffer.getNumSamples());
-        _overlapAdds[channel]->flushOutSamples(numSamplesToFlush);
+        for (int channel = 0; channel < totalNumInputChannels; ++channel)
+            _chainSwitcher->crossfade(channel, buffer.getWritePointer(channel),
+                                      _nextBufs[channel].data(), numSamples);
+    }
 
-        // Splitter
-        if (wetFreq >= MIN_SPLIT_FREQ)
+    // Splitter
+    if (splitEnabled)
+    {
+        for (int channel = 0; channel < totalNumInputChannels; ++channel)
         {
-            // Split in
-            vector<float> inLo;
-            vector<float> inHi;
+            auto* channelData = buffer.getWritePointer(channel);
             
-            vector<float> resultBufIn[2];
-            _bandSplittersIn[channel]->split(inBuf, (vector<float> *)&resultBufIn);
-
-            inLo = resultBufIn[0];
-            inHi = resultBufIn[1];
+            vector<float> &inBuf = _dryBufs[channel];
+            vector<float> &outBuf = _wetBufs[channel];
 
-            // Split out
-            vector<float> outLo;
-            vector<float> outHi;
+            outBuf.resize(numSamples);
+            memcpy(outBuf.data(), channelData, numSamples*sizeof(float));
             
-            vector<float> resultBufOut[2];
-            _bandSplittersOut[channel]->split(outBuf, resultBufOut);
+            // Split in, keep the low band
+            _bandSplittersIn[channel]->split(inBuf, _splitInBufs);
+            vector<float> &inLo = _splitInBufs[0];
 
-            outLo = resultBufOut[0];
-            outHi = resultBufOut[1];
+            // Split out, keep the high band
+            _bandSplittersOut[channel]->split(outBuf, _splitOutBufs);
+            vector<float> &outHi = _splitOutBufs[1];
 
             // Delay input
-            _inputDelays[channel]->processSamples(&inLo);
+            if (nextChain != nullptr)
+            {
+                // Same crossfade as the wet signal
+                vector<float> &inLoNext = _nextLowBuf;
+                inLoNext.resize(numSamples);
+                memcpy(inLoNext.data(), inLo.data(), numSamples*sizeof(float));
+                
+                nextChain->_inputDelays[channel]->processSamples(&inLoNext);
+                chain->_inputDelays[channel]->processSamples(&inLo);
+
+                _chainSwitcher->crossfade(totalNumInputChannels + channel,
+                                          inLo.data(), inLoNext.data(), numSamples);
+            }
+            else
+                chain->_inputDelays[channel]->processSamples(&inLo);
         
             // Apply wet gain
             Utils::applyGain(outHi, &outHi, _wetGainSmoothers[channel]);
 
             // Sum
             Utils::addBuffers(&outBuf, inLo, outHi);
-        }
-
-        // Generate the output magnitudes
-        _outOverlapAdds[channel]->feed(outBuf);
 
-        // Apply out gain
-        Utils::applyGain(outBuf, &outBuf, _outGainSmoothers[channel]);
-
-        // Copy output
-        memcpy(channelData, outBuf.data(), buffer.getNumSamples()*sizeof(float));
+            memcpy(channelData, outBuf.data(), numSamples*sizeof(float));
+        }
+    }
+    
+    // Generate the output magnitudes
+    chain->_outOverlapAdd->feed(buffer.getArrayOfReadPointers(), numSamples);
+    if (nextChain != nullptr)
+        nextChain->_outOverlapAdd->feed(buffer.getArrayOfReadPointers(), numSamples);
+    
+    // Apply out gain
+    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    {
+        auto* channelData = buffer.getWritePointer(channel);
+        
+        Utils::applyGain(channelData, channelData, numSamples, _outGainSmoothers[channel]);
     }
      
+    if ((nextChain != nullptr) && _chainSwitcher->advance(numSamples))
+        // The new chain is now the current one
+    {
+        chain = _chainSwitcher->getChain();
+
+        _numBins = chain->_fftSize/2 + 1;
+        
+        // Update latency, now that the chains are not mixed anymore
+        int latency = getLatency(chain, numSamples);
+        setLatencySamples(latency);
+        updateHostDisplay();
+    }
+    
     // Get curves
     {
         std::lock_guard<std::mutex> lock(_curvesMutex);
 
-        _processors[0]->getNoiseBuffer(&_airBuffer);
-        _processors[0]->getHarmoBuffer(&_harmoBuffer);
+        chain->_processors[0]->getNoiseBuffer(&_airBuffer);
+        chain->_processors[0]->getHarmoBuffer(&_harmoBuffer);
 
-        _outProcessors[0]->getMagnsBuffer(&_sumBuffer);
+        chain->_outProcessors[0]->getMagnsBuffer(&_sumBuffer);
 
         _newBuffersAvailable = true;
     }
@@ -586,11 +715,25 @@ BLAirAudioProcessor::getBuffers(vector<float> *airBuffer,
                                 vector<float> *harmoBuffer,
                                 vector<float> *sumBuffer)
 {
+    // The resolution has changed, notify the listener (here on the message thread)
+    int numBins = _numBins;
+    if ((numBins != _notifiedNumBins) && (numBins > 0))
+    {
+        if (_sampleRateChangeListener != nullptr)
+            _sampleRateChangeListener(_sampleRate, numBins);
+
+        _notifiedNumBins = numBins;
+    }
+    
     if (!_newBuffersAvailable)
         return false;
     
     std::lock_guard<std::mutex> lock(_curvesMutex);
 
+    // Buffers from the previous resolution
+    if (_airBuffer.size() != numBins)
+        return false;
+
     *airBuffer = _airBuffer;
     *harmoBuffer = _harmoBuffer;
     *sumBuffer = _sumBuffer;
@@ -601,25 +744,126 @@ BLAirAudioProcessor::getBuffers(vector<float> *airBuffer,
 }
 
 int
-BLAirAudioProcessor::getLatency(int blockSize)
+BLAirAudioProcessor::getFftSize(int resolution)
+{
+    if (resolution == 0)
+        // Auto
+        return Utils::nearestPowerOfTwo(_sampleRate/FFT_SIZE_COEFF);
+    
+    int fftSize = MIN_FFT_SIZE << (resolution - 1);
+    if (fftSize > MAX_FFT_SIZE)
+        fftSize = MAX_FFT_SIZE;
+
+    return fftSize;
+}
+
+int
+BLAirAudioProcessor::getChainSetting()
+{
+    auto resolution = _parameters.getRawParameterValue("resolution")->load();
+    auto lowLatency = _parameters.getRawParameterValue("lowLatency")->load();
+    auto softMaskLookahead = _parameters.getRawParameterValue("softMaskLookahead")->load();
+    
+    int setting = getFftSize(resolution);
+    if (lowLatency > 0.5)
+        setting |= LOW_LATENCY_FLAG;
+
+    setting |= ((int)softMaskLookahead << SOFT_MASK_LOOKAHEAD_SHIFT);
+    
+    return setting;
+}
+
+int
+BLAirAudioProcessor::getSoftMaskLookahead(int choice)
+{
+    switch(choice)
+    {
+        case 0:
+            return WienerSoftMasking::LOOKAHEAD_CENTERED;
+            break;
+
+        case 1:
+            // One frame
+            return 1;
+            break;
+            
+        case 2:
+            // Causal, no added latency
+            return 0;
+            break;
+
+        default:
+            return WienerSoftMasking::LOOKAHEAD_CENTERED;
+    }
+}
+
+int
+BLAirAudioProcessor::getLatency(AirChain *chain, int blockSize)
 {
-    if (_processors.empty())
+    if (chain == nullptr)
         return 0;
     
-    int fftSize = Utils::nearestPowerOfTwo(_sampleRate/FFT_SIZE_COEFF);
+    int fftSize = chain->_fftSize;
     int hopSize = fftSize/OVERLAP;
-    
-    int latency = fftSize - hopSize;
+
+    // Reduced in low latency mode
+    int latency = chain->_overlapAdd->getLatency();
 
     if (blockSize < hopSize)
         latency += hopSize - blockSize;
 
-    int processorLatency = _processors[0]->getLatency();
+    int processorLatency = chain->_processors[0]->getLatency();
     latency += processorLatency;
 
     return latency;
 }
 
+AirChain *
+BLAirAudioProcessor::createChain(const ChainContext &context, int setting)
+{
+    int fftSize = setting & (LOW_LATENCY_FLAG - 1);
+    bool lowLatency = ((setting & LOW_LATENCY_FLAG) != 0);
+    int softMaskLookahead = getSoftMaskLookahead(setting >> SOFT_MASK_LOOKAHEAD_SHIFT);
+    
+    AirChain *chain = new AirChain(context._numChannels, fftSize, lowLatency,
+                                   context._sampleRate);
+
+    // So that the output rings don't grow on the audio thread
+    // (the out overlap-add has no output)
+    chain->_overlapAdd->setMaxBlockSize(context._maxBlockSize);
+
+    // The chain keeps its latency
+    for (int i = 0; i < chain->_processors.size(); i++)
+        chain->_processors[i]->setSoftMaskingLookahead(softMaskLookahead);
+
+    // The processor latency depends on the parameters
+    setChainParameters(chain);
+    
+    int latency = getLatency(chain, context._maxBlockSize);
+    for (int i = 0; i < chain->_inputDelays.size(); i++)
+        chain->_inputDelays[i]->setDelay(latency);
+
+    return chain;
+}
+
+void
+BLAirAudioProcessor::setChainParameters(AirChain *chain)
+{
+    auto threshold = _parameters.getRawParameterValue("threshold")->load();
+    auto harmoAirMix = _parameters.getRawParameterValue("harmoAirMix")->load();
+    auto smartResynth = _parameters.getRawParameterValue("smartResynth")->load();
+    
+    harmoAirMix *= 0.01;
+    harmoAirMix = -harmoAirMix;
+    
+    for (int i = 0; i < chain->_processors.size(); i++)
+    {
+        chain->_processors[i]->setThreshold(threshold);
+        chain->_processors[i]->setMix(harmoAirMix);
+        chain->_processors[i]->setUseSoftMasks(smartResynth > 0.5);
+    }
+}
+
 void
 BLAirAudioProcessor::setSplitFreq(float freq)
 {  
@@ -23,12 +23,35 @@ using namespace std;
 
 #include <JuceHeader.h>
 
-class OverlapAdd;
+class MultiChannelOverlapAdd;
 class AirProcessor;
 class BufProcessor;
 class ParamSmoother;
 class Delay;
 class CrossoverSplitterNBands;
+template <typename T> class ChainSwitcher;
+
+// Everything that depends on the fft size
+class AirChain
+{
+public:
+    AirChain(int numChannels, int fftSize, bool lowLatency, double sampleRate);
+    virtual ~AirChain();
+
+    int _fftSize;
+    bool _lowLatency;
+    
+    MultiChannelOverlapAdd *_overlapAdd = nullptr;
+    vector<AirProcessor *> _processors;
+
+    // Output magnitudes
+    MultiChannelOverlapAdd *_outOverlapAdd = nullptr;
+    vector<BufProcessor *> _outProcessors;
+
+    // For the splitter, delay the dry signal by the latency of the chain
+    vector<Delay *> _inputDelays;
+};
+
 class BLAirAudioProcessor  : public juce::AudioProcessor
 {
 public:
@@ -75,15 +98,35 @@ public:
     juce::AudioProcessorValueTreeState _parameters;
     
 private:
-    int getLatency(int blockSize);
+    int getFftSize(int resolution);
+
+    // Fft size, low latency flag and soft masking lookahead,
+    // a new chain is built when it changes
+    int getChainSetting();
+
+    // From the "softMaskLookahead" parameter
+    // (see WienerSoftMasking::setLookahead())
+    static int getSoftMaskLookahead(int choice);
+    
+    int getLatency(AirChain *chain, int blockSize);
 
     void setSplitFreq(float freq);
-        
-    vector<OverlapAdd *> _overlapAdds;
-    vector<AirProcessor *> _processors;
 
-    vector<OverlapAdd *> _outOverlapAdds;
-    vector<BufProcessor *> _outProcessors;
+    // Called on the message thread, or on the background thread
+    // when the resolution, the low latency mode or the lookahead changes
+    AirChain *createChain(const ChainContext &context, int setting);
+
+    void setChainParameters(AirChain *chain);
+    
+    ChainSwitcher<AirChain> *_chainSwitcher = nullptr;
+    
+    int _numChannels = 0;
+
+    // Input copy, for the new chain while switching
+    vector<vector<float> > _nextBufs;
+    vector<float *> _nextBufPtrs;
+    // Dry low band delayed for the new chain, for the current channel
+    vector<float> _nextLowBuf;
     
     bool _prevSmartResynthParam = false;
 
@@ -96,11 +139,20 @@ private:
 
     vector<ParamSmoother *> _wetGainSmoothers;
 
-    vector<Delay *> _inputDelays;
+    // Scratch buffers, for the splitter
+    vector<vector<float> > _dryBufs;
+    vector<vector<float> > _wetBufs;
+    // Low and high bands, for the current channel
+    vector<float> _splitInBufs[2];
+    vector<float> _splitOutBufs[2];
     
     double _sampleRate = 0.0;
     SampleRateChangeListener _sampleRateChangeListener = nullptr;
 
+    // The number of bins changes with the resolution
+    std::atomic<int> _numBins { 0 };
+    int _notifiedNumBins = 0;
+
     vector<float> _airBuffer;
     vector<float> _harmoBuffer;
     vector<float> _sumBuffer;
@@ -30,6 +30,9 @@
 #define PLUGIN_WIDTH 464
 #define PLUGIN_HEIGHT 464
 
+// Refresh the timings every second
+#define PROFILE_TIMER_COUNT 30
+
 BLDenoiserAudioProcessorEditor::BLDenoiserAudioProcessorEditor(BLDenoiserAudioProcessor& p)
     : AudioProcessorEditor(&p), _audioProcessor(p)
 {
@@ -197,6 +200,13 @@ void BLDenoiserAudioProcessorEditor::paint(juce::Graphics& g)
     DemoTextDrawer::drawDemoText(*this, g, "DEMO");
 #endif
 
+#if BL_PROFILE
+    g.setColour(juce::Colours::white);
+    g.setFont(10.0f);
+    for (int i = 0; i < _profileLines.size(); i++)
+        g.drawText(_profileLines[i], 8, 374 + i*11, 160, 11, juce::Justification::left);
+#endif
+
     // Grey out the res noise threshold slider if we use auto residual denoise
     auto* autoResNoiseValue = _audioProcessor._parameters.getRawParameterValue("softDenoiseParamID");
     if (autoResNoiseValue != nullptr)
@@ -300,5 +310,35 @@ BLDenoiserAudioProcessorEditor::timerCallback()
 #ifdef __APPLE__
     _spectrumComponent->repaint();
 #endif
+
+#if BL_PROFILE
+    if (++_profileTimerCount >= PROFILE_TIMER_COUNT)
+    {
+        _profileTimerCount = 0;
+        
+        updateProfileText();
+        repaint();
+    }
+#endif
 }
 
+#if BL_PROFILE
+void
+BLDenoiserAudioProcessorEditor::updateProfileText()
+{
+    Profiler::Snapshot snapshot;
+    Profiler::getSnapshot(&snapshot);
+
+    // Mean and 99th percentile, in microseconds
+    _profileLines.clear();
+    for (int i = 0; i < snapshot._stages.size(); i++)
+    {
+        const Profiler::StageStats &stats = snapshot._stages[i];
+
+        juce::String name = juce::String(Profiler::getStageName(i)).fromLastOccurrenceOf(":", false, false);
+        _profileLines.add(name + " " + juce::String(stats._meanTime, 1) +
+                          " / " + juce::String(stats._p99Time, 1) + " us");
+    }
+}
+#endif
+
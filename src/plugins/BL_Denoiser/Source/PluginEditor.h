@@ -32,6 +32,7 @@
 #include "SpectrumViewNVG.h"
 #include "SpectrumViewJuce.h"
 #include "DenoiserSpectrum.h"
+#include "Profiler.h"
 
 #define RENDER_GL 1
 
@@ -52,6 +53,10 @@ private:
     void handleSampleRateChange(double newSampleRate, int bufferSize);
 
     void timerCallback() override;
+
+#if BL_PROFILE
+    void updateProfileText();
+#endif
     
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -91,6 +96,11 @@ private:
 
     std::unique_ptr<DenoiserSpectrum> _denoiserSpectrum = nullptr;
     
+#if BL_PROFILE
+    juce::StringArray _profileLines;
+    int _profileTimerCount = 0;
+#endif
+    
 #if RENDER_GL
     std::unique_ptr<SpectrumComponentGL> _spectrumComponent;
     std::unique_ptr<SpectrumViewNVG> _spectrumView;
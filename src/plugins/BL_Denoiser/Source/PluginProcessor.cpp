@@ -18,7 +18,12 @@
 
 #include <OverlapAdd.h>
 #include <DenoiserProcessor.h>
+#include <WienerSoftMasking.h>
 #include <TransientShaperProcessor.h>
+#include <RTWorkerPool.h>
+#include <ChainSwitcher.h>
+#include <Profiler.h>
+#include <NoiseProfileBank.h>
 #include <Utils.h>
 
 #include "PluginProcessor.h"
@@ -34,6 +39,82 @@
 
 #define FFT_SIZE_COEFF 23
 
+// Process the channels in parallel, on worker threads
+#define USE_WORKER_POOL 1
+
+// Resolution 0 is auto (depends on the sample rate)
+#define MIN_FFT_SIZE 512
+#define MAX_FFT_SIZE 8192
+
+// Max latency difference between two chains, when switching
+#define MAX_LATENCY_DIFF (2*MAX_FFT_SIZE)
+
+// Crossfade when the resolution changes, in seconds
+#define RESOLUTION_FADE_TIME 0.05
+
+// Added to the fft size in the chain setting
+#define LOW_LATENCY_FLAG (1 << 16)
+// Then the "softMaskLookahead" choice
+#define SOFT_MASK_LOOKAHEAD_SHIFT 17
+#define SOFT_MASK_LOOKAHEAD_MASK 0x3
+// Then the "quality" choice (the overlap)
+#define QUALITY_SHIFT 19
+
+// Selected with the "noiseProfile" parameter
+#define NUM_NOISE_PROFILES 4
+
+// DenoiserChain
+DenoiserChain::DenoiserChain(int numChannels, int fftSize, int overlap, bool lowLatency,
+                             double sampleRate, float threshold)
+{
+    _fftSize = fftSize;
+    _overlap = overlap;
+    _lowLatency = lowLatency;
+    
+    // All the channels are processed together, hop by hop
+    _overlapAdd = new MultiChannelOverlapAdd(numChannels, fftSize, overlap, true, true);
+
+    // The gains are still computed on the whole frame,
+    // but applied on a shorter window
+    if (_lowLatency)
+        _overlapAdd->setLowLatency(getLowLatencySize(fftSize, overlap));
+        
+    for (int i = 0; i < numChannels; i++)
+    {
+        DenoiserProcessor *processor = new DenoiserProcessor(fftSize, overlap, threshold);
+        processor->reset(fftSize, overlap, sampleRate);
+        // The noise profiles can be switched on the audio thread
+        processor->reserveNativeNoiseCurve(MAX_FFT_SIZE/2 + 1);
+        _processors.push_back(processor);
+
+        TransientShaperProcessor *transientProcessor = new TransientShaperProcessor(sampleRate);
+        _transientProcessors.push_back(transientProcessor);
+            
+        _overlapAdd->addChannelProcessor(i, processor);
+        _overlapAdd->addChannelProcessor(i, transientProcessor);
+    }
+}
+
+DenoiserChain::~DenoiserChain()
+{
+    delete _overlapAdd;
+    
+    for (int i = 0; i < _processors.size(); i++)
+        delete _processors[i];
+
+    for (int i = 0; i < _transientProcessors.size(); i++)
+        delete _transientProcessors[i];
+}
+
+int
+DenoiserChain::getLowLatencySize(int fftSize, int overlap)
+{
+    // At least 2 hops
+    return juce::jmax(2*fftSize/overlap, fftSize/4);
+}
+
+// BLDenoiserAudioProcessor
+
 BLDenoiserAudioProcessor::BLDenoiserAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
      : AudioProcessor (BusesProperties()
@@ -62,22 +143,51 @@ BLDenoiserAudioProcessor::BLDenoiserAudioProcessor()
             juce::ParameterID{"softDenoiseParamID", 700}, "Soft Denoise", false),
                      std::make_unique<juce::AudioParameterChoice>(
             juce::ParameterID{"quality", 700}, "Quality",
-            juce::StringArray{"1 - Fast", "2", "3", "4 - Best"}, 0)
+            juce::StringArray{"1 - Fast", "2", "3", "4 - Best"}, 0),
+                     std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID{"resolution", 701}, "Resolution",
+            juce::StringArray{"Auto", "512", "1024", "2048", "4096", "8192"}, 0),
+                     std::make_unique<juce::AudioParameterBool>(
+            juce::ParameterID{"lowLatency", 702}, "Low Latency", false),
+                     std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID{"noiseProfile", 710}, "Noise Profile",
+            juce::StringArray{"1", "2", "3", "4"}, 0),
+                     std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID{"learnMethod", 710}, "Learn Method",
+            juce::StringArray{"Average", "Median", "Min Statistics"}, 0),
+                     std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID{"softMaskLookahead", 720}, "Soft Denoise Lookahead",
+            juce::StringArray{"Centered", "Short", "Causal"}, 0)
                  })
 #endif
 {
+    _noiseProfiles = new NoiseProfileBank(NUM_NOISE_PROFILES);
+    
+    // The chains are built on a background thread when the resolution,
+    // the low latency mode or the soft denoise lookahead changes
+    // (so the latency changes with a crossfade)
+    _chainSwitcher =
+        new ChainSwitcher<DenoiserChain>([this](const ChainContext &context, int setting)
+                                         { return createChain(context, setting); }, 0);
 }
 
 BLDenoiserAudioProcessor::~BLDenoiserAudioProcessor()
 {
-    for (int i = 0; i < _overlapAdds.size(); i++)
-        delete _overlapAdds[i];
+    // Before the worker pool, used by the chains
+    if (_chainSwitcher != nullptr)
+        delete _chainSwitcher;
+    
+    if (_workerPool != nullptr)
+        delete _workerPool;
 
-    for (int i = 0; i < _processors.size(); i++)
-        delete _processors[i];
+    delete _noiseProfiles;
 
-    for (int i = 0; i < _transientProcessors.size(); i++)
-        delete _transientProcessors[i];
+#if BL_PROFILE
+    // Timings of the session
+    juce::File tmpDir = juce::File::getSpecialLocation(juce::File::tempDirectory);
+    Profiler::dumpJSON(tmpDir.getChildFile("BL-Denoiser-profile.json").getFullPathName().toRawUTF8());
+    Profiler::dumpCSV(tmpDir.getChildFile("BL-Denoiser-profile.csv").getFullPathName().toRawUTF8());
+#endif
 }
 
 const juce::String
@@ -155,77 +265,70 @@ void
 BLDenoiserAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     int numInputChannels = getTotalNumInputChannels();
+
+    bool sampleRateChanged = (sampleRate != _sampleRate);
+    _sampleRate = sampleRate;
     
-    int fftSize = Utils::nearestPowerOfTwo(sampleRate/FFT_SIZE_COEFF);
+    auto resolution = _parameters.getRawParameterValue("resolution")->load();
+    int fftSize = getFftSize(resolution);
     
-    if (sampleRate != _sampleRate)
+    if (sampleRateChanged || (fftSize/2 + 1 != _notifiedNumBins))
     {
-        _sampleRate = sampleRate;
-        
         // Notify listener
         if (_sampleRateChangeListener != nullptr)
             _sampleRateChangeListener(sampleRate, fftSize/2 + 1);
-    }
-    
-    auto quality = _parameters.getRawParameterValue("quality")->load();
-    int overlap = getOverlap(quality);
 
-    auto threshold = _parameters.getRawParameterValue("threshold")->load();
+        _notifiedNumBins = fftSize/2 + 1;
+    }
+    _numBins = fftSize/2 + 1;
     
-    if (_overlapAdds.size() != numInputChannels)
+    if (numInputChannels != _numChannels)
     {
-        for (int i = 0; i < _overlapAdds.size(); i++)
-            delete _overlapAdds[i];
-        _overlapAdds.clear();
-        
-        for (int i = 0; i < _processors.size(); i++)
-            delete _processors[i];
-        _processors.clear();
+        _numChannels = numInputChannels;
 
-        for (int i = 0; i < _transientProcessors.size(); i++)
-            delete _transientProcessors[i];
-        _transientProcessors.clear();
-        
-        for (int i = 0; i < numInputChannels; i++)
         {
-            DenoiserProcessor *processor = new DenoiserProcessor(fftSize, overlap, threshold);
-            _processors.push_back(processor);
+            std::lock_guard<std::mutex> lock(_curvesMutex);
 
-            TransientShaperProcessor *transientProcessor = new TransientShaperProcessor(sampleRate);
-            _transientProcessors.push_back(transientProcessor);
-            
-            OverlapAdd *overlapAdd = new OverlapAdd(fftSize, overlap, true, true);
-            overlapAdd->addProcessor(processor);
-            overlapAdd->addProcessor(transientProcessor);
-            _overlapAdds.push_back(overlapAdd);
-        } 
-    }
-
-    if (_mustSetNativeNoiseProfiles)
-    {
-        for (int i = 0; i < _processors.size(); i++)
-        {
-            if (i < _nativeNoiseProfiles.size())
-                _processors[i]->setNativeNoiseCurve(_nativeNoiseProfiles[i]);
+            // Allocate now, the profiles are copied on the audio thread when learning
+            _noiseProfiles->reserve(numInputChannels, MAX_FFT_SIZE/2 + 1);
         }
-
-        _mustSetNativeNoiseProfiles = false;
-    }
-    
-    for (int i = 0; i < _overlapAdds.size(); i++)
-    {
-        _overlapAdds[i]->setFftSize(fftSize);
-        _overlapAdds[i]->setOverlap(overlap);
+        
+#if USE_WORKER_POOL
+        // Delete the chains before the worker pool they use
+        _chainSwitcher->setChain(nullptr, 0, ChainContext());
+        
+        if (_workerPool != nullptr)
+            delete _workerPool;
+        _workerPool = nullptr;
+
+        // The audio thread processes one channel too
+        int numThreads = juce::jmin(numInputChannels - 1,
+                                    juce::SystemStats::getNumCpus() - 1);
+        if (numThreads > 0)
+            _workerPool = new RTWorkerPool(numThreads);
+#endif
     }
 
-    for (int i = 0; i < _processors.size(); i++)
-        _processors[i]->reset(fftSize, overlap, sampleRate);
-
-    for (int i = 0; i < _transientProcessors.size(); i++)
-        _transientProcessors[i]->reset(sampleRate);
+    _nextBufs.resize(numInputChannels);
+    _nextBufPtrs.resize(numInputChannels);
+    for (int i = 0; i < numInputChannels; i++)
+        _nextBufs[i].resize(samplesPerBlock);
+    
+    ChainContext context;
+    context._numChannels = numInputChannels;
+    context._sampleRate = sampleRate;
+    context._maxBlockSize = samplesPerBlock;
+    context._workerPool = _workerPool;
+    
+    // Not on the audio thread, so the chain can be built directly
+    int setting = getChainSetting();
+    DenoiserChain *chain = createChain(context, setting);
+    _chainSwitcher->setChain(chain, setting, context);
+    _chainSwitcher->setFadeSamples(RESOLUTION_FADE_TIME*sampleRate);
+    _chainSwitcher->prepare(numInputChannels, MAX_LATENCY_DIFF);
     
     // Update latency
-    int latency = getLatency(samplesPerBlock);
+    int latency = getLatency(chain, samplesPerBlock);
     setLatencySamples(latency);
     updateHostDisplay();
 }
@@ -281,91 +384,121 @@ BLDenoiserAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::M
         buffer.clear(i, 0, buffer.getNumSamples());
 
     // Retrieve parameter values
-    auto ratio = _parameters.getRawParameterValue("ratio")->load();
-    auto threshold = _parameters.getRawParameterValue("threshold")->load();
-    auto transientBoost = _parameters.getRawParameterValue("transientBoost")->load();
-    auto residualNoise = _parameters.getRawParameterValue("residualNoise")->load();
     auto learnMode = _parameters.getRawParameterValue("learnModeParamID")->load();
-    auto noiseOnly = _parameters.getRawParameterValue("noiseOnlyParamID")->load();
     auto softDenoise = _parameters.getRawParameterValue("softDenoiseParamID")->load();
-    auto quality = _parameters.getRawParameterValue("quality")->load();
-    
-    ratio *= 0.01;
-    threshold *= 0.01;
-    transientBoost *= 0.01;
-    residualNoise *= 0.01;
-    
-    bool qualityChanged = (quality != _prevQualityParam);
-    _prevQualityParam = quality;
-
-    int overlap = getOverlap(quality);
+    auto resolution = _parameters.getRawParameterValue("resolution")->load();
 
     bool softDenoiseChanged = (softDenoise > 0.5) != _prevSoftDenoiseParam;
     _prevSoftDenoiseParam = (softDenoise > 0.5);
+
+    // Build a new chain in background if the resolution, the quality,
+    // the low latency mode or the lookahead changed
+    // Warmup: until the overlap-add output of the new chain is complete
+    int fftSize = getFftSize(resolution);
+    _chainSwitcher->requestSetting(getChainSetting(), 2*fftSize);
+    
+    DenoiserChain *chain = _chainSwitcher->getChain();
+    DenoiserChain *nextChain = _chainSwitcher->getNextChain();
     
     // Set parameters
-    for (int i = 0; i < _processors.size(); i++)
-    {
-        _processors[i]->setThreshold(threshold);
-        _processors[i]->setResNoiseThrs(residualNoise);
-        _processors[i]->setBuildingNoiseStatistics(learnMode);
-        _processors[i]->setAutoResNoise(softDenoise);
-        _processors[i]->setRatio(ratio);
-        _processors[i]->setNoiseOnly((noiseOnly > 0.5));
-        
-        if (qualityChanged)
-        {            
-            _processors[i]->setOverlap(overlap);
-            _overlapAdds[i]->setOverlap(overlap);
-        }
-    }
+    setChainParameters(chain);
+    if (nextChain != nullptr)
+        setChainParameters(nextChain);
 
-    for (int i = 0; i < _transientProcessors.size(); i++)
+    // Switch the noise profile, or apply the profiles restored from the state
+    int noiseProfile = (int)_parameters.getRawParameterValue("noiseProfile")->load();
+    if ((noiseProfile != _currentNoiseProfile) || _noiseProfilesChanged.exchange(false))
     {
-        _transientProcessors[i]->setFreqAmpRatio(TRANSIENT_FREQ_AMP_RATIO);
-        _transientProcessors[i]->setSoftHard(transientBoost);
-    }
+        std::lock_guard<std::mutex> lock(_curvesMutex);
 
+        _currentNoiseProfile = juce::jlimit(0, NUM_NOISE_PROFILES - 1, noiseProfile);
+        
+        applyNoiseProfile(chain);
+        if (nextChain != nullptr)
+            applyNoiseProfile(nextChain);
+    }
     
-    if (qualityChanged || softDenoiseChanged)
+    if (softDenoiseChanged)
     {            
         // Update latency
-        int latency = getLatency(buffer.getNumSamples());
+        int latency = getLatency(chain, buffer.getNumSamples());
         setLatencySamples(latency);
         updateHostDisplay();
     }
+
+    int numSamples = buffer.getNumSamples();
     
-    // Process
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    // The new chain processes a copy of the input
+    if (nextChain != nullptr)
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        
-        vector<float> vecBuf;
-        vecBuf.resize(buffer.getNumSamples());
-        memcpy(vecBuf.data(), channelData, buffer.getNumSamples()*sizeof(float));
-        
-        _overlapAdds[channel]->feed(vecBuf);
+        for (int i = 0; i < totalNumInputChannels; i++)
+        {
+            _nextBufs[i].resize(numSamples);
+            memcpy(_nextBufs[i].data(), buffer.getReadPointer(i), numSamples*sizeof(float));
+            
+            _nextBufPtrs[i] = _nextBufs[i].data();
+        }
+
+        nextChain->_overlapAdd->process(_nextBufPtrs.data(), _nextBufPtrs.data(), numSamples);
+    }
+    
+    // Process, in place
+    chain->_overlapAdd->process(buffer.getArrayOfReadPointers(),
+                                buffer.getArrayOfWritePointers(),
+                                numSamples);
+
+    if (nextChain != nullptr)
+    {
+        // Align the two chains during the switch
+        _chainSwitcher->setLatencies(getLatency(chain, numSamples),
+                                     getLatency(nextChain, numSamples));
         
-        vector<float> outBuf;
-        int numSamplesToFlush = _overlapAdds[channel]->getOutSamples(&outBuf, buffer.getNumSamples());
-        _overlapAdds[channel]->flushOutSamples(numSamplesToFlush);
+        for (int i = 0; i < totalNumInputChannels; i++)
+            _chainSwitcher->crossfade(i, buffer.getWritePointer(i), _nextBufs[i].data(), numSamples);
 
-        memcpy(channelData, outBuf.data(), buffer.getNumSamples()*sizeof(float));
+        if (_chainSwitcher->advance(numSamples))
+            // The new chain is now the current one
+        {
+            chain = _chainSwitcher->getChain();
+
+            _numBins = chain->_fftSize/2 + 1;
+            
+            // Update latency, now that the chains are not mixed anymore
+            int latency = getLatency(chain, numSamples);
+            setLatencySamples(latency);
+            updateHostDisplay();
+        }
     }
     
     // Get curves
     {
         std::lock_guard<std::mutex> lock(_curvesMutex);
 
-        if (_processors[0]->newCurvesAvailable())
+        DenoiserProcessor *processor = chain->_processors[0];
+        
+        if (processor->newCurvesAvailable())
         {
-            _processors[0]->getSignalBuffer(&_signalBuffer);
-            _processors[0]->getNoiseBuffer(&_noiseBuffer);
-            _processors[0]->getNoiseCurve(&_noiseProfileBuffer);
+            processor->getSignalBuffer(&_signalBuffer);
+            processor->getNoiseBuffer(&_noiseBuffer);
+            processor->getNoiseCurve(&_noiseProfileBuffer);
 
             _newBuffersAvailable = true;
             
-            _processors[0]->touchNewCurves();
+            processor->touchNewCurves();
+        }
+
+        // Keep a copy of the noise profiles, for the new chains and the state
+        if (learnMode > 0.5)
+        {
+            vector<vector<float> > *curves = _noiseProfiles->getCurves(_currentNoiseProfile);
+            for (int i = 0; i < chain->_processors.size(); i++)
+            {
+                if (i < curves->size())
+                    chain->_processors[i]->getNativeNoiseCurve(&(*curves)[i]);
+            }
+
+            _noiseProfiles->setSampleRate(_currentNoiseProfile,
+                                          chain->_processors[0]->getNativeNoiseSampleRate());
         }
     }
 }
@@ -386,33 +519,19 @@ void BLDenoiserAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
     juce::ValueTree stateToSave = _parameters.state.createCopy();
 
     // Add a unified version number for parameters and noise profile
-    constexpr int version = 700; // Unified version number
+    // 710: several noise profiles, in a binary block
+    constexpr int version = 710; // Unified version number
     stateToSave.setProperty("version", version, nullptr);
 
-    vector<vector< float> > noiseProfileArray;
-    noiseProfileArray.resize(_processors.size());
-    for (int i = 0; i < _processors.size(); i++)
-        _processors[i]->getNativeNoiseCurve(&noiseProfileArray[i]);
-    
-    // Serialize the noise profile array into a MemoryBlock
-    juce::MemoryBlock noiseProfileBlock;
+    NoiseProfileBank noiseProfiles(NUM_NOISE_PROFILES);
     {
-        juce::MemoryOutputStream noiseStream(noiseProfileBlock, true);
-
-        // Write the number of vectors
-        noiseStream.writeInt(static_cast<int>(noiseProfileArray.size()));
+        std::lock_guard<std::mutex> lock(_curvesMutex);
 
-        // Write each vector
-        for (const auto& vector : noiseProfileArray)
-        {
-            noiseStream.writeInt(static_cast<int>(vector.size()));
-            for (float value : vector)
-                noiseStream.writeFloat(value);
-        }
+        noiseProfiles.copyProfiles(*_noiseProfiles);
     }
-
-    // Convert the noise profile binary data to a Base64 string and save it
-    stateToSave.setProperty("noiseProfile", noiseProfileBlock.toBase64Encoding(), nullptr);
+    
+    // Save the noise profiles in the compact format
+    noiseProfiles.writeToState(&stateToSave);
 
     // Serialize the entire state to destData
     juce::MemoryOutputStream stream(destData, true);
@@ -427,53 +546,25 @@ void BLDenoiserAudioProcessor::setStateInformation(const void* data, int sizeInB
     {
         // Check the version number
         int version = newState.getProperty("version", 0);
-        if (version == 700)
+        // 700: a single noise profile, as a base64 string
+        if ((version == 700) || (version == 710))
         {
             // Load the parameter state
             _parameters.state = newState;
 
-            // Restore the noise profile from the binary blob
-            if (newState.hasProperty("noiseProfile"))
+            // Restore the noise profiles
+            NoiseProfileBank noiseProfiles(NUM_NOISE_PROFILES);
+            if (noiseProfiles.readFromState(newState))
             {
-                vector<vector<float> > noiseProfileArray;
+                std::lock_guard<std::mutex> lock(_curvesMutex);
+
+                // Keep the allocated size (see prepareToPlay())
+                _noiseProfiles->copyProfiles(noiseProfiles);
                 
-                juce::String encodedBlob = newState["noiseProfile"].toString();
-                juce::MemoryBlock noiseProfileBlock;
-                if (noiseProfileBlock.fromBase64Encoding(encodedBlob))
-                {
-                    juce::MemoryInputStream noiseStream(noiseProfileBlock, false);
-
-                    // Clear existing data
-                    noiseProfileArray.clear();
-
-                    // Read the number of vectors
-                    int numVectors = noiseStream.readInt();
-
-                    // Read each vector
-                    for (int i = 0; i < numVectors; ++i)
-                    {
-                        int vectorSize = noiseStream.readInt();
-                        std::vector<float> vector;
-
-                        for (int j = 0; j < vectorSize; ++j)
-                            vector.push_back(noiseStream.readFloat());
-
-                        noiseProfileArray.push_back(std::move(vector));
-                    }
-                }
-
-                for (int i = 0; i < _processors.size(); i++)
-                {
-                    if (i < noiseProfileArray.size())
-                        _processors[i]->setNativeNoiseCurve(noiseProfileArray[i]);
-                }
-
-                if (_processors.empty())
-                    // prepareToPlay has not been called yet
-                {
-                    _nativeNoiseProfiles = noiseProfileArray;
-                    _mustSetNativeNoiseProfiles = true;
-                }
+                // Applied in processBlock(), the audio thread may be learning
+                // (if prepareToPlay has not been called yet, the profiles will be
+                // set when creating the chain)
+                _noiseProfilesChanged = true;
             }
         }
         else
@@ -495,11 +586,25 @@ BLDenoiserAudioProcessor::getBuffers(vector<float> *signalBuffer,
                                      vector<float> *noiseBuffer,
                                      vector<float> *noiseProfileBuffer)
 {
+    // The resolution has changed, notify the listener (here on the message thread)
+    int numBins = _numBins;
+    if ((numBins != _notifiedNumBins) && (numBins > 0))
+    {
+        if (_sampleRateChangeListener != nullptr)
+            _sampleRateChangeListener(_sampleRate, numBins);
+
+        _notifiedNumBins = numBins;
+    }
+    
     std::lock_guard<std::mutex> lock(_curvesMutex);
     
     if (!_newBuffersAvailable)
         return false;
 
+    // Buffers from the previous resolution
+    if (_signalBuffer.size() != numBins)
+        return false;
+
     *signalBuffer = _signalBuffer;
     *noiseBuffer = _noiseBuffer;
     *noiseProfileBuffer = _noiseProfileBuffer;
@@ -509,6 +614,22 @@ BLDenoiserAudioProcessor::getBuffers(vector<float> *signalBuffer,
     return true;
 }
 
+juce::String
+BLDenoiserAudioProcessor::getNoiseProfileName(int index)
+{
+    std::lock_guard<std::mutex> lock(_curvesMutex);
+
+    return _noiseProfiles->getName(index);
+}
+
+void
+BLDenoiserAudioProcessor::setNoiseProfileName(int index, const juce::String &name)
+{
+    std::lock_guard<std::mutex> lock(_curvesMutex);
+
+    _noiseProfiles->setName(index, name);
+}
+
 int
 BLDenoiserAudioProcessor::getOverlap(int quality)
 {
@@ -536,27 +657,187 @@ BLDenoiserAudioProcessor::getOverlap(int quality)
 }
 
 int
-BLDenoiserAudioProcessor::getLatency(int blockSize)
+BLDenoiserAudioProcessor::getFftSize(int resolution)
 {
-    if (_processors.empty())
-        return 0;
+    if (resolution == 0)
+        // Auto
+        return Utils::nearestPowerOfTwo(_sampleRate/FFT_SIZE_COEFF);
     
-    int fftSize = Utils::nearestPowerOfTwo(_sampleRate/FFT_SIZE_COEFF);
+    int fftSize = MIN_FFT_SIZE << (resolution - 1);
+    if (fftSize > MAX_FFT_SIZE)
+        fftSize = MAX_FFT_SIZE;
+
+    return fftSize;
+}
+
+int
+BLDenoiserAudioProcessor::getChainSetting()
+{
+    auto resolution = _parameters.getRawParameterValue("resolution")->load();
+    auto lowLatency = _parameters.getRawParameterValue("lowLatency")->load();
+
+    auto softMaskLookahead = _parameters.getRawParameterValue("softMaskLookahead")->load();
     auto quality = _parameters.getRawParameterValue("quality")->load();
-    int overlap = getOverlap(quality);
-    int hopSize = fftSize/overlap;
     
-    int latency = fftSize - hopSize;
+    int setting = getFftSize(resolution);
+    if (lowLatency > 0.5)
+        setting |= LOW_LATENCY_FLAG;
+
+    setting |= ((int)softMaskLookahead << SOFT_MASK_LOOKAHEAD_SHIFT);
+    setting |= ((int)quality << QUALITY_SHIFT);
+    
+    return setting;
+}
+
+int
+BLDenoiserAudioProcessor::getSoftMaskLookahead(int choice)
+{
+    switch(choice)
+    {
+        case 0:
+            return WienerSoftMasking::LOOKAHEAD_CENTERED;
+            break;
+
+        case 1:
+            // One frame
+            return 1;
+            break;
+            
+        case 2:
+            // Causal, no added latency
+            return 0;
+            break;
+
+        default:
+            return WienerSoftMasking::LOOKAHEAD_CENTERED;
+    }
+}
+
+int
+BLDenoiserAudioProcessor::getLatency(DenoiserChain *chain, int blockSize)
+{
+    if (chain == nullptr)
+        return 0;
+    
+    int hopSize = chain->_fftSize/chain->_overlap;
+
+    // Reduced in low latency mode
+    int latency = chain->_overlapAdd->getLatency();
 
     if (blockSize < hopSize)
         latency += hopSize - blockSize;
 
-    int processorLatency = _processors[0]->getLatency();
+    int processorLatency = chain->_processors[0]->getLatency();
     latency += processorLatency;
 
     return latency;
 }
 
+DenoiserChain *
+BLDenoiserAudioProcessor::createChain(const ChainContext &context, int setting)
+{
+    int fftSize = setting & (LOW_LATENCY_FLAG - 1);
+    bool lowLatency = ((setting & LOW_LATENCY_FLAG) != 0);
+    int softMaskLookahead = getSoftMaskLookahead((setting >> SOFT_MASK_LOOKAHEAD_SHIFT) &
+                                                 SOFT_MASK_LOOKAHEAD_MASK);
+    int overlap = getOverlap(setting >> QUALITY_SHIFT);
+    
+    auto threshold = _parameters.getRawParameterValue("threshold")->load();
+    
+    DenoiserChain *chain = new DenoiserChain(context._numChannels, fftSize, overlap, lowLatency,
+                                             context._sampleRate, threshold);
+
+    // So that the output rings don't grow on the audio thread
+    chain->_overlapAdd->setMaxBlockSize(context._maxBlockSize);
+
+    // The chain keeps its latency
+    for (int i = 0; i < chain->_processors.size(); i++)
+        chain->_processors[i]->setSoftMaskingLookahead(softMaskLookahead);
+
+    // Copy the profile under the lock, and resample it after
+    // (the audio thread takes the lock at each block)
+    vector<vector<float> > curves;
+    float profileSampleRate;
+    {
+        std::lock_guard<std::mutex> lock(_curvesMutex);
+
+        curves = *_noiseProfiles->getCurves(_currentNoiseProfile);
+        profileSampleRate = _noiseProfiles->getSampleRate(_currentNoiseProfile);
+    }
+    applyNoiseProfile(chain, curves, profileSampleRate);
+    
+#if USE_WORKER_POOL
+    if (context._workerPool != nullptr)
+        chain->_overlapAdd->setWorkerPool(context._workerPool);
+#endif
+
+    return chain;
+}
+
+void
+BLDenoiserAudioProcessor::setChainParameters(DenoiserChain *chain)
+{
+    auto ratio = _parameters.getRawParameterValue("ratio")->load();
+    auto threshold = _parameters.getRawParameterValue("threshold")->load();
+    auto transientBoost = _parameters.getRawParameterValue("transientBoost")->load();
+    auto residualNoise = _parameters.getRawParameterValue("residualNoise")->load();
+    auto learnMode = _parameters.getRawParameterValue("learnModeParamID")->load();
+    auto noiseOnly = _parameters.getRawParameterValue("noiseOnlyParamID")->load();
+    auto softDenoise = _parameters.getRawParameterValue("softDenoiseParamID")->load();
+    auto learnMethod = _parameters.getRawParameterValue("learnMethod")->load();
+    
+    ratio *= 0.01;
+    threshold *= 0.01;
+    transientBoost *= 0.01;
+    residualNoise *= 0.01;
+
+    for (int i = 0; i < chain->_processors.size(); i++)
+    {
+        DenoiserProcessor *processor = chain->_processors[i];
+        
+        processor->setThreshold(threshold);
+        processor->setResNoiseThrs(residualNoise);
+        processor->setNoiseLearnMethod((int)learnMethod);
+        processor->setBuildingNoiseStatistics(learnMode);
+        processor->setAutoResNoise(softDenoise);
+        processor->setRatio(ratio);
+        processor->setNoiseOnly((noiseOnly > 0.5));
+    }
+
+    for (int i = 0; i < chain->_transientProcessors.size(); i++)
+    {
+        chain->_transientProcessors[i]->setFreqAmpRatio(TRANSIENT_FREQ_AMP_RATIO);
+        chain->_transientProcessors[i]->setSoftHard(transientBoost);
+    }
+}
+
+void
+BLDenoiserAudioProcessor::applyNoiseProfile(DenoiserChain *chain)
+{
+    const vector<vector<float> > &curves = *_noiseProfiles->getCurves(_currentNoiseProfile);
+    float sampleRate = _noiseProfiles->getSampleRate(_currentNoiseProfile);
+
+    applyNoiseProfile(chain, curves, sampleRate);
+}
+
+void
+BLDenoiserAudioProcessor::applyNoiseProfile(DenoiserChain *chain,
+                                            const vector<vector<float> > &curves,
+                                            float sampleRate)
+{
+    // Resampled to the fft size of the chain
+    for (int i = 0; i < chain->_processors.size(); i++)
+    {
+        DenoiserProcessor *processor = chain->_processors[i];
+        
+        if (i < curves.size())
+            processor->setNativeNoiseCurve(curves[i], sampleRate);
+
+        // Learn the selected profile from the start
+        processor->clearNoiseStatistics();
+    }
+}
+
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE
 createPluginFilter()
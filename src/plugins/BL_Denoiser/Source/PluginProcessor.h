@@ -23,9 +23,33 @@ using namespace std;
 
 #include <JuceHeader.h>
 
-class OverlapAdd;
+class MultiChannelOverlapAdd;
+class RTWorkerPool;
 class DenoiserProcessor;
 class TransientShaperProcessor;
+class NoiseProfileBank;
+template <typename T> class ChainSwitcher;
+
+// Everything that depends on the fft size
+class DenoiserChain
+{
+public:
+    DenoiserChain(int numChannels, int fftSize, int overlap, bool lowLatency,
+                  double sampleRate, float threshold);
+    virtual ~DenoiserChain();
+
+    // Size of the overlap-add synthesis window in low latency mode
+    static int getLowLatencySize(int fftSize, int overlap);
+    
+    int _fftSize;
+    int _overlap;
+    bool _lowLatency;
+    
+    MultiChannelOverlapAdd *_overlapAdd = nullptr;
+    vector<DenoiserProcessor *> _processors;
+    vector<TransientShaperProcessor *> _transientProcessors;
+};
+
 class BLDenoiserAudioProcessor  : public juce::AudioProcessor
 {
 public:
@@ -67,6 +91,10 @@ public:
     bool getBuffers(vector<float> *signalBuffer,
                     vector<float> *noiseBuffer,
                     vector<float> *noiseProfileBuffer);
+
+    // The profile is selected with the "noiseProfile" parameter
+    juce::String getNoiseProfileName(int index);
+    void setNoiseProfileName(int index, const juce::String &name);
     
 public:
     juce::AudioProcessorValueTreeState _parameters;
@@ -74,18 +102,49 @@ public:
 private:
     int getOverlap(int quality);
 
-    int getLatency(int blockSize);
+    int getFftSize(int resolution);
+
+    // Fft size, low latency flag, soft masking lookahead and quality (overlap),
+    // a new chain is built when it changes
+    int getChainSetting();
+
+    // From the "softMaskLookahead" parameter
+    // (see WienerSoftMasking::setLookahead())
+    static int getSoftMaskLookahead(int choice);
     
-    vector<OverlapAdd *> _overlapAdds;
-    vector<DenoiserProcessor *> _processors;
-    vector<TransientShaperProcessor *> _transientProcessors;
+    int getLatency(DenoiserChain *chain, int blockSize);
+
+    // Called on the message thread, or on the background thread
+    // when the resolution, the quality, the low latency mode or the lookahead changes
+    DenoiserChain *createChain(const ChainContext &context, int setting);
+
+    void setChainParameters(DenoiserChain *chain);
+
+    // Set the curves of the current noise profile to the processors
+    // (with the curves mutex locked)
+    void applyNoiseProfile(DenoiserChain *chain);
+    // Set a copy of the curves, without the lock
+    static void applyNoiseProfile(DenoiserChain *chain,
+                                  const vector<vector<float> > &curves, float sampleRate);
+    
+    ChainSwitcher<DenoiserChain> *_chainSwitcher = nullptr;
+    RTWorkerPool *_workerPool = nullptr;
+
+    int _numChannels = 0;
+    
+    // Input copy, for the new chain while switching
+    vector<vector<float> > _nextBufs;
+    vector<float *> _nextBufPtrs;
     
-    int _prevQualityParam = 0;
     bool _prevSoftDenoiseParam = false;
     
     double _sampleRate = 0.0;
     SampleRateChangeListener _sampleRateChangeListener = nullptr;
 
+    // The number of bins changes with the resolution
+    std::atomic<int> _numBins { 0 };
+    int _notifiedNumBins = 0;
+
     vector<float> _signalBuffer;
     vector<float> _noiseBuffer;
     vector<float> _noiseProfileBuffer;
@@ -93,8 +152,14 @@ private:
     std::mutex _curvesMutex;
     bool _newBuffersAvailable = false;
 
-    vector<vector<float> > _nativeNoiseProfiles;
-    bool _mustSetNativeNoiseProfiles = false;
+    // Copy of the noise profiles, for the new chains and the state
+    // (protected by the curves mutex)
+    NoiseProfileBank *_noiseProfiles = nullptr;
+    int _currentNoiseProfile = 0;
+
+    // Set when the profiles are restored from the state,
+    // they are applied to the chains in processBlock()
+    std::atomic<bool> _noiseProfilesChanged { false };
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BLDenoiserAudioProcessor)
 };
@@ -0,0 +1,179 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <stdio.h>
+
+#include <map>
+using namespace std;
+
+#include "BenchResults.h"
+
+// Increased if the meaning of the values changes
+#define RESULTS_VERSION 1
+
+juce::String
+BenchResult::getKey() const
+{
+    return _benchmark + "|" + _signal + "|" + juce::String((int)_sampleRate);
+}
+
+bool
+BenchResults::save(const vector<BenchResult> &results, const juce::var &info,
+                   const juce::File &file, juce::String *error)
+{
+    juce::Array<juce::var> resultsArray;
+    for (int i = 0; i < results.size(); i++)
+    {
+        const BenchResult &result = results[i];
+        
+        juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+        obj->setProperty("benchmark", result._benchmark);
+        obj->setProperty("signal", result._signal);
+        obj->setProperty("sampleRate", result._sampleRate);
+        obj->setProperty("fftSize", result._fftSize);
+        obj->setProperty("stepSize", result._stepSize);
+        obj->setProperty("realtimeFactor", result._realtimeFactor);
+        obj->setProperty("stepTimeP50", result._stepTimeP50);
+        obj->setProperty("stepTimeP90", result._stepTimeP90);
+        obj->setProperty("stepTimeP99", result._stepTimeP99);
+        obj->setProperty("stepTimeMax", result._stepTimeMax);
+        
+        resultsArray.add(juce::var(obj.get()));
+    }
+
+    juce::DynamicObject::Ptr root = new juce::DynamicObject();
+    root->setProperty("version", RESULTS_VERSION);
+    root->setProperty("info", info);
+    root->setProperty("results", resultsArray);
+    
+    if (!file.replaceWithText(juce::JSON::toString(juce::var(root.get()))))
+    {
+        *error = "can't write " + file.getFullPathName();
+        return false;
+    }
+
+    return true;
+}
+
+bool
+BenchResults::load(const juce::File &file, vector<BenchResult> *results,
+                   juce::String *error)
+{
+    results->clear();
+    
+    juce::var root;
+    juce::Result parseResult = juce::JSON::parse(file.loadFileAsString(), root);
+    if (parseResult.failed())
+    {
+        *error = file.getFullPathName() + ": " + parseResult.getErrorMessage();
+        return false;
+    }
+
+    if ((int)root.getProperty("version", 0) != RESULTS_VERSION)
+    {
+        *error = file.getFullPathName() + ": unsupported version";
+        return false;
+    }
+
+    const juce::Array<juce::var> *resultsArray = root["results"].getArray();
+    if (resultsArray == nullptr)
+    {
+        *error = file.getFullPathName() + ": no results";
+        return false;
+    }
+
+    for (int i = 0; i < resultsArray->size(); i++)
+    {
+        const juce::var &obj = resultsArray->getReference(i);
+        
+        BenchResult result;
+        result._benchmark = obj["benchmark"].toString();
+        result._signal = obj["signal"].toString();
+        result._sampleRate = obj["sampleRate"];
+        result._fftSize = obj["fftSize"];
+        result._stepSize = obj["stepSize"];
+        result._realtimeFactor = obj["realtimeFactor"];
+        result._stepTimeP50 = obj["stepTimeP50"];
+        result._stepTimeP90 = obj["stepTimeP90"];
+        result._stepTimeP99 = obj["stepTimeP99"];
+        result._stepTimeMax = obj["stepTimeMax"];
+
+        results->push_back(result);
+    }
+    
+    return true;
+}
+
+int
+BenchResults::compare(const vector<BenchResult> &results,
+                      const vector<BenchResult> &baseline,
+                      double tolerance)
+{
+    std::map<juce::String, const BenchResult *> baselineMap;
+    for (int i = 0; i < baseline.size(); i++)
+        baselineMap[baseline[i].getKey()] = &baseline[i];
+
+    printf("\n%-40s %10s %10s  %s\n", "Comparison with the baseline",
+           "rtf", "p99", "");
+    
+    int numRegressions = 0;
+    for (int i = 0; i < results.size(); i++)
+    {
+        const BenchResult &result = results[i];
+
+        auto it = baselineMap.find(result.getKey());
+        if (it == baselineMap.end())
+        {
+            printf("%-40s %10s %10s  new\n", result.getKey().toRawUTF8(), "", "");
+            continue;
+        }
+
+        const BenchResult &base = *it->second;
+        
+        // Relative changes, > 0 is better
+        double rtfChange = (base._realtimeFactor > 0.0) ?
+            result._realtimeFactor/base._realtimeFactor - 1.0 : 0.0;
+        double p99Change = (result._stepTimeP99 > 0.0) ?
+            base._stepTimeP99/result._stepTimeP99 - 1.0 : 0.0;
+
+        const char *status = "ok";
+        if ((rtfChange < -tolerance) || (p99Change < -tolerance))
+        {
+            status = "REGRESSION";
+            numRegressions++;
+        }
+        else if (rtfChange > tolerance)
+            status = "faster";
+        
+        printf("%-40s %+9.1f%% %+9.1f%%  %s\n", result.getKey().toRawUTF8(),
+               rtfChange*100.0, p99Change*100.0, status);
+    }
+
+    return numRegressions;
+}
+
+double
+BenchResults::getPercentile(const vector<double> &sortedValues, double p)
+{
+    if (sortedValues.empty())
+        return 0.0;
+
+    int index = (int)(p*(sortedValues.size() - 1) + 0.5);
+    
+    return sortedValues[juce::jlimit(0, (int)sortedValues.size() - 1, index)];
+}
@@ -0,0 +1,71 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+#include <JuceHeader.h>
+
+// Measures of one benchmark, on one signal at one sample rate
+struct BenchResult
+{
+    juce::String _benchmark;
+    juce::String _signal;
+    double _sampleRate = 0.0;
+    
+    int _fftSize = 0;
+    int _stepSize = 0;
+    
+    // Seconds of audio processed in one second, for one channel
+    // (median over the runs)
+    double _realtimeFactor = 0.0;
+
+    // Processing time of one step (one hop), in microseconds
+    double _stepTimeP50 = 0.0;
+    double _stepTimeP90 = 0.0;
+    double _stepTimeP99 = 0.0;
+    double _stepTimeMax = 0.0;
+
+    // Identifies the same measure in a baseline
+    juce::String getKey() const;
+};
+
+// Save, load and compare the results, in json
+class BenchResults
+{
+public:
+    // info: description of the machine and of the settings
+    static bool save(const vector<BenchResult> &results, const juce::var &info,
+                     const juce::File &file, juce::String *error);
+
+    static bool load(const juce::File &file, vector<BenchResult> *results,
+                     juce::String *error);
+
+    // Print the differences with the baseline
+    // A result is a regression when its realtime factor is lower, or its p99
+    // step time is higher, by more than tolerance (ratio, e.g 0.1)
+    // Returns the number of regressions
+    static int compare(const vector<BenchResult> &results,
+                       const vector<BenchResult> &baseline,
+                       double tolerance);
+
+    // Value at ratio p (0 to 1) of sorted values
+    static double getPercentile(const vector<double> &sortedValues, double p);
+};
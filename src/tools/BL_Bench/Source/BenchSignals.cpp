@@ -0,0 +1,192 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <math.h>
+
+#include "BenchSignals.h"
+
+#define RANDOM_SEED 1234
+
+// -20dB
+#define NOISE_AMP 0.1
+
+// Harmonic tone with vibrato, over a low noise
+#define TONES_FREQ 220.0
+#define TONES_NUM_HARMONICS 16
+#define TONES_VIBRATO_FREQ 5.0
+#define TONES_VIBRATO_DEPTH 0.01
+#define TONES_NOISE_AMP 0.01
+
+// Log sweep over the whole signal
+#define SWEEP_MIN_FREQ 20.0
+#define SWEEP_MAX_FREQ_RATIO 0.45
+
+// Decaying noise bursts, over a low noise
+#define CLICKS_INTERVAL 0.25
+#define CLICKS_DECAY 0.01
+
+void
+BenchSignals::getSyntheticNames(juce::StringArray *names)
+{
+    names->add("noise");
+    names->add("tones");
+    names->add("sweep");
+    names->add("clicks");
+}
+
+void
+BenchSignals::generate(const juce::String &name, double sampleRate,
+                       int numSamples, vector<float> *signal)
+{
+    signal->resize(numSamples);
+    
+    if (name == "tones")
+        generateTones(sampleRate, signal);
+    else if (name == "sweep")
+        generateSweep(sampleRate, signal);
+    else if (name == "clicks")
+        generateClicks(sampleRate, signal);
+    else
+        generateNoise(sampleRate, signal);
+}
+
+bool
+BenchSignals::loadRecorded(const juce::File &file, double sampleRate,
+                           int numSamples, vector<float> *signal,
+                           juce::String *error)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr)
+    {
+        *error = "unsupported or unreadable file";
+        return false;
+    }
+
+    // Only what is needed, after resampling
+    double ratio = reader->sampleRate/sampleRate;
+    int numFileSamples = (int)juce::jmin(reader->lengthInSamples,
+                                         (juce::int64)(numSamples*ratio) + 1);
+    if (numFileSamples <= 0)
+    {
+        *error = "empty file";
+        return false;
+    }
+    
+    juce::AudioBuffer<float> buffer((int)reader->numChannels, numFileSamples);
+    reader->read(&buffer, 0, numFileSamples, 0, true, true);
+
+    // Mono
+    vector<float> mono(numFileSamples, 0.0);
+    for (int c = 0; c < buffer.getNumChannels(); c++)
+        juce::FloatVectorOperations::addWithMultiply(mono.data(), buffer.getReadPointer(c),
+                                                     1.0f/buffer.getNumChannels(),
+                                                     numFileSamples);
+
+    // Resample
+    vector<float> resampled((int)(numFileSamples/ratio));
+    juce::LagrangeInterpolator interpolator;
+    interpolator.process(ratio, mono.data(), resampled.data(), (int)resampled.size());
+
+    if (resampled.empty())
+    {
+        *error = "file too short";
+        return false;
+    }
+    
+    // Loop
+    signal->resize(numSamples);
+    for (int i = 0; i < numSamples; i++)
+        signal->data()[i] = resampled.data()[i % resampled.size()];
+    
+    return true;
+}
+
+void
+BenchSignals::generateNoise(double sampleRate, vector<float> *signal)
+{
+    juce::Random random(RANDOM_SEED);
+    
+    for (int i = 0; i < signal->size(); i++)
+        signal->data()[i] = NOISE_AMP*(2.0*random.nextFloat() - 1.0);
+}
+
+void
+BenchSignals::generateTones(double sampleRate, vector<float> *signal)
+{
+    juce::Random random(RANDOM_SEED);
+
+    double phase = 0.0;
+    for (int i = 0; i < signal->size(); i++)
+    {
+        double t = i/sampleRate;
+        double freq = TONES_FREQ*(1.0 + TONES_VIBRATO_DEPTH*sin(2.0*M_PI*TONES_VIBRATO_FREQ*t));
+        phase += 2.0*M_PI*freq/sampleRate;
+
+        double sample = 0.0;
+        for (int h = 1; h <= TONES_NUM_HARMONICS; h++)
+        {
+            // Keep the harmonics below nyquist
+            if (h*freq > sampleRate*0.5)
+                break;
+            
+            sample += sin(h*phase)/h;
+        }
+        
+        signal->data()[i] = 0.25*sample + TONES_NOISE_AMP*(2.0*random.nextFloat() - 1.0);
+    }
+}
+
+void
+BenchSignals::generateSweep(double sampleRate, vector<float> *signal)
+{
+    double maxFreq = sampleRate*SWEEP_MAX_FREQ_RATIO;
+    double duration = signal->size()/sampleRate;
+    double k = log(maxFreq/SWEEP_MIN_FREQ);
+    
+    for (int i = 0; i < signal->size(); i++)
+    {
+        double t = i/sampleRate;
+        double phase = 2.0*M_PI*SWEEP_MIN_FREQ*duration/k*(exp(t*k/duration) - 1.0);
+        
+        signal->data()[i] = 0.5*sin(phase);
+    }
+}
+
+void
+BenchSignals::generateClicks(double sampleRate, vector<float> *signal)
+{
+    juce::Random random(RANDOM_SEED);
+
+    int interval = (int)(CLICKS_INTERVAL*sampleRate);
+    double decay = exp(-1.0/(CLICKS_DECAY*sampleRate));
+    
+    double env = 0.0;
+    for (int i = 0; i < signal->size(); i++)
+    {
+        if (i % interval == 0)
+            env = 1.0;
+        else
+            env *= decay;
+
+        double noise = 2.0*random.nextFloat() - 1.0;
+        signal->data()[i] = (0.8*env + TONES_NOISE_AMP)*noise;
+    }
+}
@@ -0,0 +1,46 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+#include <JuceHeader.h>
+
+// Input signals of the benchmarks, mono
+// The synthetic signals use a fixed seed, so they are the same for each run
+class BenchSignals
+{
+public:
+    static void getSyntheticNames(juce::StringArray *names);
+
+    static void generate(const juce::String &name, double sampleRate,
+                         int numSamples, vector<float> *signal);
+
+    // Mixed to mono, resampled to sampleRate, and looped or cut to numSamples
+    static bool loadRecorded(const juce::File &file, double sampleRate,
+                             int numSamples, vector<float> *signal,
+                             juce::String *error);
+
+protected:
+    static void generateNoise(double sampleRate, vector<float> *signal);
+    static void generateTones(double sampleRate, vector<float> *signal);
+    static void generateSweep(double sampleRate, vector<float> *signal);
+    static void generateClicks(double sampleRate, vector<float> *signal);
+};
@@ -0,0 +1,588 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <OverlapAdd.h>
+#include <DenoiserProcessor.h>
+#include <AirProcessor.h>
+#include <TransientShaperProcessor.h>
+#include <CrossoverSplitterNBands.h>
+#include <WienerSoftMasking.h>
+#include <PartialTracker.h>
+#include <FilterBank.h>
+#include <Scale.h>
+#include <Utils.h>
+
+#include "Benchmark.h"
+
+// Same values as in the plugins
+#define FFT_SIZE_COEFF 23
+
+#define DENOISER_OVERLAP_0 4
+#define DENOISER_OVERLAP_1 8
+#define DENOISER_OVERLAP_2 16
+#define DENOISER_OVERLAP_3 32
+
+#define DENOISER_THRESHOLD 0.5
+
+#define TRANSIENT_FREQ_AMP_RATIO 0.5
+#define TRANSIENT_SOFT_HARD 0.5
+
+#define AIR_OVERLAP 4
+#define AIR_THRESHOLD -100.0
+
+#define SOFT_MASKING_HISTO_SIZE 8
+
+// Larger histories, where the recursive variances should be faster
+#define SOFT_MASKING_HISTO_SIZE_1 32
+#define SOFT_MASKING_HISTO_SIZE_2 64
+
+// COLA window pairs at small overlaps
+#define WINDOWS_OVERLAP_0 2
+#define WINDOWS_OVERLAP_1 4
+
+// Surround formats (5.1 and 7.1), at the smallest hop of the denoiser
+#define MULTI_CHANNEL_NUM_CHANNELS_0 6
+#define MULTI_CHANNEL_NUM_CHANNELS_1 8
+#define MULTI_CHANNEL_OVERLAP DENOISER_OVERLAP_3
+
+// Split freqs of the crossover benchmark (3 bands)
+#define CROSSOVER_FREQ_0 200.0
+#define CROSSOVER_FREQ_1 2000.0
+
+// The denoiser learns the noise profile on the beginning of the signal
+#define DENOISER_LEARN_SECONDS 1.0
+
+// Copy the frames of the analysis, into preallocated buffers
+class FrameCollector : public OverlapAddProcessor
+{
+public:
+    FrameCollector(vector<vector<complex<float> > > *frames)
+    : _frames(frames) {}
+    
+    void processFFT(vector<complex<float> > *compBuf) override
+    {
+        if (_numFrames < _frames->size())
+            (*_frames)[_numFrames++] = *compBuf;
+    }
+
+    int getNumFrames() const { return _numFrames; }
+    
+protected:
+    vector<vector<complex<float> > > *_frames;
+    int _numFrames = 0;
+};
+
+// Benchmark
+Benchmark::Benchmark(const juce::String &name)
+: _name(name) {}
+
+Benchmark::~Benchmark() {}
+
+const juce::String &
+Benchmark::getName() const
+{
+    return _name;
+}
+
+int
+Benchmark::getStepSize() const
+{
+    return _stepSize;
+}
+
+int
+Benchmark::getFftSize() const
+{
+    return _fftSize;
+}
+
+int
+Benchmark::computeFftSize(double sampleRate)
+{
+    return Utils::nearestPowerOfTwo(sampleRate/FFT_SIZE_COEFF);
+}
+
+void
+Benchmark::createAll(vector<Benchmark *> *benchmarks)
+{
+    benchmarks->push_back(new OverlapAddBenchmark("OverlapAdd", AIR_OVERLAP));
+    benchmarks->push_back(new OverlapAddWindowsBenchmark("OverlapAdd/sqrt-hann-ov2", WINDOWS_OVERLAP_0,
+                                                         Window::SQRT_HANN, Window::SQRT_HANN,
+                                                         WindowCache::NORMALIZE_COLA));
+    benchmarks->push_back(new OverlapAddWindowsBenchmark("OverlapAdd/hann-cola-ov4", WINDOWS_OVERLAP_1,
+                                                         Window::HANN, Window::HANN,
+                                                         WindowCache::NORMALIZE_COLA));
+
+    int numChannels[2] = { MULTI_CHANNEL_NUM_CHANNELS_0, MULTI_CHANNEL_NUM_CHANNELS_1 };
+    for (int i = 0; i < 2; i++)
+    {
+        juce::String name = "OverlapAdd/" + juce::String(numChannels[i]) + "ch-ov" +
+            juce::String(MULTI_CHANNEL_OVERLAP);
+        
+        benchmarks->push_back(new MultiChannelOverlapAddBenchmark(name, numChannels[i],
+                                                                  MULTI_CHANNEL_OVERLAP, true));
+        benchmarks->push_back(new MultiChannelOverlapAddBenchmark(name + "-per-channel",
+                                                                  numChannels[i],
+                                                                  MULTI_CHANNEL_OVERLAP, false));
+    }
+    
+    benchmarks->push_back(new DenoiserBenchmark(DENOISER_OVERLAP_0));
+    benchmarks->push_back(new DenoiserBenchmark(DENOISER_OVERLAP_1));
+    benchmarks->push_back(new DenoiserBenchmark(DENOISER_OVERLAP_2));
+    benchmarks->push_back(new DenoiserBenchmark(DENOISER_OVERLAP_3));
+
+    benchmarks->push_back(new WienerSoftMaskingBenchmark("WienerSoftMasking", SOFT_MASKING_HISTO_SIZE,
+                                                         WienerSoftMasking::SIGMA2_HANN));
+    benchmarks->push_back(new WienerSoftMaskingBenchmark("WienerSoftMasking/h32", SOFT_MASKING_HISTO_SIZE_1,
+                                                         WienerSoftMasking::SIGMA2_HANN));
+    benchmarks->push_back(new WienerSoftMaskingBenchmark("WienerSoftMasking/h64", SOFT_MASKING_HISTO_SIZE_2,
+                                                         WienerSoftMasking::SIGMA2_HANN));
+    benchmarks->push_back(new WienerSoftMaskingBenchmark("WienerSoftMasking/recursive-h8",
+                                                         SOFT_MASKING_HISTO_SIZE,
+                                                         WienerSoftMasking::SIGMA2_HANN_RECURSIVE));
+    benchmarks->push_back(new WienerSoftMaskingBenchmark("WienerSoftMasking/recursive-h32",
+                                                         SOFT_MASKING_HISTO_SIZE_1,
+                                                         WienerSoftMasking::SIGMA2_HANN_RECURSIVE));
+    benchmarks->push_back(new WienerSoftMaskingBenchmark("WienerSoftMasking/recursive-h64",
+                                                         SOFT_MASKING_HISTO_SIZE_2,
+                                                         WienerSoftMasking::SIGMA2_HANN_RECURSIVE));
+    benchmarks->push_back(new PartialTrackerBenchmark());
+    benchmarks->push_back(new AirBenchmark());
+    benchmarks->push_back(new TransientShaperBenchmark());
+    benchmarks->push_back(new CrossoverSplitterBenchmark());
+    benchmarks->push_back(new FilterBankBenchmark());
+}
+
+// OverlapAddBenchmark
+OverlapAddBenchmark::OverlapAddBenchmark(const juce::String &name, int overlap)
+: Benchmark(name), _overlap(overlap) {}
+
+OverlapAddBenchmark::~OverlapAddBenchmark()
+{
+    release();
+}
+
+void
+OverlapAddBenchmark::prepare(const vector<float> &signal, double sampleRate)
+{
+    release();
+    
+    _signal = &signal;
+    
+    _fftSize = computeFftSize(sampleRate);
+    _stepSize = _fftSize/_overlap;
+
+    _output.resize(_stepSize);
+    
+    _overlapAdd = new OverlapAdd(_fftSize, _overlap, true, true);
+
+    createProcessors(sampleRate);
+}
+
+void
+OverlapAddBenchmark::release()
+{
+    if (_overlapAdd != nullptr)
+        delete _overlapAdd;
+    _overlapAdd = nullptr;
+
+    for (int i = 0; i < _processors.size(); i++)
+        delete _processors[i];
+    _processors.clear();
+}
+
+int
+OverlapAddBenchmark::getNumSteps() const
+{
+    return (int)_signal->size()/_stepSize;
+}
+
+void
+OverlapAddBenchmark::processStep(int step)
+{
+    _overlapAdd->process(&_signal->data()[step*_stepSize], _output.data(), _stepSize);
+}
+
+// OverlapAddWindowsBenchmark
+OverlapAddWindowsBenchmark::OverlapAddWindowsBenchmark(const juce::String &name, int overlap,
+                                                       Window::Type anaWindow,
+                                                       Window::Type synthWindow,
+                                                       WindowCache::Normalization normalization)
+: OverlapAddBenchmark(name, overlap), _anaWindow(anaWindow),
+  _synthWindow(synthWindow), _normalization(normalization) {}
+
+void
+OverlapAddWindowsBenchmark::createProcessors(double sampleRate)
+{
+    _overlapAdd->setWindows(_anaWindow, _synthWindow, _normalization);
+}
+
+// MultiChannelOverlapAddBenchmark
+MultiChannelOverlapAddBenchmark::MultiChannelOverlapAddBenchmark(const juce::String &name,
+                                                                 int numChannels, int overlap,
+                                                                 bool multiChannel)
+: Benchmark(name), _numChannels(numChannels), _overlap(overlap),
+  _multiChannel(multiChannel) {}
+
+MultiChannelOverlapAddBenchmark::~MultiChannelOverlapAddBenchmark()
+{
+    release();
+}
+
+void
+MultiChannelOverlapAddBenchmark::prepare(const vector<float> &signal, double sampleRate)
+{
+    release();
+    
+    _signal = &signal;
+    
+    _fftSize = computeFftSize(sampleRate);
+    _stepSize = _fftSize/_overlap;
+
+    _outputs.resize(_numChannels);
+    _inputPtrs.resize(_numChannels);
+    _outputPtrs.resize(_numChannels);
+    for (int i = 0; i < _numChannels; i++)
+    {
+        _outputs[i].resize(_stepSize);
+        _outputPtrs[i] = _outputs[i].data();
+    }
+
+    if (_multiChannel)
+        _multiChannelOverlapAdd = new MultiChannelOverlapAdd(_numChannels, _fftSize, _overlap,
+                                                             true, true);
+    else
+    {
+        for (int i = 0; i < _numChannels; i++)
+            _overlapAdds.push_back(new OverlapAdd(_fftSize, _overlap, true, true));
+    }
+}
+
+void
+MultiChannelOverlapAddBenchmark::release()
+{
+    if (_multiChannelOverlapAdd != nullptr)
+        delete _multiChannelOverlapAdd;
+    _multiChannelOverlapAdd = nullptr;
+
+    for (int i = 0; i < _overlapAdds.size(); i++)
+        delete _overlapAdds[i];
+    _overlapAdds.clear();
+}
+
+int
+MultiChannelOverlapAddBenchmark::getNumSteps() const
+{
+    return (int)_signal->size()/_stepSize;
+}
+
+void
+MultiChannelOverlapAddBenchmark::processStep(int step)
+{
+    const float *input = &_signal->data()[step*_stepSize];
+
+    if (_multiChannel)
+    {
+        for (int i = 0; i < _numChannels; i++)
+            _inputPtrs[i] = input;
+        
+        _multiChannelOverlapAdd->process(_inputPtrs.data(), _outputPtrs.data(), _stepSize);
+
+        return;
+    }
+
+    for (int i = 0; i < _numChannels; i++)
+        _overlapAdds[i]->process(input, _outputPtrs[i], _stepSize);
+}
+
+// DenoiserBenchmark
+DenoiserBenchmark::DenoiserBenchmark(int overlap)
+: OverlapAddBenchmark("DenoiserProcessor/ov" + juce::String(overlap), overlap) {}
+
+void
+DenoiserBenchmark::prepare(const vector<float> &signal, double sampleRate)
+{
+    OverlapAddBenchmark::prepare(signal, sampleRate);
+
+    // Learn the noise profile, like in the plugin
+    DenoiserProcessor *processor = (DenoiserProcessor *)_processors[0];
+    processor->setBuildingNoiseStatistics(true);
+
+    int numLearnSamples = juce::jmin((int)(DENOISER_LEARN_SECONDS*sampleRate),
+                                     (int)signal.size());
+    vector<float> output(numLearnSamples);
+    _overlapAdd->process(signal.data(), output.data(), numLearnSamples);
+    
+    processor->setBuildingNoiseStatistics(false);
+}
+
+void
+DenoiserBenchmark::createProcessors(double sampleRate)
+{
+    DenoiserProcessor *processor = new DenoiserProcessor(_fftSize, _overlap, DENOISER_THRESHOLD);
+    processor->reset(_fftSize, _overlap, sampleRate);
+    processor->setThreshold(DENOISER_THRESHOLD);
+    
+    _processors.push_back(processor);
+    _overlapAdd->addProcessor(processor);
+}
+
+// AirBenchmark
+AirBenchmark::AirBenchmark()
+: OverlapAddBenchmark("AirProcessor", AIR_OVERLAP) {}
+
+void
+AirBenchmark::createProcessors(double sampleRate)
+{
+    AirProcessor *processor = new AirProcessor(_fftSize, _overlap, sampleRate);
+    processor->setThreshold(AIR_THRESHOLD);
+    
+    _processors.push_back(processor);
+    _overlapAdd->addProcessor(processor);
+}
+
+// TransientShaperBenchmark
+TransientShaperBenchmark::TransientShaperBenchmark()
+: OverlapAddBenchmark("TransientShaperProcessor", DENOISER_OVERLAP_0) {}
+
+void
+TransientShaperBenchmark::createProcessors(double sampleRate)
+{
+    TransientShaperProcessor *processor = new TransientShaperProcessor(sampleRate);
+    processor->setFreqAmpRatio(TRANSIENT_FREQ_AMP_RATIO);
+    processor->setSoftHard(TRANSIENT_SOFT_HARD);
+    
+    _processors.push_back(processor);
+    _overlapAdd->addProcessor(processor);
+}
+
+// CrossoverSplitterBenchmark
+CrossoverSplitterBenchmark::CrossoverSplitterBenchmark()
+: Benchmark("CrossoverSplitterNBands") {}
+
+CrossoverSplitterBenchmark::~CrossoverSplitterBenchmark()
+{
+    release();
+}
+
+void
+CrossoverSplitterBenchmark::prepare(const vector<float> &signal, double sampleRate)
+{
+    release();
+
+    _signal = &signal;
+    
+    _fftSize = computeFftSize(sampleRate);
+    _stepSize = _fftSize/AIR_OVERLAP;
+
+    _block.resize(_stepSize);
+    for (int i = 0; i < 3; i++)
+        _bands[i].resize(_stepSize);
+    
+    float splitFreqs[2] = { CROSSOVER_FREQ_0, CROSSOVER_FREQ_1 };
+    _splitter = new CrossoverSplitterNBands(3, splitFreqs, sampleRate);
+}
+
+void
+CrossoverSplitterBenchmark::release()
+{
+    if (_splitter != nullptr)
+        delete _splitter;
+    _splitter = nullptr;
+}
+
+int
+CrossoverSplitterBenchmark::getNumSteps() const
+{
+    return (int)_signal->size()/_stepSize;
+}
+
+void
+CrossoverSplitterBenchmark::processStep(int step)
+{
+    memcpy(_block.data(), &_signal->data()[step*_stepSize], _stepSize*sizeof(float));
+    
+    _splitter->split(_block, _bands);
+}
+
+// SpectrumBenchmark
+SpectrumBenchmark::SpectrumBenchmark(const juce::String &name, int overlap)
+: Benchmark(name), _overlap(overlap) {}
+
+SpectrumBenchmark::~SpectrumBenchmark() {}
+
+void
+SpectrumBenchmark::prepare(const vector<float> &signal, double sampleRate)
+{
+    release();
+
+    _fftSize = computeFftSize(sampleRate);
+    _stepSize = _fftSize/_overlap;
+
+    // Analysis only
+    _frames.resize(signal.size()/_stepSize + 1);
+    for (int i = 0; i < _frames.size(); i++)
+        _frames[i].resize(_fftSize/2 + 1);
+    
+    OverlapAdd overlapAdd(_fftSize, _overlap, true, false);
+    FrameCollector collector(&_frames);
+    overlapAdd.addProcessor(&collector);
+    overlapAdd.feed(signal);
+
+    _frames.resize(collector.getNumFrames());
+
+    _magns.resize(_frames.size());
+    _phases.resize(_frames.size());
+    for (int i = 0; i < _frames.size(); i++)
+        Utils::complexToMagnPhase(&_magns[i], &_phases[i], _frames[i]);
+    
+    createObjects(sampleRate);
+}
+
+void
+SpectrumBenchmark::release()
+{
+    deleteObjects();
+}
+
+int
+SpectrumBenchmark::getNumSteps() const
+{
+    return (int)_frames.size();
+}
+
+// WienerSoftMaskingBenchmark
+WienerSoftMaskingBenchmark::WienerSoftMaskingBenchmark(const juce::String &name, int historySize,
+                                                       WienerSoftMasking::Sigma2Mode sigma2Mode)
+: SpectrumBenchmark(name, AIR_OVERLAP), _historySize(historySize),
+  _sigma2Mode(sigma2Mode) {}
+
+WienerSoftMaskingBenchmark::~WienerSoftMaskingBenchmark()
+{
+    deleteObjects();
+}
+
+void
+WienerSoftMaskingBenchmark::processStep(int step)
+{
+    const vector<float> &magns = _magns[step];
+    
+    // Rough harmonic mask: the bins above the mean of the frame
+    float mean = Utils::computeSum(magns)/magns.size();
+    for (int i = 0; i < _mask.size(); i++)
+        _mask.data()[i] = (magns.data()[i] > mean) ? 1.0 : 0.0;
+
+    _sum = _frames[step];
+    
+    _softMasking->processCentered(&_sum, _mask, &_masked0, &_masked1);
+}
+
+void
+WienerSoftMaskingBenchmark::createObjects(double sampleRate)
+{
+    _softMasking = new WienerSoftMasking(_fftSize, _overlap, _historySize);
+    _softMasking->setSigma2Mode(_sigma2Mode);
+    
+    _mask.resize(_fftSize/2 + 1);
+    _sum.resize(_fftSize/2 + 1);
+    _masked0.resize(_fftSize/2 + 1);
+    _masked1.resize(_fftSize/2 + 1);
+}
+
+void
+WienerSoftMaskingBenchmark::deleteObjects()
+{
+    if (_softMasking != nullptr)
+        delete _softMasking;
+    _softMasking = nullptr;
+}
+
+// PartialTrackerBenchmark
+PartialTrackerBenchmark::PartialTrackerBenchmark()
+: SpectrumBenchmark("PartialTracker", AIR_OVERLAP) {}
+
+PartialTrackerBenchmark::~PartialTrackerBenchmark()
+{
+    deleteObjects();
+}
+
+void
+PartialTrackerBenchmark::processStep(int step)
+{
+    // Same calls as AirProcessor
+    _partialTracker->setData(_magns[step], _phases[step]);
+    _partialTracker->detectPartials();
+    _partialTracker->filterPartials();
+    _partialTracker->extractNoiseEnvelope();
+
+    _partialTracker->getNoiseEnvelope(&_noiseEnvelope);
+}
+
+void
+PartialTrackerBenchmark::createObjects(double sampleRate)
+{
+    _partialTracker = new PartialTracker(_fftSize, sampleRate);
+    _partialTracker->setThreshold(AIR_THRESHOLD);
+
+    _noiseEnvelope.resize(_fftSize/2 + 1);
+}
+
+void
+PartialTrackerBenchmark::deleteObjects()
+{
+    if (_partialTracker != nullptr)
+        delete _partialTracker;
+    _partialTracker = nullptr;
+}
+
+// FilterBankBenchmark
+FilterBankBenchmark::FilterBankBenchmark()
+: SpectrumBenchmark("FilterBank", AIR_OVERLAP) {}
+
+FilterBankBenchmark::~FilterBankBenchmark()
+{
+    deleteObjects();
+}
+
+void
+FilterBankBenchmark::processStep(int step)
+{
+    const vector<float> &magns = _magns[step];
+    
+    // Same number of filters as the partial tracker
+    _filterBank->hzToTarget(&_melMagns, magns, _sampleRate, magns.size());
+    _filterBank->targetToHz(&_hzMagns, _melMagns, _sampleRate, magns.size());
+}
+
+void
+FilterBankBenchmark::createObjects(double sampleRate)
+{
+    _filterBank = new FilterBank(Scale::MEL_FILTER);
+    _sampleRate = sampleRate;
+
+    _melMagns.resize(_fftSize/2 + 1);
+    _hzMagns.resize(_fftSize/2 + 1);
+}
+
+void
+FilterBankBenchmark::deleteObjects()
+{
+    if (_filterBank != nullptr)
+        delete _filterBank;
+    _filterBank = nullptr;
+}
@@ -0,0 +1,289 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#pragma once
+
+#include <vector>
+#include <complex>
+using namespace std;
+
+#include <JuceHeader.h>
+
+#include <WindowCache.h>
+#include <WienerSoftMasking.h>
+
+class OverlapAdd;
+class MultiChannelOverlapAdd;
+class OverlapAddProcessor;
+class CrossoverSplitterNBands;
+class PartialTracker;
+class FilterBank;
+
+// One DSP object of bluelab-lib, measured on one mono signal
+// The signal is processed step by step (one hop for the spectral objects),
+// and only the steps are timed
+class Benchmark
+{
+public:
+    Benchmark(const juce::String &name);
+    virtual ~Benchmark();
+
+    const juce::String &getName() const;
+
+    // Not timed: create the objects, and precompute their input data
+    virtual void prepare(const vector<float> &signal, double sampleRate) = 0;
+
+    // Not timed: delete the objects
+    virtual void release() = 0;
+
+    virtual int getNumSteps() const = 0;
+
+    // Number of signal samples processed by each step
+    int getStepSize() const;
+
+    int getFftSize() const;
+
+    // Timed
+    virtual void processStep(int step) = 0;
+
+    // Same fft size as the plugins, in auto resolution
+    static int computeFftSize(double sampleRate);
+    
+    // All the benchmarks of the suite
+    static void createAll(vector<Benchmark *> *benchmarks);
+
+protected:
+    juce::String _name;
+
+    int _fftSize = 0;
+    int _stepSize = 0;
+};
+
+// The signal goes through an OverlapAdd, with some processors
+// (or no processor, to measure the overlap-add alone)
+class OverlapAddBenchmark : public Benchmark
+{
+public:
+    OverlapAddBenchmark(const juce::String &name, int overlap);
+    ~OverlapAddBenchmark() override;
+    
+    void prepare(const vector<float> &signal, double sampleRate) override;
+    void release() override;
+
+    int getNumSteps() const override;
+    
+    void processStep(int step) override;
+
+protected:
+    // Create the processors and add them to _overlapAdd
+    virtual void createProcessors(double sampleRate) {}
+    
+    int _overlap;
+    
+    const vector<float> *_signal = nullptr;
+    vector<float> _output;
+    
+    OverlapAdd *_overlapAdd = nullptr;
+    vector<OverlapAddProcessor *> _processors;
+};
+
+// The overlap-add alone, with other windows than Hann/Hann
+class OverlapAddWindowsBenchmark : public OverlapAddBenchmark
+{
+public:
+    OverlapAddWindowsBenchmark(const juce::String &name, int overlap,
+                               Window::Type anaWindow, Window::Type synthWindow,
+                               WindowCache::Normalization normalization);
+    
+protected:
+    void createProcessors(double sampleRate) override;
+
+    Window::Type _anaWindow;
+    Window::Type _synthWindow;
+    WindowCache::Normalization _normalization;
+};
+
+// The overlap-add alone, on several channels (the same signal on each one)
+// Either all the channels in one MultiChannelOverlapAdd, hop by hop,
+// or one OverlapAdd for each channel
+// Each step processes one hop of all the channels
+class MultiChannelOverlapAddBenchmark : public Benchmark
+{
+public:
+    MultiChannelOverlapAddBenchmark(const juce::String &name, int numChannels,
+                                    int overlap, bool multiChannel);
+    ~MultiChannelOverlapAddBenchmark() override;
+    
+    void prepare(const vector<float> &signal, double sampleRate) override;
+    void release() override;
+
+    int getNumSteps() const override;
+    
+    void processStep(int step) override;
+
+protected:
+    int _numChannels;
+    int _overlap;
+    bool _multiChannel;
+    
+    const vector<float> *_signal = nullptr;
+    vector<vector<float> > _outputs;
+    vector<const float *> _inputPtrs;
+    vector<float *> _outputPtrs;
+    
+    MultiChannelOverlapAdd *_multiChannelOverlapAdd = nullptr;
+    vector<OverlapAdd *> _overlapAdds;
+};
+
+class DenoiserBenchmark : public OverlapAddBenchmark
+{
+public:
+    DenoiserBenchmark(int overlap);
+
+    void prepare(const vector<float> &signal, double sampleRate) override;
+    
+protected:
+    void createProcessors(double sampleRate) override;
+};
+
+class AirBenchmark : public OverlapAddBenchmark
+{
+public:
+    AirBenchmark();
+    
+protected:
+    void createProcessors(double sampleRate) override;
+};
+
+class TransientShaperBenchmark : public OverlapAddBenchmark
+{
+public:
+    TransientShaperBenchmark();
+    
+protected:
+    void createProcessors(double sampleRate) override;
+};
+
+// Time domain, processed by blocks of one Air hop
+class CrossoverSplitterBenchmark : public Benchmark
+{
+public:
+    CrossoverSplitterBenchmark();
+    ~CrossoverSplitterBenchmark() override;
+    
+    void prepare(const vector<float> &signal, double sampleRate) override;
+    void release() override;
+
+    int getNumSteps() const override;
+    
+    void processStep(int step) override;
+
+protected:
+    const vector<float> *_signal = nullptr;
+    vector<float> _block;
+    vector<float> _bands[3];
+    
+    CrossoverSplitterNBands *_splitter = nullptr;
+};
+
+// The spectral objects that are not OverlapAddProcessors
+// The frames are computed in prepare(), then each step processes one frame
+class SpectrumBenchmark : public Benchmark
+{
+public:
+    SpectrumBenchmark(const juce::String &name, int overlap);
+    ~SpectrumBenchmark() override;
+    
+    void prepare(const vector<float> &signal, double sampleRate) override;
+    void release() override;
+
+    int getNumSteps() const override;
+
+protected:
+    virtual void createObjects(double sampleRate) = 0;
+    // Also called by the destructors
+    virtual void deleteObjects() = 0;
+    
+    int _overlap;
+    
+    vector<vector<complex<float> > > _frames;
+    vector<vector<float> > _magns;
+    vector<vector<float> > _phases;
+};
+
+class WienerSoftMaskingBenchmark : public SpectrumBenchmark
+{
+public:
+    WienerSoftMaskingBenchmark(const juce::String &name, int historySize,
+                               WienerSoftMasking::Sigma2Mode sigma2Mode);
+    ~WienerSoftMaskingBenchmark() override;
+
+    void processStep(int step) override;
+    
+protected:
+    void createObjects(double sampleRate) override;
+    void deleteObjects() override;
+
+    int _historySize;
+    WienerSoftMasking::Sigma2Mode _sigma2Mode;
+    
+    WienerSoftMasking *_softMasking = nullptr;
+
+    vector<float> _mask;
+    vector<complex<float> > _sum;
+    vector<complex<float> > _masked0;
+    vector<complex<float> > _masked1;
+};
+
+class PartialTrackerBenchmark : public SpectrumBenchmark
+{
+public:
+    PartialTrackerBenchmark();
+    ~PartialTrackerBenchmark() override;
+
+    void processStep(int step) override;
+    
+protected:
+    void createObjects(double sampleRate) override;
+    void deleteObjects() override;
+
+    PartialTracker *_partialTracker = nullptr;
+
+    vector<float> _noiseEnvelope;
+};
+
+// Mel filter bank and inverse, as used by the partial tracker
+class FilterBankBenchmark : public SpectrumBenchmark
+{
+public:
+    FilterBankBenchmark();
+    ~FilterBankBenchmark() override;
+
+    void processStep(int step) override;
+    
+protected:
+    void createObjects(double sampleRate) override;
+    void deleteObjects() override;
+
+    FilterBank *_filterBank = nullptr;
+
+    double _sampleRate = 0.0;
+    
+    vector<float> _melMagns;
+    vector<float> _hzMagns;
+};
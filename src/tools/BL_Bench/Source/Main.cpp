@@ -0,0 +1,372 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <stdio.h>
+
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+#include <JuceHeader.h>
+
+#include <FftEngine.h>
+
+#include "Benchmark.h"
+#include "BenchSignals.h"
+#include "BenchResults.h"
+
+#define DEFAULT_DURATION 10.0
+#define MAX_DURATION 600.0
+
+#define DEFAULT_NUM_RUNS 3
+#define MAX_NUM_RUNS 100
+
+// Percent
+#define DEFAULT_TOLERANCE 10.0
+
+struct BenchOptions
+{
+    vector<double> _sampleRates = { 44100.0, 48000.0, 96000.0, 192000.0 };
+    
+    // Seconds of each signal
+    double _duration = DEFAULT_DURATION;
+
+    // Timed runs, after one warm-up run
+    int _numRuns = DEFAULT_NUM_RUNS;
+
+    juce::StringArray _signals;
+    juce::Array<juce::File> _inputFiles;
+
+    // Only the benchmarks whose name contains it
+    juce::String _filter;
+
+    juce::File _outputFile;
+    juce::File _baselineFile;
+    double _tolerance = DEFAULT_TOLERANCE;
+
+    bool _list = false;
+
+    // Only the fft backends
+    bool _fft = false;
+};
+
+static void
+printUsage()
+{
+    printf("Usage: BL_Bench [options]\n"
+           "\n"
+           "Measure the DSP objects of bluelab-lib, on synthetic and recorded signals.\n"
+           "The realtime factor is for one channel. The step time is the processing\n"
+           "time of one hop, in microseconds.\n"
+           "\n"
+           "Options:\n"
+           "  --list                  List the benchmarks and the signals\n"
+           "  --fft                   Only measure the fft backends, at each fft size\n"
+           "  --filter <text>         Only the benchmarks whose name contains text\n"
+           "  --signals <a,b,...>     Synthetic signals (default: all)\n"
+           "  --input <file>          Add a recorded signal (can be repeated)\n"
+           "  --sample-rates <a,b,..> Default: 44100,48000,96000,192000\n"
+           "  --duration <seconds>    Length of each signal (default: %g)\n"
+           "  --runs <n>              Timed runs, after a warm-up run (default: %d)\n"
+           "  --output <file.json>    Save the results\n"
+           "  --baseline <file.json>  Compare with saved results, exit with 1 on regression\n"
+           "  --tolerance <percent>   Allowed slowdown before a regression (default: %g)\n",
+           DEFAULT_DURATION, DEFAULT_NUM_RUNS, DEFAULT_TOLERANCE);
+}
+
+static bool
+parseArguments(int argc, char *argv[], BenchOptions *options)
+{
+    BenchSignals::getSyntheticNames(&options->_signals);
+    
+    for (int i = 1; i < argc; i++)
+    {
+        juce::String arg(argv[i]);
+
+        if (arg == "--list")
+        {
+            options->_list = true;
+            continue;
+        }
+
+        if (arg == "--fft")
+        {
+            options->_fft = true;
+            continue;
+        }
+
+        if (!arg.startsWith("--") || (i == argc - 1))
+        {
+            fprintf(stderr, "Error: unexpected argument %s\n", arg.toRawUTF8());
+            return false;
+        }
+        
+        juce::String value(argv[++i]);
+
+        if (arg == "--filter")
+            options->_filter = value;
+        else if (arg == "--signals")
+        {
+            options->_signals.clear();
+            options->_signals.addTokens(value, ",", "");
+            options->_signals.removeEmptyStrings();
+        }
+        else if (arg == "--input")
+            options->_inputFiles.add(juce::File::getCurrentWorkingDirectory().getChildFile(value));
+        else if (arg == "--sample-rates")
+        {
+            juce::StringArray rates;
+            rates.addTokens(value, ",", "");
+            
+            options->_sampleRates.clear();
+            for (int j = 0; j < rates.size(); j++)
+            {
+                double sampleRate = rates[j].getDoubleValue();
+                if (sampleRate > 0.0)
+                    options->_sampleRates.push_back(sampleRate);
+            }
+        }
+        else if (arg == "--duration")
+            options->_duration = juce::jlimit(1.0, MAX_DURATION, value.getDoubleValue());
+        else if (arg == "--runs")
+            options->_numRuns = juce::jlimit(1, MAX_NUM_RUNS, value.getIntValue());
+        else if (arg == "--output")
+            options->_outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+        else if (arg == "--baseline")
+            options->_baselineFile = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+        else if (arg == "--tolerance")
+            options->_tolerance = juce::jmax(0.0, value.getDoubleValue());
+        else
+        {
+            fprintf(stderr, "Error: unknown option %s\n", arg.toRawUTF8());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Run the benchmark on the signal, one warm-up run then the timed runs
+static void
+runBenchmark(Benchmark *benchmark, const juce::String &signalName,
+             const vector<float> &signal, double sampleRate, int numRuns,
+             BenchResult *result)
+{
+    double ticksPerSecond = (double)juce::Time::getHighResolutionTicksPerSecond();
+    
+    vector<double> realtimeFactors;
+    vector<double> stepTimes;
+    vector<juce::int64> runTicks;
+    
+    for (int run = 0; run <= numRuns; run++)
+    {
+        benchmark->prepare(signal, sampleRate);
+
+        int numSteps = benchmark->getNumSteps();
+        runTicks.resize(numSteps);
+
+        // Only the steps are timed
+        for (int i = 0; i < numSteps; i++)
+        {
+            juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+            benchmark->processStep(i);
+            runTicks[i] = juce::Time::getHighResolutionTicks() - startTicks;
+        }
+        
+        benchmark->release();
+
+        // Warm-up
+        if (run == 0)
+            continue;
+
+        juce::int64 totalTicks = 0;
+        for (int i = 0; i < numSteps; i++)
+        {
+            totalTicks += runTicks[i];
+            stepTimes.push_back(runTicks[i]*1e6/ticksPerSecond);
+        }
+
+        double audioSeconds = ((double)numSteps*benchmark->getStepSize())/sampleRate;
+        double processSeconds = totalTicks/ticksPerSecond;
+        if (processSeconds > 0.0)
+            realtimeFactors.push_back(audioSeconds/processSeconds);
+    }
+
+    std::sort(realtimeFactors.begin(), realtimeFactors.end());
+    std::sort(stepTimes.begin(), stepTimes.end());
+
+    result->_benchmark = benchmark->getName();
+    result->_signal = signalName;
+    result->_sampleRate = sampleRate;
+    result->_fftSize = benchmark->getFftSize();
+    result->_stepSize = benchmark->getStepSize();
+    result->_realtimeFactor = BenchResults::getPercentile(realtimeFactors, 0.5);
+    result->_stepTimeP50 = BenchResults::getPercentile(stepTimes, 0.5);
+    result->_stepTimeP90 = BenchResults::getPercentile(stepTimes, 0.9);
+    result->_stepTimeP99 = BenchResults::getPercentile(stepTimes, 0.99);
+    result->_stepTimeMax = stepTimes.empty() ? 0.0 : stepTimes.back();
+}
+
+static juce::var
+getInfo(const BenchOptions &options)
+{
+    juce::DynamicObject::Ptr info = new juce::DynamicObject();
+    info->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+    info->setProperty("cpu", juce::SystemStats::getCpuModel());
+    info->setProperty("numCpus", juce::SystemStats::getNumCpus());
+    info->setProperty("os", juce::SystemStats::getOperatingSystemName());
+#if JUCE_DEBUG
+    info->setProperty("build", "debug");
+#else
+    info->setProperty("build", "release");
+#endif
+    info->setProperty("duration", options._duration);
+    info->setProperty("numRuns", options._numRuns);
+
+    return juce::var(info.get());
+}
+
+int
+main(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (!parseArguments(argc, argv, &options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (options._fft)
+    {
+        FftEngine::benchmarkAll(stdout);
+        return 0;
+    }
+    
+    vector<std::unique_ptr<Benchmark> > benchmarks;
+    {
+        vector<Benchmark *> allBenchmarks;
+        Benchmark::createAll(&allBenchmarks);
+        
+        for (int i = 0; i < allBenchmarks.size(); i++)
+        {
+            if (allBenchmarks[i]->getName().contains(options._filter))
+                benchmarks.push_back(std::unique_ptr<Benchmark>(allBenchmarks[i]));
+            else
+                delete allBenchmarks[i];
+        }
+    }
+    
+    if (options._list)
+    {
+        for (int i = 0; i < benchmarks.size(); i++)
+            printf("%s\n", benchmarks[i]->getName().toRawUTF8());
+
+        juce::StringArray signals;
+        BenchSignals::getSyntheticNames(&signals);
+        printf("\nSignals: %s\n", signals.joinIntoString(", ").toRawUTF8());
+        
+        return 0;
+    }
+
+    vector<BenchResult> baseline;
+    if (options._baselineFile != juce::File())
+    {
+        juce::String error;
+        if (!BenchResults::load(options._baselineFile, &baseline, &error))
+        {
+            fprintf(stderr, "Error: %s\n", error.toRawUTF8());
+            return 1;
+        }
+    }
+    
+    printf("%-28s %-12s %7s %5s %10s %9s %9s %9s %9s\n",
+           "benchmark", "signal", "rate", "fft", "rtf",
+           "p50 us", "p90 us", "p99 us", "max us");
+    
+    vector<BenchResult> results;
+    for (int r = 0; r < options._sampleRates.size(); r++)
+    {
+        double sampleRate = options._sampleRates[r];
+        int numSamples = (int)(options._duration*sampleRate);
+        
+        int numSignals = options._signals.size() + options._inputFiles.size();
+        for (int s = 0; s < numSignals; s++)
+        {
+            juce::String signalName;
+            vector<float> signal;
+            
+            if (s < options._signals.size())
+            {
+                signalName = options._signals[s];
+                BenchSignals::generate(signalName, sampleRate, numSamples, &signal);
+            }
+            else
+            {
+                juce::File file = options._inputFiles[s - options._signals.size()];
+                signalName = file.getFileNameWithoutExtension();
+
+                juce::String error;
+                if (!BenchSignals::loadRecorded(file, sampleRate, numSamples, &signal, &error))
+                {
+                    fprintf(stderr, "Error: %s: %s\n",
+                            file.getFullPathName().toRawUTF8(), error.toRawUTF8());
+                    return 1;
+                }
+            }
+
+            for (int b = 0; b < benchmarks.size(); b++)
+            {
+                BenchResult result;
+                runBenchmark(benchmarks[b].get(), signalName, signal, sampleRate,
+                             options._numRuns, &result);
+                
+                printf("%-28s %-12s %7d %5d %10.1f %9.1f %9.1f %9.1f %9.1f\n",
+                       result._benchmark.toRawUTF8(), result._signal.toRawUTF8(),
+                       (int)result._sampleRate, result._fftSize, result._realtimeFactor,
+                       result._stepTimeP50, result._stepTimeP90,
+                       result._stepTimeP99, result._stepTimeMax);
+                fflush(stdout);
+                
+                results.push_back(result);
+            }
+        }
+    }
+
+    if (options._outputFile != juce::File())
+    {
+        juce::String error;
+        if (!BenchResults::save(results, getInfo(options), options._outputFile, &error))
+        {
+            fprintf(stderr, "Error: %s\n", error.toRawUTF8());
+            return 1;
+        }
+    }
+
+    if (options._baselineFile != juce::File())
+    {
+        int numRegressions = BenchResults::compare(results, baseline,
+                                                   options._tolerance*0.01);
+        if (numRegressions > 0)
+        {
+            printf("\n%d regression(s)\n", numRegressions);
+            return 1;
+        }
+    }
+    
+    return 0;
+}
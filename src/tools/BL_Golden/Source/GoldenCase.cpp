@@ -0,0 +1,494 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <OverlapAdd.h>
+#include <DenoiserProcessor.h>
+#include <AirProcessor.h>
+#include <PartialTracker.h>
+#include <WienerSoftMasking.h>
+#include <Utils.h>
+
+#include "GoldenCase.h"
+
+// Same values as in the plugins
+#define FFT_SIZE_COEFF 23
+
+#define DENOISER_OVERLAP_0 4
+#define DENOISER_OVERLAP_1 8
+
+#define DENOISER_THRESHOLD 0.5
+
+#define AIR_OVERLAP 4
+#define AIR_THRESHOLD -100.0
+
+#define SOFT_MASKING_HISTO_SIZE 8
+
+// The sqrt-Hann pair is COLA at overlap 2, and the Hann pair at overlap 4
+#define RECONSTRUCTION_OVERLAP_0 2
+#define RECONSTRUCTION_OVERLAP_1 4
+
+// For the COLA pairs, relative to the peak of the input
+// (the fft rounding errors only)
+#define MAX_RECONSTRUCTION_ERROR 1e-4
+
+// Recursive variances, relative to the peak of the SIGMA2_HANN output
+#define MAX_SIGMA2_RECURSIVE_ERROR 1e-5
+
+// N sources soft masking, relative to the peak of the input
+#define MAX_SOURCES_ERROR 1e-5
+
+// The denoiser learns the noise profile on the beginning of the input
+#define DENOISER_LEARN_SECONDS 1.0
+
+// Copy the frames of the analysis
+class FrameCollector : public OverlapAddProcessor
+{
+public:
+    FrameCollector(vector<vector<complex<float> > > *frames)
+    : _frames(frames) {}
+    
+    void processFFT(vector<complex<float> > *compBuf) override
+    {
+        _frames->push_back(*compBuf);
+    }
+    
+protected:
+    vector<vector<complex<float> > > *_frames;
+};
+
+// GoldenCase
+GoldenCase::GoldenCase(const juce::String &name)
+: _name(name) {}
+
+GoldenCase::~GoldenCase() {}
+
+const juce::String &
+GoldenCase::getName() const
+{
+    return _name;
+}
+
+int
+GoldenCase::getFrameSize(double sampleRate) const
+{
+    return 0;
+}
+
+void
+GoldenCase::createAll(vector<GoldenCase *> *cases)
+{
+    cases->push_back(new DenoiserCase("DenoiserProcessor", DENOISER_OVERLAP_0, 0.0, false));
+    cases->push_back(new DenoiserCase("DenoiserProcessor/ov8", DENOISER_OVERLAP_1, 0.0, false));
+    cases->push_back(new DenoiserCase("DenoiserProcessor/residual", DENOISER_OVERLAP_0, 0.5, false));
+    cases->push_back(new DenoiserCase("DenoiserProcessor/soft", DENOISER_OVERLAP_0, 0.0, true));
+    
+    cases->push_back(new ReconstructionCase("OverlapAdd/sqrt-hann-ov2", RECONSTRUCTION_OVERLAP_0,
+                                            Window::SQRT_HANN, Window::SQRT_HANN,
+                                            WindowCache::NORMALIZE_COLA));
+    cases->push_back(new ReconstructionCase("OverlapAdd/hann-cola-ov4", RECONSTRUCTION_OVERLAP_1,
+                                            Window::HANN, Window::HANN,
+                                            WindowCache::NORMALIZE_COLA));
+    
+    cases->push_back(new AirCase("AirProcessor", false));
+    cases->push_back(new AirCase("AirProcessor/soft", true));
+    
+    cases->push_back(new PartialTrackerCase());
+    cases->push_back(new WienerSoftMaskingCase("WienerSoftMasking",
+                                               WienerSoftMasking::SIGMA2_HANN));
+    cases->push_back(new WienerSoftMaskingCase("WienerSoftMasking/recursive",
+                                               WienerSoftMasking::SIGMA2_HANN_RECURSIVE));
+    cases->push_back(new WienerSoftMaskingSourcesCase("WienerSoftMasking/2-sources", 2));
+    cases->push_back(new WienerSoftMaskingSourcesCase("WienerSoftMasking/3-sources", 3));
+}
+
+bool
+GoldenCase::checkProperties(const vector<float> &input, double sampleRate,
+                            const vector<float> &output, juce::String *message)
+{
+    return true;
+}
+
+int
+GoldenCase::computeFftSize(double sampleRate)
+{
+    return Utils::nearestPowerOfTwo(sampleRate/FFT_SIZE_COEFF);
+}
+
+void
+GoldenCase::renderOverlapAdd(OverlapAddProcessor *processor, int fftSize, int overlap,
+                             const vector<float> &input, vector<float> *output)
+{
+    OverlapAdd overlapAdd(fftSize, overlap, true, true);
+    overlapAdd.addProcessor(processor);
+    
+    output->resize(input.size());
+    overlapAdd.process(input.data(), output->data(), input.size());
+}
+
+void
+GoldenCase::computeFrames(const vector<float> &input, int fftSize, int overlap,
+                          vector<vector<complex<float> > > *frames)
+{
+    frames->clear();
+    
+    OverlapAdd overlapAdd(fftSize, overlap, true, false);
+    FrameCollector collector(frames);
+    overlapAdd.addProcessor(&collector);
+    overlapAdd.feed(input);
+}
+
+// ReconstructionCase
+ReconstructionCase::ReconstructionCase(const juce::String &name, int overlap,
+                                       Window::Type anaWindow, Window::Type synthWindow,
+                                       WindowCache::Normalization normalization)
+: GoldenCase(name), _overlap(overlap), _anaWindow(anaWindow),
+  _synthWindow(synthWindow), _normalization(normalization) {}
+
+void
+ReconstructionCase::render(const vector<float> &input, double sampleRate,
+                           vector<float> *output)
+{
+    int fftSize = computeFftSize(sampleRate);
+    
+    OverlapAdd overlapAdd(fftSize, _overlap, true, true);
+    overlapAdd.setWindows(_anaWindow, _synthWindow, _normalization);
+
+    _reconstructionError = overlapAdd.getReconstructionError();
+    _latency = overlapAdd.getLatency();
+
+    // By blocks of one hop, so that the output is exactly delayed by the latency
+    // (the last incomplete hop stays silent)
+    int hopSize = fftSize/_overlap;
+    output->assign(input.size(), 0.0);
+    for (int i = 0; i + hopSize <= input.size(); i += hopSize)
+        overlapAdd.process(&input.data()[i], &output->data()[i], hopSize);
+}
+
+bool
+ReconstructionCase::checkProperties(const vector<float> &input, double sampleRate,
+                                    const vector<float> &output, juce::String *message)
+{
+    if (_reconstructionError > MAX_RECONSTRUCTION_ERROR)
+    {
+        *message = "reconstruction error " + juce::String(_reconstructionError);
+        return false;
+    }
+
+    // Skip the first frame, which is not fully overlapped, and the last hop
+    int fftSize = computeFftSize(sampleRate);
+    int hopSize = fftSize/_overlap;
+    int start = _latency + fftSize;
+    int end = ((int)output.size()/hopSize)*hopSize;
+    
+    float maxInput = 0.0;
+    float maxError = 0.0;
+    for (int i = start; i < end; i++)
+    {
+        maxInput = juce::jmax(maxInput, fabsf(input[i - _latency]));
+        maxError = juce::jmax(maxError, fabsf(output[i] - input[i - _latency]));
+    }
+
+    if (maxError > MAX_RECONSTRUCTION_ERROR*maxInput)
+    {
+        *message = "output differs from the delayed input by " + juce::String(maxError);
+        return false;
+    }
+    
+    return true;
+}
+
+// DenoiserCase
+DenoiserCase::DenoiserCase(const juce::String &name, int overlap,
+                           float residualNoise, bool softDenoise)
+: GoldenCase(name), _overlap(overlap), _residualNoise(residualNoise),
+  _softDenoise(softDenoise) {}
+
+void
+DenoiserCase::render(const vector<float> &input, double sampleRate,
+                     vector<float> *output)
+{
+    int fftSize = computeFftSize(sampleRate);
+    
+    DenoiserProcessor processor(fftSize, _overlap, DENOISER_THRESHOLD);
+    processor.reset(fftSize, _overlap, sampleRate);
+    processor.setThreshold(DENOISER_THRESHOLD);
+    processor.setResNoiseThrs(_residualNoise);
+    processor.setAutoResNoise(_softDenoise);
+
+    // Learn the noise profile, like in the plugin
+    int numLearnSamples = juce::jmin((int)(DENOISER_LEARN_SECONDS*sampleRate),
+                                     (int)input.size());
+    vector<float> learnInput(input.begin(), input.begin() + numLearnSamples);
+    vector<float> learnOutput;
+    processor.setBuildingNoiseStatistics(true);
+    renderOverlapAdd(&processor, fftSize, _overlap, learnInput, &learnOutput);
+    processor.setBuildingNoiseStatistics(false);
+
+    renderOverlapAdd(&processor, fftSize, _overlap, input, output);
+}
+
+// AirCase
+AirCase::AirCase(const juce::String &name, bool softMasks)
+: GoldenCase(name), _softMasks(softMasks) {}
+
+void
+AirCase::render(const vector<float> &input, double sampleRate,
+                vector<float> *output)
+{
+    int fftSize = computeFftSize(sampleRate);
+
+    AirProcessor processor(fftSize, AIR_OVERLAP, sampleRate);
+    processor.setThreshold(AIR_THRESHOLD);
+    processor.setUseSoftMasks(_softMasks);
+
+    renderOverlapAdd(&processor, fftSize, AIR_OVERLAP, input, output);
+}
+
+// PartialTrackerCase
+PartialTrackerCase::PartialTrackerCase()
+: GoldenCase("PartialTracker") {}
+
+void
+PartialTrackerCase::render(const vector<float> &input, double sampleRate,
+                           vector<float> *output)
+{
+    int fftSize = computeFftSize(sampleRate);
+    
+    vector<vector<complex<float> > > frames;
+    computeFrames(input, fftSize, AIR_OVERLAP, &frames);
+
+    PartialTracker partialTracker(fftSize, sampleRate);
+    partialTracker.setThreshold(AIR_THRESHOLD);
+
+    output->clear();
+    
+    vector<float> magns;
+    vector<float> phases;
+    vector<float> noiseEnvelope;
+    for (int i = 0; i < frames.size(); i++)
+    {
+        // Same calls as AirProcessor
+        Utils::complexToMagnPhase(&magns, &phases, frames[i]);
+        
+        partialTracker.setData(magns, phases);
+        partialTracker.detectPartials();
+        partialTracker.filterPartials();
+        partialTracker.extractNoiseEnvelope();
+
+        partialTracker.getNoiseEnvelope(&noiseEnvelope);
+        partialTracker.denormData(&noiseEnvelope);
+
+        output->insert(output->end(), noiseEnvelope.begin(), noiseEnvelope.end());
+    }
+}
+
+int
+PartialTrackerCase::getFrameSize(double sampleRate) const
+{
+    return computeFftSize(sampleRate)/2 + 1;
+}
+
+// WienerSoftMaskingCase
+WienerSoftMaskingCase::WienerSoftMaskingCase(const juce::String &name,
+                                             WienerSoftMasking::Sigma2Mode sigma2Mode)
+: GoldenCase(name), _sigma2Mode(sigma2Mode) {}
+
+void
+WienerSoftMaskingCase::render(const vector<float> &input, double sampleRate,
+                              vector<float> *output)
+{
+    renderSoftMasking(input, sampleRate, _sigma2Mode, output);
+}
+
+bool
+WienerSoftMaskingCase::checkProperties(const vector<float> &input, double sampleRate,
+                                       const vector<float> &output, juce::String *message)
+{
+    if (_sigma2Mode == WienerSoftMasking::SIGMA2_HANN)
+        return true;
+
+    vector<float> hannOutput;
+    renderSoftMasking(input, sampleRate, WienerSoftMasking::SIGMA2_HANN, &hannOutput);
+    if (hannOutput.size() != output.size())
+    {
+        *message = "length differs from SIGMA2_HANN";
+        return false;
+    }
+
+    float maxHann = 0.0;
+    float maxError = 0.0;
+    for (int i = 0; i < output.size(); i++)
+    {
+        maxHann = juce::jmax(maxHann, fabsf(hannOutput[i]));
+        maxError = juce::jmax(maxError, fabsf(output[i] - hannOutput[i]));
+    }
+
+    if (maxError > MAX_SIGMA2_RECURSIVE_ERROR*maxHann)
+    {
+        *message = "differs from SIGMA2_HANN by " + juce::String(maxError);
+        return false;
+    }
+    
+    return true;
+}
+
+void
+WienerSoftMaskingCase::renderSoftMasking(const vector<float> &input, double sampleRate,
+                                         WienerSoftMasking::Sigma2Mode sigma2Mode,
+                                         vector<float> *output)
+{
+    int fftSize = computeFftSize(sampleRate);
+    
+    vector<vector<complex<float> > > frames;
+    computeFrames(input, fftSize, AIR_OVERLAP, &frames);
+
+    WienerSoftMasking softMasking(fftSize, AIR_OVERLAP, SOFT_MASKING_HISTO_SIZE);
+    softMasking.setSigma2Mode(sigma2Mode);
+
+    output->clear();
+    
+    vector<float> magns;
+    vector<float> phases;
+    vector<float> mask(fftSize/2 + 1);
+    vector<complex<float> > masked0(fftSize/2 + 1);
+    vector<complex<float> > masked1(fftSize/2 + 1);
+    for (int i = 0; i < frames.size(); i++)
+    {
+        Utils::complexToMagnPhase(&magns, &phases, frames[i]);
+        
+        // Rough harmonic mask: the bins above the mean of the frame
+        float mean = Utils::computeSum(magns)/magns.size();
+        for (int j = 0; j < mask.size(); j++)
+            mask.data()[j] = (magns.data()[j] > mean) ? 1.0 : 0.0;
+
+        softMasking.processCentered(&frames[i], mask, &masked0, &masked1);
+
+        Utils::complexToMagnPhase(&magns, &phases, masked0);
+        output->insert(output->end(), magns.begin(), magns.end());
+    }
+}
+
+int
+WienerSoftMaskingCase::getFrameSize(double sampleRate) const
+{
+    return computeFftSize(sampleRate)/2 + 1;
+}
+
+// WienerSoftMaskingSourcesCase
+WienerSoftMaskingSourcesCase::WienerSoftMaskingSourcesCase(const juce::String &name,
+                                                           int numSources)
+: GoldenCase(name), _numSources(numSources) {}
+
+void
+WienerSoftMaskingSourcesCase::render(const vector<float> &input, double sampleRate,
+                                     vector<float> *output)
+{
+    int fftSize = computeFftSize(sampleRate);
+    int numBins = fftSize/2 + 1;
+    
+    vector<vector<complex<float> > > frames;
+    computeFrames(input, fftSize, AIR_OVERLAP, &frames);
+
+    WienerSoftMasking softMasking(fftSize, AIR_OVERLAP, SOFT_MASKING_HISTO_SIZE);
+
+    // Reference, for 2 sources
+    WienerSoftMasking softMasking2(fftSize, AIR_OVERLAP, SOFT_MASKING_HISTO_SIZE);
+
+    output->clear();
+    _maxError = 0.0;
+    _maxInput = 0.0;
+    
+    vector<float> magns;
+    vector<float> phases;
+    vector<vector<float> > masks(_numSources, vector<float>(numBins));
+    vector<vector<complex<float> > > maskedResults;
+    vector<complex<float> > sum2;
+    vector<complex<float> > masked0(numBins);
+    vector<complex<float> > masked1(numBins);
+    for (int i = 0; i < frames.size(); i++)
+    {
+        Utils::complexToMagnPhase(&magns, &phases, frames[i]);
+        
+        // Rough hard masks, that sum to 1: the bins above the mean of the frame,
+        // then (with 3 sources) the bins above a tenth of the mean, then the others
+        float mean = Utils::computeSum(magns)/magns.size();
+        for (int j = 0; j < numBins; j++)
+        {
+            int source = (magns.data()[j] > mean) ? 0 : _numSources - 1;
+            if ((_numSources > 2) && (source > 0) && (magns.data()[j] > 0.1*mean))
+                source = 1;
+            
+            for (int k = 0; k < _numSources; k++)
+                masks[k].data()[j] = (k == source) ? 1.0 : 0.0;
+        }
+
+        sum2 = frames[i];
+        softMasking.processCentered(&frames[i], masks, &maskedResults);
+
+        for (int j = 0; j < numBins; j++)
+        {
+            complex<float> maskedSum = 0.0;
+            for (int k = 0; k < _numSources; k++)
+                maskedSum += maskedResults[k].data()[j];
+            
+            _maxInput = juce::jmax(_maxInput, std::abs(frames[i].data()[j]));
+            if (_numSources != 2)
+                _maxError = juce::jmax(_maxError, std::abs(maskedSum - frames[i].data()[j]));
+        }
+
+        if (_numSources == 2)
+        {
+            softMasking2.processCentered(&sum2, masks[0], &masked0, &masked1);
+            
+            for (int j = 0; j < numBins; j++)
+            {
+                _maxError = juce::jmax(_maxError, std::abs(maskedResults[0].data()[j] -
+                                                           masked0.data()[j]));
+                _maxError = juce::jmax(_maxError, std::abs(maskedResults[1].data()[j] -
+                                                           masked1.data()[j]));
+            }
+        }
+        
+        Utils::complexToMagnPhase(&magns, &phases, maskedResults[0]);
+        output->insert(output->end(), magns.begin(), magns.end());
+    }
+}
+
+int
+WienerSoftMaskingSourcesCase::getFrameSize(double sampleRate) const
+{
+    return computeFftSize(sampleRate)/2 + 1;
+}
+
+bool
+WienerSoftMaskingSourcesCase::checkProperties(const vector<float> &input, double sampleRate,
+                                              const vector<float> &output,
+                                              juce::String *message)
+{
+    if (_maxError > MAX_SOURCES_ERROR*_maxInput)
+    {
+        if (_numSources == 2)
+            *message = "differs from the 2 sources overload by " + juce::String(_maxError);
+        else
+            *message = "masked outputs differ from the input by " + juce::String(_maxError);
+        
+        return false;
+    }
+    
+    return true;
+}
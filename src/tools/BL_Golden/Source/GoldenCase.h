@@ -0,0 +1,185 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#pragma once
+
+#include <vector>
+#include <complex>
+using namespace std;
+
+#include <JuceHeader.h>
+
+#include <WindowCache.h>
+#include <WienerSoftMasking.h>
+
+class OverlapAddProcessor;
+
+// One processor of bluelab-lib, with fixed parameters, whose output is
+// compared to a reference output
+class GoldenCase
+{
+public:
+    GoldenCase(const juce::String &name);
+    virtual ~GoldenCase();
+
+    const juce::String &getName() const;
+
+    // Render the mono input
+    // The output is either audio, or the concatenated spectral frames
+    virtual void render(const vector<float> &input, double sampleRate,
+                        vector<float> *output) = 0;
+
+    // 0 if the output is audio, otherwise the size of the frames
+    virtual int getFrameSize(double sampleRate) const;
+
+    // Properties that the output must have, whatever the references
+    // (checked after render(), also when generating)
+    // Return false and set the message if a property is not satisfied
+    virtual bool checkProperties(const vector<float> &input, double sampleRate,
+                                 const vector<float> &output, juce::String *message);
+    
+    static void createAll(vector<GoldenCase *> *cases);
+
+protected:
+    static int computeFftSize(double sampleRate);
+    
+    // Time domain processing, with the overlap-add
+    static void renderOverlapAdd(OverlapAddProcessor *processor, int fftSize, int overlap,
+                                 const vector<float> &input, vector<float> *output);
+
+    // Analysis only
+    static void computeFrames(const vector<float> &input, int fftSize, int overlap,
+                              vector<vector<complex<float> > > *frames);
+    
+    juce::String _name;
+};
+
+// Overlap-add without processor, with other windows than Hann/Hann
+// The output must be the delayed input, within the reconstruction error
+// reported by the overlap-add
+class ReconstructionCase : public GoldenCase
+{
+public:
+    ReconstructionCase(const juce::String &name, int overlap,
+                       Window::Type anaWindow, Window::Type synthWindow,
+                       WindowCache::Normalization normalization);
+
+    void render(const vector<float> &input, double sampleRate,
+                vector<float> *output) override;
+
+    bool checkProperties(const vector<float> &input, double sampleRate,
+                         const vector<float> &output, juce::String *message) override;
+    
+protected:
+    int _overlap;
+    Window::Type _anaWindow;
+    Window::Type _synthWindow;
+    WindowCache::Normalization _normalization;
+
+    // Of the last render
+    float _reconstructionError = 0.0;
+    int _latency = 0;
+};
+
+class DenoiserCase : public GoldenCase
+{
+public:
+    // residualNoise: 0 to 1
+    DenoiserCase(const juce::String &name, int overlap,
+                 float residualNoise, bool softDenoise);
+
+    void render(const vector<float> &input, double sampleRate,
+                vector<float> *output) override;
+
+protected:
+    int _overlap;
+    float _residualNoise;
+    bool _softDenoise;
+};
+
+class AirCase : public GoldenCase
+{
+public:
+    AirCase(const juce::String &name, bool softMasks);
+
+    void render(const vector<float> &input, double sampleRate,
+                vector<float> *output) override;
+
+protected:
+    bool _softMasks;
+};
+
+// Noise envelopes, for each frame
+class PartialTrackerCase : public GoldenCase
+{
+public:
+    PartialTrackerCase();
+
+    void render(const vector<float> &input, double sampleRate,
+                vector<float> *output) override;
+
+    int getFrameSize(double sampleRate) const override;
+};
+
+// Magnitudes of the masked frames
+// The recursive variances must give the same output as SIGMA2_HANN
+class WienerSoftMaskingCase : public GoldenCase
+{
+public:
+    WienerSoftMaskingCase(const juce::String &name,
+                          WienerSoftMasking::Sigma2Mode sigma2Mode);
+
+    void render(const vector<float> &input, double sampleRate,
+                vector<float> *output) override;
+
+    int getFrameSize(double sampleRate) const override;
+
+    bool checkProperties(const vector<float> &input, double sampleRate,
+                         const vector<float> &output, juce::String *message) override;
+
+protected:
+    static void renderSoftMasking(const vector<float> &input, double sampleRate,
+                                  WienerSoftMasking::Sigma2Mode sigma2Mode,
+                                  vector<float> *output);
+    
+    WienerSoftMasking::Sigma2Mode _sigma2Mode;
+};
+
+// Magnitudes of the first source, with the N sources engine
+// 2 sources: the output must be the same as with the 2 sources overload
+// 3 sources: the masked outputs must sum to the delayed input
+class WienerSoftMaskingSourcesCase : public GoldenCase
+{
+public:
+    WienerSoftMaskingSourcesCase(const juce::String &name, int numSources);
+
+    void render(const vector<float> &input, double sampleRate,
+                vector<float> *output) override;
+
+    int getFrameSize(double sampleRate) const override;
+
+    bool checkProperties(const vector<float> &input, double sampleRate,
+                         const vector<float> &output, juce::String *message) override;
+
+protected:
+    int _numSources;
+
+    // Of the last render
+    float _maxError = 0.0;
+    float _maxInput = 0.0;
+};
@@ -0,0 +1,132 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <math.h>
+
+#include <FftEngine.h>
+#include <Window.h>
+
+#include "GoldenMetrics.h"
+
+// When the output is exactly the reference
+#define MAX_SNR 300.0
+
+// Spectrum frames of the audio outputs
+#define SPECTRUM_FFT_SIZE 2048
+#define SPECTRUM_OVERLAP 4
+
+// Floor of the magnitudes, for the log-spectral distance
+#define MIN_DB -120.0
+
+void
+GoldenMetrics::compute(const vector<float> &output, const vector<float> &reference,
+                       int frameSize, GoldenMetrics *metrics)
+{
+    double maxAbs = 0.0;
+    double refEnergy = 0.0;
+    double errEnergy = 0.0;
+    for (int i = 0; i < reference.size(); i++)
+    {
+        double err = output[i] - reference[i];
+        
+        maxAbs = fmax(maxAbs, fabs(err));
+        refEnergy += reference[i]*reference[i];
+        errEnergy += err*err;
+    }
+
+    metrics->_maxAbs = maxAbs;
+
+    if (errEnergy > 0.0)
+        metrics->_snr = fmin(10.0*log10((refEnergy + 1e-30)/errEnergy), MAX_SNR);
+    else
+        metrics->_snr = MAX_SNR;
+
+    // Magnitude frames
+    vector<vector<float> > outFrames;
+    vector<vector<float> > refFrames;
+    if (frameSize == 0)
+    {
+        computeSpectrumFrames(output, &outFrames);
+        computeSpectrumFrames(reference, &refFrames);
+    }
+    else
+    {
+        int numFrames = reference.size()/frameSize;
+        outFrames.resize(numFrames);
+        refFrames.resize(numFrames);
+        for (int i = 0; i < numFrames; i++)
+        {
+            outFrames[i].assign(output.begin() + i*frameSize,
+                                output.begin() + (i + 1)*frameSize);
+            refFrames[i].assign(reference.begin() + i*frameSize,
+                                reference.begin() + (i + 1)*frameSize);
+        }
+    }
+
+    // Log-spectral distance
+    double distanceSum = 0.0;
+    for (int i = 0; i < refFrames.size(); i++)
+    {
+        const vector<float> &outFrame = outFrames[i];
+        const vector<float> &refFrame = refFrames[i];
+
+        double sum = 0.0;
+        for (int j = 0; j < refFrame.size(); j++)
+        {
+            double outDB = fmax(20.0*log10(fabs(outFrame[j]) + 1e-30), MIN_DB);
+            double refDB = fmax(20.0*log10(fabs(refFrame[j]) + 1e-30), MIN_DB);
+            
+            sum += (outDB - refDB)*(outDB - refDB);
+        }
+
+        if (!refFrame.empty())
+            distanceSum += sqrt(sum/refFrame.size());
+    }
+
+    metrics->_spectralDistance = refFrames.empty() ? 0.0 : distanceSum/refFrames.size();
+}
+
+void
+GoldenMetrics::computeSpectrumFrames(const vector<float> &samples,
+                                     vector<vector<float> > *frames)
+{
+    frames->clear();
+    
+    vector<float> window(SPECTRUM_FFT_SIZE);
+    Window::makeWindowHann(&window, true);
+
+    std::unique_ptr<FftEngine> fft = FftEngine::create(FftEngine::AUTO, SPECTRUM_FFT_SIZE);
+    
+    vector<float> frame(SPECTRUM_FFT_SIZE);
+    vector<complex<float> > spectrum(SPECTRUM_FFT_SIZE/2 + 1);
+    
+    int hopSize = SPECTRUM_FFT_SIZE/SPECTRUM_OVERLAP;
+    for (int pos = 0; pos + SPECTRUM_FFT_SIZE <= samples.size(); pos += hopSize)
+    {
+        for (int i = 0; i < SPECTRUM_FFT_SIZE; i++)
+            frame[i] = samples[pos + i]*window[i];
+
+        fft->forward(frame.data(), spectrum.data());
+
+        vector<float> magns(spectrum.size());
+        for (int i = 0; i < spectrum.size(); i++)
+            magns[i] = std::abs(spectrum[i]);
+        
+        frames->push_back(magns);
+    }
+}
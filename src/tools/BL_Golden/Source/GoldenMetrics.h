@@ -0,0 +1,44 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+// Differences between an output and its reference
+struct GoldenMetrics
+{
+    float _maxAbs = 0.0;
+
+    // Signal to error ratio, in dB
+    float _snr = 0.0;
+
+    // Log-spectral distance, in dB (mean over the frames)
+    float _spectralDistance = 0.0;
+
+    // frameSize: 0 if the data is audio (then the spectrum frames are computed),
+    // otherwise the size of the magnitude frames of the data
+    // The sizes of output and reference must be the same
+    static void compute(const vector<float> &output, const vector<float> &reference,
+                        int frameSize, GoldenMetrics *metrics);
+
+protected:
+    static void computeSpectrumFrames(const vector<float> &samples,
+                                      vector<vector<float> > *frames);
+};
@@ -0,0 +1,366 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <stdio.h>
+
+#include <vector>
+using namespace std;
+
+#include <JuceHeader.h>
+
+#include <FftEngine.h>
+
+#include "../../BL_Bench/Source/BenchSignals.h"
+
+#include "GoldenCase.h"
+#include "GoldenMetrics.h"
+
+// Synthetic inputs, created by generate if there is no input file
+#define SYNTHETIC_SAMPLE_RATE 44100.0
+#define SYNTHETIC_DURATION 4.0
+
+#define INPUT_WILDCARD "*.wav;*.flac;*.aif;*.aiff"
+
+#define DEFAULT_MAX_ABS 1e-3
+#define DEFAULT_MIN_SNR 60.0
+#define DEFAULT_MAX_SPECTRAL_DISTANCE 0.5
+
+struct GoldenOptions
+{
+    bool _generate = false;
+    juce::File _dir;
+
+    // Only the cases whose name contains it
+    juce::String _filter;
+    
+    FftEngine::Backend _fftBackend = FftEngine::AUTO;
+    
+    float _maxAbs = DEFAULT_MAX_ABS;
+    float _minSnr = DEFAULT_MIN_SNR;
+    float _maxSpectralDistance = DEFAULT_MAX_SPECTRAL_DISTANCE;
+};
+
+static void
+printUsage()
+{
+    printf("Usage: BL_Golden <generate|check> <dir> [options]\n"
+           "\n"
+           "Render the input files of <dir>/inputs through the processors of bluelab-lib.\n"
+           "generate writes the reference outputs in <dir>/references (and creates\n"
+           "synthetic inputs if there is none), check compares the outputs with them.\n"
+           "Generate the references before a change, with the same build settings.\n"
+           "Some cases also check properties of their output, such as the perfect\n"
+           "reconstruction of the overlap-add.\n"
+           "\n"
+           "Options:\n"
+           "  --filter <text>                Only the cases whose name contains text\n"
+           "  --fft <auto|juce|fftw>         FFT backend (default: auto)\n"
+           "  --max-abs <value>              Default: %g\n"
+           "  --min-snr <dB>                 Default: %g\n"
+           "  --max-spectral-distance <dB>   Log-spectral distance (default: %g)\n",
+           DEFAULT_MAX_ABS, DEFAULT_MIN_SNR, DEFAULT_MAX_SPECTRAL_DISTANCE);
+}
+
+static bool
+parseArguments(int argc, char *argv[], GoldenOptions *options)
+{
+    if (argc < 3)
+        return false;
+
+    juce::String mode(argv[1]);
+    if (mode == "generate")
+        options->_generate = true;
+    else if (mode != "check")
+        return false;
+
+    options->_dir = juce::File::getCurrentWorkingDirectory().getChildFile(argv[2]);
+    
+    for (int i = 3; i < argc; i++)
+    {
+        juce::String arg(argv[i]);
+
+        if (!arg.startsWith("--") || (i == argc - 1))
+        {
+            fprintf(stderr, "Error: unexpected argument %s\n", arg.toRawUTF8());
+            return false;
+        }
+        
+        juce::String value(argv[++i]);
+
+        if (arg == "--filter")
+            options->_filter = value;
+        else if (arg == "--fft")
+        {
+            if (value == "juce")
+                options->_fftBackend = FftEngine::JUCE;
+            else if (value == "fftw")
+                options->_fftBackend = FftEngine::FFTW;
+            else
+                options->_fftBackend = FftEngine::AUTO;
+        }
+        else if (arg == "--max-abs")
+            options->_maxAbs = value.getFloatValue();
+        else if (arg == "--min-snr")
+            options->_minSnr = value.getFloatValue();
+        else if (arg == "--max-spectral-distance")
+            options->_maxSpectralDistance = value.getFloatValue();
+        else
+        {
+            fprintf(stderr, "Error: unknown option %s\n", arg.toRawUTF8());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Mixed to mono
+static bool
+readFile(const juce::File &file, vector<float> *samples, double *sampleRate,
+         juce::String *error)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr)
+    {
+        *error = "can't read " + file.getFullPathName();
+        return false;
+    }
+
+    int numSamples = (int)reader->lengthInSamples;
+    juce::AudioBuffer<float> buffer((int)reader->numChannels, numSamples);
+    reader->read(&buffer, 0, numSamples, 0, true, true);
+
+    samples->assign(numSamples, 0.0);
+    for (int c = 0; c < buffer.getNumChannels(); c++)
+        juce::FloatVectorOperations::addWithMultiply(samples->data(), buffer.getReadPointer(c),
+                                                     1.0f/buffer.getNumChannels(), numSamples);
+    
+    *sampleRate = reader->sampleRate;
+    
+    return true;
+}
+
+// 32 bits float, so that the samples are exactly the same when read back
+static bool
+writeFile(const juce::File &file, const vector<float> &samples, double sampleRate,
+          juce::String *error)
+{
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+    
+    std::unique_ptr<juce::FileOutputStream> outStream(file.createOutputStream());
+    if (outStream == nullptr)
+    {
+        *error = "can't create " + file.getFullPathName();
+        return false;
+    }
+
+    juce::WavAudioFormat format;
+    std::unique_ptr<juce::AudioFormatWriter> writer(format.createWriterFor(outStream.get(), sampleRate,
+                                                                           1, 32, {}, 0));
+    if (writer == nullptr)
+    {
+        *error = "can't write " + file.getFullPathName();
+        return false;
+    }
+
+    // Now owned by the writer
+    outStream.release();
+
+    const float *channels[1] = { samples.data() };
+    if (!writer->writeFromFloatArrays(channels, 1, (int)samples.size()))
+    {
+        *error = "can't write " + file.getFullPathName();
+        return false;
+    }
+    
+    return true;
+}
+
+static void
+createSyntheticInputs(const juce::File &inputDir)
+{
+    juce::StringArray names;
+    BenchSignals::getSyntheticNames(&names);
+
+    for (int i = 0; i < names.size(); i++)
+    {
+        vector<float> signal;
+        BenchSignals::generate(names[i], SYNTHETIC_SAMPLE_RATE,
+                               (int)(SYNTHETIC_DURATION*SYNTHETIC_SAMPLE_RATE), &signal);
+
+        juce::String error;
+        if (!writeFile(inputDir.getChildFile(names[i] + ".wav"), signal,
+                       SYNTHETIC_SAMPLE_RATE, &error))
+            fprintf(stderr, "Error: %s\n", error.toRawUTF8());
+    }
+}
+
+static juce::File
+getReferenceFile(const GoldenOptions &options, const juce::File &inputFile,
+                 const GoldenCase *goldenCase)
+{
+    return options._dir.getChildFile("references")
+        .getChildFile(inputFile.getFileNameWithoutExtension())
+        .getChildFile(goldenCase->getName().replaceCharacter('/', '-') + ".wav");
+}
+
+int
+main(int argc, char *argv[])
+{
+    GoldenOptions options;
+    if (!parseArguments(argc, argv, &options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (!FftEngine::isBackendAvailable(options._fftBackend))
+    {
+        fprintf(stderr, "Error: fft backend %s not available\n",
+                FftEngine::getBackendName(options._fftBackend));
+        return 1;
+    }
+    FftEngine::setDefaultBackend(options._fftBackend);
+    
+    juce::File inputDir = options._dir.getChildFile("inputs");
+    
+    juce::Array<juce::File> inputFiles = inputDir.findChildFiles(juce::File::findFiles, false,
+                                                                 INPUT_WILDCARD);
+    if (inputFiles.isEmpty() && options._generate)
+    {
+        inputDir.createDirectory();
+        createSyntheticInputs(inputDir);
+        
+        inputFiles = inputDir.findChildFiles(juce::File::findFiles, false,
+                                             INPUT_WILDCARD);
+    }
+    
+    if (inputFiles.isEmpty())
+    {
+        fprintf(stderr, "Error: no input file in %s\n", inputDir.getFullPathName().toRawUTF8());
+        return 1;
+    }
+    inputFiles.sort();
+
+    vector<std::unique_ptr<GoldenCase> > cases;
+    {
+        vector<GoldenCase *> allCases;
+        GoldenCase::createAll(&allCases);
+        
+        for (int i = 0; i < allCases.size(); i++)
+        {
+            if (allCases[i]->getName().contains(options._filter))
+                cases.push_back(std::unique_ptr<GoldenCase>(allCases[i]));
+            else
+                delete allCases[i];
+        }
+    }
+
+    int numFailed = 0;
+    for (int i = 0; i < inputFiles.size(); i++)
+    {
+        vector<float> input;
+        double sampleRate;
+        juce::String error;
+        if (!readFile(inputFiles[i], &input, &sampleRate, &error))
+        {
+            fprintf(stderr, "Error: %s\n", error.toRawUTF8());
+            numFailed++;
+            continue;
+        }
+
+        for (int j = 0; j < cases.size(); j++)
+        {
+            GoldenCase *goldenCase = cases[j].get();
+            juce::File referenceFile = getReferenceFile(options, inputFiles[i], goldenCase);
+            
+            vector<float> output;
+            goldenCase->render(input, sampleRate, &output);
+
+            juce::String caseName = inputFiles[i].getFileNameWithoutExtension() +
+                " " + goldenCase->getName();
+
+            juce::String message;
+            if (!goldenCase->checkProperties(input, sampleRate, output, &message))
+            {
+                printf("%-40s FAIL (%s)\n", caseName.toRawUTF8(), message.toRawUTF8());
+                numFailed++;
+                continue;
+            }
+            
+            if (options._generate)
+            {
+                if (!writeFile(referenceFile, output, sampleRate, &error))
+                {
+                    fprintf(stderr, "Error: %s\n", error.toRawUTF8());
+                    numFailed++;
+                    continue;
+                }
+                
+                printf("%-40s written\n", caseName.toRawUTF8());
+                continue;
+            }
+
+            vector<float> reference;
+            double referenceSampleRate;
+            if (!referenceFile.existsAsFile() ||
+                !readFile(referenceFile, &reference, &referenceSampleRate, &error))
+            {
+                printf("%-40s FAIL (no reference)\n", caseName.toRawUTF8());
+                numFailed++;
+                continue;
+            }
+
+            if (output.size() != reference.size())
+            {
+                printf("%-40s FAIL (length %d, reference %d)\n", caseName.toRawUTF8(),
+                       (int)output.size(), (int)reference.size());
+                numFailed++;
+                continue;
+            }
+            
+            GoldenMetrics metrics;
+            GoldenMetrics::compute(output, reference, goldenCase->getFrameSize(sampleRate),
+                                   &metrics);
+
+            bool passed = ((metrics._maxAbs <= options._maxAbs) &&
+                           (metrics._snr >= options._minSnr) &&
+                           (metrics._spectralDistance <= options._maxSpectralDistance));
+            if (!passed)
+                numFailed++;
+            
+            printf("%-40s %s  max abs %.3g  snr %.1f dB  spectral distance %.3f dB\n",
+                   caseName.toRawUTF8(), passed ? "PASS" : "FAIL",
+                   metrics._maxAbs, metrics._snr, metrics._spectralDistance);
+        }
+
+        fflush(stdout);
+    }
+
+    if (numFailed > 0)
+    {
+        printf("\n%d failure(s)\n", numFailed);
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,266 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <stdio.h>
+
+#include <vector>
+using namespace std;
+
+#include <JuceHeader.h>
+
+#include "RenderSettings.h"
+#include "RenderJob.h"
+
+#define DEFAULT_BLOCK_SIZE 8192
+#define MAX_BLOCK_SIZE 1048576
+
+static void
+printUsage()
+{
+    printf("Usage: BL_Render <denoiser|air> [options] <input files...>\n"
+           "\n"
+           "Render audio files (wav, flac, aiff...) with the plugin processing.\n"
+           "\n"
+           "Options:\n"
+           "  --state <file>          Plugin state or base64 noise profile\n"
+           "                          (the parameters below override it)\n"
+           "  --output-dir <dir>      Default: next to the input files\n"
+           "  --suffix <text>         Added to the output file names\n"
+           "  --format <wav|flac|...> Default: same as the input\n"
+           "  --jobs <n>              Files rendered in parallel (default: number of cpus)\n"
+           "  --block-size <n>        Samples processed at once (default: %d)\n"
+           "  --resolution <n>        0 (auto), 512, 1024, 2048, 4096 or 8192\n"
+           "\n"
+           "Denoiser options:\n"
+           "  --ratio <0-100> --threshold <0-100> --transient-boost <0-100>\n"
+           "  --residual-noise <0-100> --quality <1-4> --soft-denoise --noise-only\n"
+           "\n"
+           "Air options:\n"
+           "  --threshold <-120-0> --mix <-100-100> --out-gain <dB> --smart-resynth\n"
+           "  --wet-freq <Hz> --wet-gain <dB>\n",
+           DEFAULT_BLOCK_SIZE);
+}
+
+static int
+getResolution(int fftSize)
+{
+    // 0 is auto
+    int resolution = 0;
+    for (int size = 512; size <= fftSize; size *= 2)
+        resolution++;
+
+    return resolution;
+}
+
+static bool
+parseArguments(int argc, char *argv[], RenderSettings *settings,
+               juce::Array<juce::File> *inputFiles)
+{
+    if (argc < 2)
+        return false;
+
+    juce::String engine(argv[1]);
+    if (engine == "denoiser")
+        settings->_engine = RenderSettings::ENGINE_DENOISER;
+    else if (engine == "air")
+        settings->_engine = RenderSettings::ENGINE_AIR;
+    else
+        return false;
+
+    settings->_blockSize = DEFAULT_BLOCK_SIZE;
+    settings->_numJobs = juce::SystemStats::getNumCpus();
+    settings->_outputSuffix = (settings->_engine == RenderSettings::ENGINE_DENOISER) ?
+        "-denoised" : "-air";
+    
+    // The state is loaded first, the other options override it
+    for (int i = 2; i < argc - 1; i++)
+    {
+        if (juce::String(argv[i]) != "--state")
+            continue;
+
+        juce::String error;
+        if (!settings->loadState(juce::File::getCurrentWorkingDirectory().getChildFile(argv[i + 1]),
+                                 &error))
+        {
+            fprintf(stderr, "Error: %s\n", error.toRawUTF8());
+            return false;
+        }
+    }
+
+    bool isDenoiser = (settings->_engine == RenderSettings::ENGINE_DENOISER);
+    
+    for (int i = 2; i < argc; i++)
+    {
+        juce::String arg(argv[i]);
+        
+        if (!arg.startsWith("--"))
+        {
+            inputFiles->add(juce::File::getCurrentWorkingDirectory().getChildFile(arg));
+            continue;
+        }
+
+        // Options without value
+        if (arg == "--soft-denoise")
+        {
+            settings->_softDenoise = true;
+            continue;
+        }
+        
+        if (arg == "--noise-only")
+        {
+            settings->_noiseOnly = true;
+            continue;
+        }
+
+        if (arg == "--smart-resynth")
+        {
+            settings->_smartResynth = true;
+            continue;
+        }
+
+        if (i == argc - 1)
+        {
+            fprintf(stderr, "Error: missing value for %s\n", arg.toRawUTF8());
+            return false;
+        }
+        
+        juce::String value(argv[++i]);
+        
+        if (arg == "--state")
+            ; // Already loaded
+        else if (arg == "--output-dir")
+            settings->_outputDir = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+        else if (arg == "--suffix")
+            settings->_outputSuffix = value;
+        else if (arg == "--format")
+            settings->_outputFormat = "." + value.trimCharactersAtStart(".");
+        else if (arg == "--jobs")
+            settings->_numJobs = juce::jmax(1, value.getIntValue());
+        else if (arg == "--block-size")
+            settings->_blockSize = juce::jlimit(1, MAX_BLOCK_SIZE, value.getIntValue());
+        else if (arg == "--resolution")
+            settings->_resolution = getResolution(value.getIntValue());
+        else if (arg == "--threshold")
+        {
+            if (isDenoiser)
+                settings->_threshold = value.getFloatValue();
+            else
+                settings->_airThreshold = value.getFloatValue();
+        }
+        else if (isDenoiser && (arg == "--ratio"))
+            settings->_ratio = value.getFloatValue();
+        else if (isDenoiser && (arg == "--transient-boost"))
+            settings->_transientBoost = value.getFloatValue();
+        else if (isDenoiser && (arg == "--residual-noise"))
+            settings->_residualNoise = value.getFloatValue();
+        else if (isDenoiser && (arg == "--quality"))
+            settings->_quality = juce::jlimit(1, 4, value.getIntValue()) - 1;
+        else if (!isDenoiser && (arg == "--mix"))
+            settings->_harmoAirMix = value.getFloatValue();
+        else if (!isDenoiser && (arg == "--out-gain"))
+            settings->_outGain = value.getFloatValue();
+        else if (!isDenoiser && (arg == "--wet-freq"))
+            settings->_wetFreq = value.getFloatValue();
+        else if (!isDenoiser && (arg == "--wet-gain"))
+            settings->_wetGain = value.getFloatValue();
+        else
+        {
+            fprintf(stderr, "Error: unknown option %s\n", arg.toRawUTF8());
+            return false;
+        }
+    }
+
+    return !inputFiles->isEmpty();
+}
+
+static juce::File
+getOutputFile(const RenderSettings &settings, const juce::File &inputFile)
+{
+    juce::File dir = (settings._outputDir != juce::File()) ?
+        settings._outputDir : inputFile.getParentDirectory();
+
+    juce::String extension = settings._outputFormat.isNotEmpty() ?
+        settings._outputFormat : inputFile.getFileExtension();
+    
+    return dir.getChildFile(inputFile.getFileNameWithoutExtension() +
+                            settings._outputSuffix + extension);
+}
+
+int
+main(int argc, char *argv[])
+{
+    RenderSettings settings;
+    juce::Array<juce::File> inputFiles;
+    if (!parseArguments(argc, argv, &settings, &inputFiles))
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (settings._outputDir != juce::File())
+        settings._outputDir.createDirectory();
+
+    if ((settings._engine == RenderSettings::ENGINE_DENOISER) &&
+        settings._noiseProfiles.empty())
+        fprintf(stderr, "Warning: no noise profile, use --state\n");
+    
+    // The jobs only read the settings
+    vector<std::unique_ptr<RenderJob> > jobs;
+    for (int i = 0; i < inputFiles.size(); i++)
+        jobs.push_back(std::make_unique<RenderJob>(settings, inputFiles[i],
+                                                   getOutputFile(settings, inputFiles[i])));
+
+    juce::ThreadPool pool(juce::jmin(settings._numJobs, (int)jobs.size()));
+    for (int i = 0; i < jobs.size(); i++)
+        pool.addJob(jobs[i].get(), false);
+
+    // Report the files as they are finished
+    int numFailed = 0;
+    vector<bool> reported(jobs.size(), false);
+    int numReported = 0;
+    while (numReported < jobs.size())
+    {
+        juce::Thread::sleep(50);
+        
+        for (int i = 0; i < jobs.size(); i++)
+        {
+            if (reported[i] || pool.contains(jobs[i].get()))
+                continue;
+            
+            RenderJob *job = jobs[i].get();
+            if (job->hasSucceeded())
+                printf("%s -> %s (%.1fx real time)\n",
+                       job->getInputFile().getFullPathName().toRawUTF8(),
+                       job->getOutputFile().getFullPathName().toRawUTF8(),
+                       job->getRealtimeFactor());
+            else
+            {
+                fprintf(stderr, "%s: %s\n",
+                        job->getInputFile().getFullPathName().toRawUTF8(),
+                        job->getError().toRawUTF8());
+                numFailed++;
+            }
+            fflush(stdout);
+            
+            reported[i] = true;
+            numReported++;
+        }
+    }
+    
+    return (numFailed > 0) ? 1 : 0;
+}
@@ -0,0 +1,249 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <OverlapAdd.h>
+#include <DenoiserProcessor.h>
+#include <TransientShaperProcessor.h>
+#include <AirProcessor.h>
+#include <CrossoverSplitterNBands.h>
+#include <Delay.h>
+#include <Utils.h>
+
+#include "RenderEngine.h"
+
+// Same values as in the plugins
+#define FFT_SIZE_COEFF 23
+
+#define MIN_FFT_SIZE 512
+#define MAX_FFT_SIZE 8192
+
+#define DENOISER_OVERLAP_0 4
+#define DENOISER_OVERLAP_1 8
+#define DENOISER_OVERLAP_2 16
+#define DENOISER_OVERLAP_3 32
+
+#define TRANSIENT_FREQ_AMP_RATIO 0.5
+
+#define AIR_OVERLAP 4
+
+#define AIR_MIN_SPLIT_FREQ 20.0
+
+// RenderEngine
+RenderEngine *
+RenderEngine::create(const RenderSettings &settings, int numChannels, double sampleRate)
+{
+    if (settings._engine == RenderSettings::ENGINE_AIR)
+        return new AirRenderEngine(settings, numChannels, sampleRate);
+
+    return new DenoiserRenderEngine(settings, numChannels, sampleRate);
+}
+
+RenderEngine::~RenderEngine() {}
+
+int
+RenderEngine::getFftSize(int resolution, double sampleRate)
+{
+    if (resolution == 0)
+        // Auto
+        return Utils::nearestPowerOfTwo(sampleRate/FFT_SIZE_COEFF);
+    
+    int fftSize = MIN_FFT_SIZE << (resolution - 1);
+    if (fftSize > MAX_FFT_SIZE)
+        fftSize = MAX_FFT_SIZE;
+
+    return fftSize;
+}
+
+// DenoiserRenderEngine
+DenoiserRenderEngine::DenoiserRenderEngine(const RenderSettings &settings,
+                                           int numChannels, double sampleRate)
+{
+    int fftSize = getFftSize(settings._resolution, sampleRate);
+
+    static const int overlaps[4] = { DENOISER_OVERLAP_0, DENOISER_OVERLAP_1,
+                                     DENOISER_OVERLAP_2, DENOISER_OVERLAP_3 };
+    int overlap = overlaps[juce::jlimit(0, 3, settings._quality)];
+    
+    float threshold = settings._threshold*0.01;
+    
+    _overlapAdd = new MultiChannelOverlapAdd(numChannels, fftSize, overlap, true, true);
+    
+    for (int i = 0; i < numChannels; i++)
+    {
+        DenoiserProcessor *processor = new DenoiserProcessor(fftSize, overlap, threshold);
+        processor->reset(fftSize, overlap, sampleRate);
+        
+        processor->setThreshold(threshold);
+        processor->setResNoiseThrs(settings._residualNoise*0.01);
+        processor->setBuildingNoiseStatistics(false);
+        processor->setAutoResNoise(settings._softDenoise);
+        processor->setRatio(settings._ratio*0.01);
+        processor->setNoiseOnly(settings._noiseOnly);
+
+        // Resampled to the fft size and the sample rate of the file
+        // If the profile has less channels, use the last one
+        if (!settings._noiseProfiles.empty())
+        {
+            int profileIndex = juce::jmin(i, (int)settings._noiseProfiles.size() - 1);
+            processor->setNativeNoiseCurve(settings._noiseProfiles[profileIndex],
+                                           settings._noiseProfileSampleRate);
+        }
+        
+        _processors.push_back(processor);
+
+        TransientShaperProcessor *transientProcessor = new TransientShaperProcessor(sampleRate);
+        transientProcessor->setFreqAmpRatio(TRANSIENT_FREQ_AMP_RATIO);
+        transientProcessor->setSoftHard(settings._transientBoost*0.01);
+        _transientProcessors.push_back(transientProcessor);
+            
+        _overlapAdd->addChannelProcessor(i, processor);
+        _overlapAdd->addChannelProcessor(i, transientProcessor);
+    }
+}
+
+DenoiserRenderEngine::~DenoiserRenderEngine()
+{
+    delete _overlapAdd;
+    
+    for (int i = 0; i < _processors.size(); i++)
+        delete _processors[i];
+
+    for (int i = 0; i < _transientProcessors.size(); i++)
+        delete _transientProcessors[i];
+}
+
+int
+DenoiserRenderEngine::getLatency()
+{
+    return _overlapAdd->getLatency() + _processors[0]->getLatency();
+}
+
+void
+DenoiserRenderEngine::process(float * const *buffers, int numSamples)
+{
+    _overlapAdd->process(buffers, buffers, numSamples);
+}
+
+// AirRenderEngine
+AirRenderEngine::AirRenderEngine(const RenderSettings &settings,
+                                 int numChannels, double sampleRate)
+{
+    int fftSize = getFftSize(settings._resolution, sampleRate);
+    
+    _overlapAdd = new MultiChannelOverlapAdd(numChannels, fftSize, AIR_OVERLAP, true, true);
+        
+    for (int i = 0; i < numChannels; i++)
+    {
+        AirProcessor *processor = new AirProcessor(fftSize, AIR_OVERLAP, sampleRate);
+        processor->setThreshold(settings._airThreshold);
+        processor->setMix(-settings._harmoAirMix*0.01);
+        processor->setUseSoftMasks(settings._smartResynth);
+        
+        // For freq splitter
+        processor->setEnableSum(false);
+
+        _processors.push_back(processor);
+
+        _overlapAdd->addChannelProcessor(i, processor);
+    }
+
+    _splitEnabled = (settings._wetFreq >= AIR_MIN_SPLIT_FREQ);
+
+    float splitFreqs[1] = { settings._wetFreq };
+    for (int i = 0; i < numChannels; i++)
+    {
+        _bandSplittersIn.push_back(new CrossoverSplitterNBands(2, splitFreqs, sampleRate));
+        _bandSplittersOut.push_back(new CrossoverSplitterNBands(2, splitFreqs, sampleRate));
+
+        // Delay the dry low band by the latency of the wet signal
+        Delay *delay = new Delay(fftSize);
+        delay->setDelay(getLatency());
+        _inputDelays.push_back(delay);
+    }
+
+    _lowBufs.resize(numChannels);
+    
+    _wetGain = Utils::DBToAmp(settings._wetGain);
+    _outGain = Utils::DBToAmp(settings._outGain);
+}
+
+AirRenderEngine::~AirRenderEngine()
+{
+    delete _overlapAdd;
+
+    for (int i = 0; i < _processors.size(); i++)
+        delete _processors[i];
+
+    for (int i = 0; i < _bandSplittersIn.size(); i++)
+        delete _bandSplittersIn[i];
+
+    for (int i = 0; i < _bandSplittersOut.size(); i++)
+        delete _bandSplittersOut[i];
+
+    for (int i = 0; i < _inputDelays.size(); i++)
+        delete _inputDelays[i];
+}
+
+int
+AirRenderEngine::getLatency()
+{
+    return _overlapAdd->getLatency() + _processors[0]->getLatency();
+}
+
+void
+AirRenderEngine::process(float * const *buffers, int numSamples)
+{
+    int numChannels = _processors.size();
+
+    // Keep the dry low band, delayed by the latency of the wet signal
+    if (_splitEnabled)
+    {
+        for (int i = 0; i < numChannels; i++)
+        {
+            _tmpBuf.resize(numSamples);
+            memcpy(_tmpBuf.data(), buffers[i], numSamples*sizeof(float));
+
+            _bandSplittersIn[i]->split(_tmpBuf, _splitBufs);
+
+            _lowBufs[i] = _splitBufs[0];
+            _inputDelays[i]->processSamples(&_lowBufs[i]);
+        }
+    }
+    
+    // Wet, in place
+    _overlapAdd->process(buffers, buffers, numSamples);
+
+    // Dry low band, and wet high band
+    if (_splitEnabled)
+    {
+        for (int i = 0; i < numChannels; i++)
+        {
+            memcpy(_tmpBuf.data(), buffers[i], numSamples*sizeof(float));
+            
+            _bandSplittersOut[i]->split(_tmpBuf, _splitBufs);
+
+            vector<float> &highBuf = _splitBufs[1];
+            for (int j = 0; j < numSamples; j++)
+                buffers[i][j] = _lowBufs[i][j] + highBuf[j]*_wetGain;
+        }
+    }
+
+    // Apply out gain
+    for (int i = 0; i < numChannels; i++)
+        juce::FloatVectorOperations::multiply(buffers[i], _outGain, numSamples);
+}
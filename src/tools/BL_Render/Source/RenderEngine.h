@@ -0,0 +1,103 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+#include <JuceHeader.h>
+
+#include "RenderSettings.h"
+
+class MultiChannelOverlapAdd;
+class DenoiserProcessor;
+class TransientShaperProcessor;
+class AirProcessor;
+class CrossoverSplitterNBands;
+class Delay;
+
+// The processing of a plugin, without the host
+// Same processors and parameters as the plugin, but the parameters
+// are fixed for the whole file
+class RenderEngine
+{
+public:
+    static RenderEngine *create(const RenderSettings &settings,
+                                int numChannels, double sampleRate);
+    
+    virtual ~RenderEngine();
+
+    // Delay of the output, compensated by the render job
+    virtual int getLatency() = 0;
+
+    // In place
+    virtual void process(float * const *buffers, int numSamples) = 0;
+
+    // Same as in the plugins
+    static int getFftSize(int resolution, double sampleRate);
+};
+
+class DenoiserRenderEngine : public RenderEngine
+{
+public:
+    DenoiserRenderEngine(const RenderSettings &settings,
+                         int numChannels, double sampleRate);
+    ~DenoiserRenderEngine() override;
+
+    int getLatency() override;
+
+    void process(float * const *buffers, int numSamples) override;
+    
+protected:
+    MultiChannelOverlapAdd *_overlapAdd = nullptr;
+    vector<DenoiserProcessor *> _processors;
+    vector<TransientShaperProcessor *> _transientProcessors;
+};
+
+class AirRenderEngine : public RenderEngine
+{
+public:
+    AirRenderEngine(const RenderSettings &settings,
+                    int numChannels, double sampleRate);
+    ~AirRenderEngine() override;
+
+    int getLatency() override;
+
+    void process(float * const *buffers, int numSamples) override;
+    
+protected:
+    MultiChannelOverlapAdd *_overlapAdd = nullptr;
+    vector<AirProcessor *> _processors;
+
+    // The low band is not processed, if the wet freq is set
+    bool _splitEnabled = false;
+    vector<CrossoverSplitterNBands *> _bandSplittersIn;
+    vector<CrossoverSplitterNBands *> _bandSplittersOut;
+    vector<Delay *> _inputDelays;
+
+    float _wetGain = 1.0;
+    float _outGain = 1.0;
+
+    // Delayed dry low band, for each channel
+    vector<vector<float> > _lowBufs;
+
+    // Scratch buffers, for the splitter
+    vector<float> _tmpBuf;
+    vector<float> _splitBufs[2];
+};
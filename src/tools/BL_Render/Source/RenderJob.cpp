@@ -0,0 +1,175 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "RenderEngine.h"
+#include "RenderJob.h"
+
+RenderJob::RenderJob(const RenderSettings &settings,
+                     const juce::File &inputFile, const juce::File &outputFile)
+: juce::ThreadPoolJob(inputFile.getFileName()), _settings(settings),
+  _inputFile(inputFile), _outputFile(outputFile) {}
+
+RenderJob::~RenderJob() {}
+
+juce::ThreadPoolJob::JobStatus
+RenderJob::runJob()
+{
+    _succeeded = render();
+    
+    return jobHasFinished;
+}
+
+const juce::File &
+RenderJob::getInputFile() const
+{
+    return _inputFile;
+}
+
+const juce::File &
+RenderJob::getOutputFile() const
+{
+    return _outputFile;
+}
+
+bool
+RenderJob::hasSucceeded() const
+{
+    return _succeeded;
+}
+
+const juce::String &
+RenderJob::getError() const
+{
+    return _error;
+}
+
+double
+RenderJob::getRealtimeFactor() const
+{
+    return _realtimeFactor;
+}
+
+bool
+RenderJob::render()
+{
+    double startTime = juce::Time::getMillisecondCounterHiRes();
+    
+    // One manager for each job, the readers are not shared
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(_inputFile));
+    if (reader == nullptr)
+    {
+        _error = "unsupported or unreadable file";
+        return false;
+    }
+
+    int numChannels = reader->numChannels;
+    double sampleRate = reader->sampleRate;
+    juce::int64 length = reader->lengthInSamples;
+    
+    juce::AudioFormat *format = formatManager.findFormatForFileExtension(_outputFile.getFileExtension());
+    if (format == nullptr)
+    {
+        _error = "unsupported output format " + _outputFile.getFileExtension();
+        return false;
+    }
+
+    // Keep the bit depth if possible (e.g 32 bits float is not possible in flac)
+    int bitsPerSample = reader->bitsPerSample;
+    juce::Array<int> bitDepths = format->getPossibleBitDepths();
+    if (!bitDepths.contains(bitsPerSample))
+        bitsPerSample = bitDepths.getLast();
+    
+    _outputFile.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> outStream(_outputFile.createOutputStream());
+    if (outStream == nullptr)
+    {
+        _error = "can't create " + _outputFile.getFullPathName();
+        return false;
+    }
+    
+    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(outStream.get(), sampleRate,
+                                                                            numChannels, bitsPerSample,
+                                                                            reader->metadataValues, 0));
+    if (writer == nullptr)
+    {
+        _error = "can't write " + _outputFile.getFullPathName();
+        return false;
+    }
+
+    // Now owned by the writer
+    outStream.release();
+    
+    std::unique_ptr<RenderEngine> engine(RenderEngine::create(_settings, numChannels, sampleRate));
+    
+    // A multiple of the fft size, so that each block produces output
+    // (otherwise the overlap-add underruns, and the latency is not constant)
+    int fftSize = RenderEngine::getFftSize(_settings._resolution, sampleRate);
+    int blockSize = ((juce::jmax(_settings._blockSize, fftSize) + fftSize - 1)/fftSize)*fftSize;
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+
+    // The output starts after the latency, and the end of the file
+    // is flushed with zeros
+    int numToSkip = engine->getLatency();
+
+    juce::int64 readPos = 0;
+    juce::int64 numWritten = 0;
+    while (numWritten < length)
+    {
+        if (shouldExit())
+        {
+            _error = "cancelled";
+            return false;
+        }
+        
+        int numToRead = (int)juce::jmin((juce::int64)blockSize, length - readPos);
+        if (numToRead > 0)
+        {
+            reader->read(&buffer, 0, numToRead, readPos, true, true);
+            readPos += numToRead;
+        }
+        
+        if (numToRead < blockSize)
+            buffer.clear(numToRead, blockSize - numToRead);
+
+        engine->process(buffer.getArrayOfWritePointers(), blockSize);
+
+        int startSample = juce::jmin(numToSkip, blockSize);
+        numToSkip -= startSample;
+        
+        int numToWrite = (int)juce::jmin((juce::int64)(blockSize - startSample), length - numWritten);
+        if (numToWrite > 0)
+        {
+            if (!writer->writeFromAudioSampleBuffer(buffer, startSample, numToWrite))
+            {
+                _error = "can't write " + _outputFile.getFullPathName();
+                return false;
+            }
+            
+            numWritten += numToWrite;
+        }
+    }
+
+    double renderTime = (juce::Time::getMillisecondCounterHiRes() - startTime)*0.001;
+    if (renderTime > 0.0)
+        _realtimeFactor = (length/sampleRate)/renderTime;
+    
+    return true;
+}
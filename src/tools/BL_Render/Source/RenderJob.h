@@ -0,0 +1,58 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "RenderSettings.h"
+
+// Render one file, on a thread of the pool
+// The file is streamed block by block, so the memory used does not depend
+// on its length. The latency is compensated: the output is aligned with
+// the input, and has the same length.
+class RenderJob : public juce::ThreadPoolJob
+{
+public:
+    RenderJob(const RenderSettings &settings,
+              const juce::File &inputFile, const juce::File &outputFile);
+    ~RenderJob() override;
+
+    JobStatus runJob() override;
+
+    const juce::File &getInputFile() const;
+    const juce::File &getOutputFile() const;
+    
+    bool hasSucceeded() const;
+    const juce::String &getError() const;
+
+    // Duration of the file divided by the render time
+    double getRealtimeFactor() const;
+    
+protected:
+    bool render();
+    
+    const RenderSettings &_settings;
+
+    juce::File _inputFile;
+    juce::File _outputFile;
+
+    bool _succeeded = false;
+    juce::String _error;
+    double _realtimeFactor = 0.0;
+};
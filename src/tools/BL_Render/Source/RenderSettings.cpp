@@ -0,0 +1,108 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <NoiseProfile.h>
+#include <NoiseProfileBank.h>
+
+#include "RenderSettings.h"
+
+bool
+RenderSettings::loadState(const juce::File &file, juce::String *error)
+{
+    juce::MemoryBlock data;
+    if (!file.loadFileAsData(data))
+    {
+        *error = "can't read " + file.getFullPathName();
+        return false;
+    }
+
+    juce::MemoryInputStream stream(data, false);
+    juce::ValueTree state = juce::ValueTree::readFromStream(stream);
+    if (!state.isValid())
+    {
+        // Only the noise profile
+        if (!NoiseProfile::decode(data.toString().trim(), &_noiseProfiles))
+        {
+            *error = file.getFullPathName() + " is not a plugin state or a noise profile";
+            return false;
+        }
+
+        return true;
+    }
+
+    // Selected noise profile
+    int noiseProfile = 0;
+    
+    // Parameters, as saved by AudioProcessorValueTreeState
+    for (int i = 0; i < state.getNumChildren(); i++)
+    {
+        juce::ValueTree param = state.getChild(i);
+        
+        juce::String id = param["id"].toString();
+        float value = param["value"];
+
+        if (_engine == ENGINE_DENOISER)
+        {
+            if (id == "ratio")
+                _ratio = value;
+            else if (id == "threshold")
+                _threshold = value;
+            else if (id == "transientBoost")
+                _transientBoost = value;
+            else if (id == "residualNoise")
+                _residualNoise = value;
+            else if (id == "softDenoiseParamID")
+                _softDenoise = (value > 0.5);
+            else if (id == "noiseOnlyParamID")
+                _noiseOnly = (value > 0.5);
+            else if (id == "quality")
+                _quality = (int)value;
+            else if (id == "resolution")
+                _resolution = (int)value;
+            else if (id == "noiseProfile")
+                noiseProfile = juce::jmax(0, (int)value);
+        }
+        else
+        {
+            if (id == "threshold")
+                _airThreshold = value;
+            else if (id == "harmoAirMix")
+                _harmoAirMix = value;
+            else if (id == "outGain")
+                _outGain = value;
+            else if (id == "smartResynth")
+                _smartResynth = (value > 0.5);
+            else if (id == "wetFreq")
+                _wetFreq = value;
+            else if (id == "wetGain")
+                _wetGain = value;
+            else if (id == "resolution")
+                _resolution = (int)value;
+        }
+    }
+
+    // Also reads the single profile of the older states
+    NoiseProfileBank noiseProfiles(noiseProfile + 1);
+    if (noiseProfiles.readFromState(state))
+    {
+        _noiseProfiles = *noiseProfiles.getCurves(noiseProfile);
+        _noiseProfileSampleRate = noiseProfiles.getSampleRate(noiseProfile);
+    }
+    
+    return true;
+}
@@ -0,0 +1,77 @@
+/* Copyright (C) 2025 Nicolas Dittlo <bluelab.plugins@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this software; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+#include <JuceHeader.h>
+
+// Parameters of a render, with the same units as the plugin parameters
+struct RenderSettings
+{
+    enum Engine
+    {
+        ENGINE_DENOISER = 0,
+        ENGINE_AIR
+    };
+
+    Engine _engine = ENGINE_DENOISER;
+    
+    // Denoiser
+    float _ratio = 100.0;
+    float _threshold = 50.0;
+    float _transientBoost = 0.0;
+    float _residualNoise = 0.0;
+    bool _softDenoise = false;
+    bool _noiseOnly = false;
+    int _quality = 0;
+
+    // One curve for each channel, learned by the plugin
+    vector<vector<float> > _noiseProfiles;
+    float _noiseProfileSampleRate = 0.0;
+
+    // Air
+    float _airThreshold = -100.0;
+    float _harmoAirMix = 0.0;
+    float _outGain = 0.0;
+    bool _smartResynth = false;
+    float _wetFreq = 20.0;
+    float _wetGain = 0.0;
+
+    // 0 is auto, then 512 to 8192
+    int _resolution = 0;
+
+    // Samples read and processed at once, for each channel
+    // (the memory used does not depend on the file length)
+    int _blockSize = 8192;
+
+    // Number of files rendered in parallel
+    int _numJobs = 1;
+
+    // Empty: next to the input files
+    juce::File _outputDir;
+    juce::String _outputSuffix;
+    // Extension, e.g ".flac". Empty: same as the input
+    juce::String _outputFormat;
+
+    // Load the parameters and the noise profile saved by the plugin
+    // The file can be the whole plugin state, or only the base64 noise profile
+    bool loadState(const juce::File &file, juce::String *error);
+};